@@ -1,4 +1,5 @@
 QT += widgets
+CONFIG += c++11
 HEADERS = src/explorer.hpp
 SOURCES = src/explorer.cpp
 RESOURCES = explorer.qrc
@@ -18,3 +19,35 @@ macx: {
  LIBS += -lcurl -lz
 }
 
+
+# qmake CONFIG+=hdf5 reads HDF5 files that are not netCDF files with the HDF5 library, and inflates
+# the chunks of deflated netCDF-4 variables in parallel
+hdf5 {
+ DEFINES += HAVE_HDF5
+ LIBS += -lz
+ unix:!macx {
+  INCLUDEPATH += /usr/include/hdf5/serial
+  LIBS += -lhdf5_serial
+ }
+}
+
+# qmake CONFIG+=sqlite browses the tables of SQLite databases
+sqlite {
+ DEFINES += HAVE_SQLITE
+ LIBS += -lsqlite3
+}
+
+# qmake CONFIG+=zarr reads Zarr (version 2) directory stores (zlib/gzip chunks);
+# add zstd and/or blosc to CONFIG for chunks compressed with those codecs
+zarr {
+ DEFINES += HAVE_ZARR
+ LIBS += -lz
+ zstd {
+  DEFINES += HAVE_ZSTD
+  LIBS += -lzstd
+ }
+ blosc {
+  DEFINES += HAVE_BLOSC
+  LIBS += -lblosc
+ }
+}
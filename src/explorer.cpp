@@ -6,11 +6,66 @@
 #include <QApplication>
 #include <QMetaType>
 #include <cassert>
+#include <cctype>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <unordered_map>
+#include <cstdint>
+#include <sstream>
+#include <condition_variable>
+#include <map>
+#include <set>
+#include <deque>
+#include <list>
+#include <memory>
+#include <iterator>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <limits>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#ifdef HAVE_HDF5
+#include "hdf5.h"
+#endif
+#ifdef HAVE_SQLITE
+#include "sqlite3.h"
+#endif
+#if defined(HAVE_ZARR) || defined(HAVE_HDF5)
+#include "zlib.h"
+#endif
+#ifdef HAVE_ZARR
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#endif
+#ifdef HAVE_BLOSC
+#include "blosc.h"
+#endif
+#endif
 #include "explorer.hpp"
 
 const char* get_format(const nc_type typ);
+int format_value(char *str, size_t len, const void *buf, const nc_type typ, size_t idx);
+bool export_hyperslab(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  int format, const QString &file_name, QWidget *parent);
+bool reduce_variable(ItemData *item_data, size_t dim, int op, double *out, QWidget *parent);
+int walk_worker(const char *file_name);
+int reader_worker();
+int read_benchmark(const QString &file_name, const QString &var_nm_fll);
+bool parse_shape(const QString &text, std::vector<size_t> &shape);
+std::vector<size_t> default_chunks(const std::vector<size_t> &count);
+bool write_subset(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &chunks, int level, bool shuffle, const std::string &file_name, std::string &error,
+  QProgressDialog *progress);
+int subset_batch(const QString &file_name, const QString &var_nm_fll, const QString &output, const QString &text_start,
+  const QString &text_count, const QString &text_chunks, int level, bool shuffle);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 //main
@@ -18,6 +73,21 @@ const char* get_format(const nc_type typ);
 
 int main(int argc, char *argv[])
 {
+  QElapsedTimer clock;
+  clock.start();
+
+  //worker process mode: walk the metadata of a file and write it to standard output
+  if(argc == 3 && strcmp(argv[1], "--walk") == 0)
+  {
+    return walk_worker(argv[2]);
+  }
+
+  //worker process mode: read hyperslabs for the reader pool
+  if(argc == 2 && strcmp(argv[1], "--reader") == 0)
+  {
+    return reader_worker();
+  }
+
   Q_INIT_RESOURCE(explorer);
   QApplication app(argc, argv);
   QCoreApplication::setApplicationVersion("1.1");
@@ -25,17 +95,59 @@ int main(int argc, char *argv[])
   QCommandLineParser parser;
   parser.addHelpOption();
   parser.addVersionOption();
-  parser.addPositionalArgument("file", "The file to open.");
+  parser.addPositionalArgument("files", "The files to open.", "[files...]");
+  QCommandLineOption option_benchmark("startup-benchmark", "Print the startup times and exit.");
+  parser.addOption(option_benchmark);
+  QCommandLineOption option_read_benchmark("read-benchmark",
+    "Time reading the slices of <variable> (full name) of the file, in process and in reader processes, and exit.",
+    "variable");
+  parser.addOption(option_read_benchmark);
+  QCommandLineOption option_subset("subset",
+    "Save a hyperslab of <variable> (full name) of the file to a new netCDF-4 file (--output) and exit.", "variable");
+  parser.addOption(option_subset);
+  QCommandLineOption option_output("output", "File written by --subset.", "file");
+  parser.addOption(option_output);
+  QCommandLineOption option_start("start", "Start of the subset, one index per dimension (default: origin).", "indices");
+  parser.addOption(option_start);
+  QCommandLineOption option_count("count", "Shape of the subset (default: to the end of each dimension).", "sizes");
+  parser.addOption(option_count);
+  QCommandLineOption option_chunks("chunks", "Chunk shape of the subset (default: one 2D slice).", "sizes");
+  parser.addOption(option_chunks);
+  QCommandLineOption option_deflate("deflate", "Deflate level of the subset, 0 for none (default: 4).", "level", "4");
+  parser.addOption(option_deflate);
+  QCommandLineOption option_no_shuffle("no-shuffle", "Do not shuffle the bytes of the subset before deflating.");
+  parser.addOption(option_no_shuffle);
   parser.process(app);
   const QStringList args = parser.positionalArguments();
 
+  if(parser.isSet(option_read_benchmark))
+  {
+    if(args.size() != 1)
+    {
+      parser.showHelp(1);
+    }
+    return read_benchmark(args.at(0), parser.value(option_read_benchmark));
+  }
+
+  if(parser.isSet(option_subset))
+  {
+    if(args.size() != 1 || !parser.isSet(option_output))
+    {
+      parser.showHelp(1);
+    }
+    return subset_batch(args.at(0), parser.value(option_subset), parser.value(option_output),
+      parser.value(option_start), parser.value(option_count), parser.value(option_chunks),
+      std::max(0, std::min(9, parser.value(option_deflate).toInt())), !parser.isSet(option_no_shuffle));
+  }
+
+  //show the window first, the file is walked while it paints
   MainWindow window;
-  if(args.size())
+  if(parser.isSet(option_benchmark))
   {
-    QString file_name = args.at(0);
-    window.read_file(file_name);
+    window.start_benchmark(&clock);
   }
   window.showMaximized();
+  window.read_files(args);
   return app.exec();
 }
 
@@ -56,6 +168,133 @@ public:
   size_t m_size;
 };
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_t
+//compressed in-memory copy of a loaded variable: the row major buffer is cut in tiles of 'tile_nbr'
+//elements, each byte shuffled (byte i of all elements together, so that the slowly varying high
+//bytes of smooth fields and the repeated bytes of fill values form long runs) and deflated;
+//hyperslabs decompress only the tiles they touch
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class tile_store_t
+{
+public:
+  enum { tile_nbr = 1 << 16 }; // elements per tile
+  tile_store_t(const void *buf, size_t nbr, size_t elem_sz);
+  ~tile_store_t();
+  void copy_hyperslab(const std::vector<ncdim_t> &ncdim, const std::vector<size_t> &start,
+    const std::vector<size_t> &count, void *dst) const;
+  size_t raw_size() const
+  {
+    return m_nbr * m_elem_sz;
+  }
+  size_t stored_size() const
+  {
+    return m_stored;
+  }
+  static size_t total_raw_size();
+  static size_t total_stored_size();
+
+private:
+  void decompress(size_t idx_tile, std::vector<char> &out, std::vector<char> &tmp) const;
+  size_t m_nbr; // elements
+  size_t m_elem_sz;
+  size_t m_stored; // bytes of all compressed tiles
+  std::vector<QByteArray> m_tiles;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t
+//least recently used chunks of a chunked variable, up to a capacity that grows with the reads
+//(resize): the inflated chunks of direct chunk reads, or only the keys of the chunks, to follow the
+//chunk cache of the library; hits and misses are counted as decompressions avoided and done. The
+//inflated chunks of all caches together stay under a process wide bound (max_total)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class chunk_cache_t
+{
+public:
+  typedef std::shared_ptr<std::vector<char> > chunk_t;
+  chunk_cache_t(const std::vector<size_t> &shape, size_t elem_sz, size_t capacity, bool counted);
+  ~chunk_cache_t();
+  bool find(size_t key, chunk_t *chunk);
+  void insert(size_t key, const chunk_t &chunk);
+  void count_miss();
+  bool resize(const std::vector<size_t> &start, const std::vector<size_t> &count, int dim_step);
+  void clear();
+  size_t key(const std::vector<size_t> &org, const std::vector<ncdim_t> &ncdim) const;
+  size_t capacity() const
+  {
+    return m_capacity;
+  }
+  size_t chunk_size() const
+  {
+    return m_chunk_sz;
+  }
+  static size_t nbr_inflated();
+  static size_t nbr_avoided();
+  static void reset_counts();
+  const std::vector<size_t> m_shape; // chunk shape
+
+private:
+  typedef std::unordered_map<size_t, std::pair<std::list<size_t>::iterator, chunk_t> > chunks_t;
+  void erase(chunks_t::iterator it);
+  std::mutex m_mutex;
+  std::list<size_t> m_order; // keys, most recently used first
+  chunks_t m_chunks;
+  size_t m_chunk_sz; // bytes of an inflated chunk
+  std::atomic<size_t> m_capacity; // bytes (changed under the mutex)
+  size_t m_bytes; // bytes of the chunks held
+  bool m_counted; // chunks are compressed, a miss is a decompression
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t
+//user-defined netCDF-4 type (compound, VLEN, enum, opaque) of a loaded variable, described when the
+//variable is read; elements stay in the buffer as the library returns them (compound members at
+//their offsets, VLEN elements pointing to data allocated by the library) and are formatted in place
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class nctype_t
+{
+public:
+  class field_t
+  {
+  public:
+    field_t() :
+      m_offset(0),
+      m_nc_type(NC_NAT),
+      m_nbr(1),
+      m_user(NULL)
+    {
+    }
+    std::string m_name;
+    size_t m_offset; // bytes from the start of the compound element
+    nc_type m_nc_type;
+    size_t m_nbr; // elements of an array member
+    nctype_t *m_user; // user-defined type of the member (NULL for atomic types)
+  };
+  nctype_t() :
+    m_class(NC_NAT),
+    m_size(0),
+    m_base(NC_NAT),
+    m_base_user(NULL)
+  {
+  }
+  ~nctype_t();
+  static nctype_t* inquire(const int grp_id, const nc_type typ);
+  void format(std::string &str, const char *elem) const;
+  void format_field(std::string &str, const char *elem, size_t idx_fld) const;
+  void release(char *buf, size_t nbr) const;
+  int m_class; // NC_COMPOUND, NC_VLEN, NC_ENUM or NC_OPAQUE
+  std::string m_name;
+  size_t m_size; // bytes of an element in memory
+  nc_type m_base; // type of the elements of a VLEN, or of the values of an enum
+  nctype_t *m_base_user; // user-defined base type of a VLEN (NULL for atomic types)
+  std::vector<field_t> m_fields; // compound members
+  std::map<long long, std::string> m_labels; // enum labels by value
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 //ncvar_t
 //a netCDF variable has a name, a netCDF type, data buffer, and an array of dimensions
@@ -69,50 +308,48 @@ public:
   ncvar_t(const char* name, nc_type nc_typ, const std::vector<ncdim_t> &ncdim) :
     m_name(name),
     m_nc_type(nc_typ),
-    m_ncdim(ncdim)
+    m_ncdim(ncdim),
+    m_monotonic(MonotonicUnknown)
   {
     m_buf = NULL;
+    m_store = NULL;
+    m_user = NULL;
   }
   ~ncvar_t()
   {
-    switch(m_nc_type)
+    delete m_store;
+    //elements of user-defined types hold data allocated by the library; NC_STRING buffers are string
+    //arenas (string_arena), released with their table of pointers
+    if(m_user != NULL && m_buf != NULL)
     {
-    case NC_STRING:
-      if(m_buf)
+      size_t nbr = 1;
+      for(size_t idx_dmn = 0; idx_dmn < m_ncdim.size(); idx_dmn++)
       {
-        char **buf_string = NULL;
-        size_t idx_buf = 0;
-        buf_string = static_cast<char**> (m_buf);
-        if(m_ncdim.size())
-        {
-          for(size_t idx_dmn = 0; idx_dmn < m_ncdim.size(); idx_dmn++)
-          {
-            for(size_t idx_sz = 0; idx_sz < m_ncdim[idx_dmn].m_size; idx_sz++)
-            {
-              free(buf_string[idx_buf]);
-              idx_buf++;
-            }
-          }
-        }
-        else
-        {
-          free(*buf_string);
-        }
-        free(static_cast<char**>(buf_string));
+        nbr *= m_ncdim[idx_dmn].m_size;
       }
-      break;
-    default:
-      free(m_buf);
+      m_user->release(static_cast<char*>(m_buf), nbr);
     }
+    delete m_user;
+    free(m_buf);
   }
   void store(void *buf)
   {
     m_buf = buf;
   }
+  enum Monotonic
+  {
+    MonotonicUnknown,
+    NotMonotonic,
+    Increasing,
+    Decreasing
+  };
   std::string m_name;
   nc_type m_nc_type;
-  void *m_buf;
+  void *m_buf; // loaded data (NC_STRING: a string arena)
+  tile_store_t *m_store; // compressed data of a loaded variable (m_buf is then NULL)
+  nctype_t *m_user; // user-defined type of a loaded variable (NULL for atomic types)
   std::vector<ncdim_t> m_ncdim;
+  int m_monotonic; // (coordinate variable) Monotonic direction, computed on first lookup
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -155,6 +392,114 @@ public:
   std::vector<size_t> m_dim_layers; // choose dimensions to be displayed by layers 
 };
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t
+//derived variable: an arithmetic expression over variables of a group, compiled to a stack bytecode;
+//evaluation reads the operands of a hyperslab only and runs each instruction over blocks of elements,
+//so that every instruction is a simple loop over arrays (vectorized by the compiler), on all cores
+//grammar: sum = product {(+|-) product}, product = unary {(*|/) unary}, unary = -unary | power,
+//power = primary [^ unary], primary = number | variable | function(sum [, sum]) | (sum)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class expr_t
+{
+public:
+  enum Op
+  {
+    PushVar,
+    PushConst,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    Neg,
+    Sqrt,
+    Abs,
+    Exp,
+    Log,
+    Log10,
+    Sin,
+    Cos,
+    Tan,
+    Min,
+    Max,
+    Atan2
+  };
+  class instr_t
+  {
+  public:
+    instr_t(int op, size_t arg) :
+      m_op(op),
+      m_arg(arg)
+    {
+    }
+    int m_op;
+    size_t m_arg; // index of the variable (PushVar) or constant (PushConst)
+  };
+  expr_t() :
+    m_depth(0)
+  {
+  }
+  bool compile(const std::string &text, ItemData *item_data_grp);
+  void difference(ItemData *item_data_a, ItemData *item_data_b);
+  int evaluate(const std::vector<size_t> &start, const std::vector<size_t> &count, double *out) const;
+  std::string m_text; // expression
+  std::string m_error; // compilation error
+  std::vector<ncdim_t> m_ncdim; // dimensions of all variables in the expression, and of the result
+  std::vector<ItemData*> m_vars; // variables in the expression (tree items)
+  std::vector<double> m_fill; // fill value of each variable (evaluates to NaN)
+  std::vector<double> m_const; // constants in the expression
+  std::vector<instr_t> m_code;
+  size_t m_depth; // maximum stack depth
+
+private:
+  bool parse_sum();
+  bool parse_product();
+  bool parse_unary();
+  bool parse_power();
+  bool parse_primary();
+  bool fail(const char *msg);
+  bool accept(char c);
+  void emit(int op, size_t arg, int push);
+  ItemData *m_item_data_grp; // group where variable names are looked up
+  size_t m_pos; // parse position
+  size_t m_sp; // stack depth at the parse position
+};
+
+#ifdef HAVE_ZARR
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_array_t
+//an array of a Zarr (version 2) directory store, from its .zarray metadata; every chunk is a file,
+//so the chunks of a hyperslab are read and decompressed on all threads at once, with no library lock
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class zarr_array_t
+{
+public:
+  zarr_array_t(const std::string &dir, const std::string &meta);
+  static nc_type dtype_nc_type(const std::string &dtype);
+  int read(const std::vector<size_t> &start, const std::vector<size_t> &count, void *buf) const;
+  std::string m_dir; // directory of the array
+  std::vector<size_t> m_chunks; // chunk shape
+  nc_type m_nc_type;
+  size_t m_elem_sz;
+  bool m_swap; // stored byte order is not the host byte order
+  bool m_fortran; // elements of a chunk in column major order
+  std::string m_compressor; // codec id, empty for raw chunks
+  char m_separator; // between the chunk indices of a chunk file name
+  bool m_has_fill; // fill_value is not null
+  double m_fill_value;
+  std::vector<char> m_fill; // fill value element (zero if none), for missing chunks
+  bool m_valid; // metadata parsed and codec supported by this build
+
+private:
+  int read_chunk(const std::vector<size_t> &idx_chunk, std::vector<char> &raw, std::vector<char> &chunk) const;
+};
+
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 //ItemData
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -170,6 +515,14 @@ public:
     Attribute
   };
 
+  enum Source
+  {
+    SourceNetCDF, // read with the netCDF library
+    SourceHDF5, // read with the HDF5 library (HDF5 files that are not netCDF files)
+    SourceSQLite, // SQLite database, tables are (rows, columns) string variables
+    SourceZarr // Zarr directory store, chunk files read directly
+  };
+
   ItemData(ItemKind kind, const std::string& file_name, const std::string& grp_nm_fll, const std::string& item_nm,
     ItemData *item_data_prn, ncvar_t *ncvar, grid_policy_t *grid_policy) :
     m_file_name(file_name),
@@ -178,27 +531,57 @@ public:
     m_kind(kind),
     m_item_data_prn(item_data_prn),
     m_ncvar(ncvar),
-    m_grid_policy(grid_policy)
+    m_grid_policy(grid_policy),
+    m_expr(NULL),
+    m_inserted(true),
+    m_source(SourceNetCDF),
+    m_rowid_first(-1),
+    m_has_fill(false),
+    m_fill_value(0),
+    m_chunked(-1),
+    m_chunk_cache(NULL),
+    m_dim_step(-1),
+    m_nbr_windows(0)
+#ifdef HAVE_ZARR
+    , m_zarr(NULL)
+#endif
   {
   }
   ~ItemData()
   {
+    //coordinate variables are not owned, they are the variables of other items
     delete m_ncvar;
-    for(size_t idx_dmn = 0; idx_dmn < m_ncvar_crd.size(); idx_dmn++)
-    {
-      delete m_ncvar_crd[idx_dmn];
-    }
     delete m_grid_policy;
+    delete m_expr;
+    delete m_chunk_cache;
+#ifdef HAVE_ZARR
+    delete m_zarr;
+#endif
   }
   std::string m_file_name;  // (Root/Variable/Group/Attribute) file name
   std::string m_grp_nm_fll; // (Group) full name of group
   std::string m_item_nm; // (Root/Variable/Group/Attribute ) item name to display on tree
   ItemKind m_kind; // (Root/Variable/Group/Attribute) type of item 
-  std::vector<std::string> m_var_nms; // (Group) list of variables if item is group (filled in file iteration)
+  std::unordered_map<std::string, ItemData*> m_vars; // (Group) variables in group by name (filled in file iteration)
+  std::unordered_map<std::string, ItemData*> m_crd_cache; // (Group) coordinate variable of a dimension name, resolved on first use (NULL if none)
   ItemData *m_item_data_prn; //  (Variable/Group) item data of the parent group (to get list of variables in group)
   ncvar_t *m_ncvar; // (Variable) netCDF variable to display
-  std::vector<ncvar_t *> m_ncvar_crd; // (Variable) optional coordinate variables for variable
+  std::vector<ncvar_t *> m_ncvar_crd; // (Variable) optional coordinate variables for variable, one per dimension (shared, not owned)
   grid_policy_t *m_grid_policy; // (Variable) current grid policy (interactive)
+  expr_t *m_expr; // (Variable) expression of a derived variable, not in the file and never loaded (NULL for file variables)
+  bool m_inserted; // (Group) false for the root group of a file while its walk is being inserted in the tree
+  int m_source; // library that reads the file
+  std::vector<std::string> m_columns; // (SQLite table) column names
+  long long m_rowid_first; // (SQLite table) first rowid, -1 if rows are not keyed by rowid (views)
+  bool m_has_fill; // (HDF5 dataset) fill value read by the walk
+  double m_fill_value; // (HDF5 dataset) _FillValue attribute, or fill value of the dataset creation properties
+  std::atomic<int> m_chunked; // (netCDF variable) read by direct chunk reads: -1 not tried yet, 0 no, 1 yes
+  chunk_cache_t *m_chunk_cache; // (netCDF variable) inflated chunks of direct chunk reads (NULL before the first)
+  std::atomic<int> m_dim_step; // (Variable) layer dimension last stepped in a window, -1 if none
+  std::atomic<int> m_nbr_windows; // (Variable) windows open on the variable
+#ifdef HAVE_ZARR
+  zarr_array_t *m_zarr; // (Zarr array) metadata and chunk reads
+#endif
 };
 
 Q_DECLARE_METATYPE(ItemData*);
@@ -215,1706 +598,11296 @@ ItemData* get_item_data(QTreeWidgetItem *item)
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::MainWindow
+//perf_t
+//process wide timing statistics for the hot path stages
+//each stage keeps a log2 histogram of durations (in microseconds); each sample is also kept
+//as a trace event (up to a limit) to be exported as Chrome trace JSON (chrome://tracing)
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-MainWindow::MainWindow()
+class perf_t
 {
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //mdi area
-  ///////////////////////////////////////////////////////////////////////////////////////
-
-  m_mdi_area = new QMdiArea;
-  setCentralWidget(m_mdi_area);
-
-  setWindowTitle(tr("Data Explorer"));
+public:
+  enum Stage
+  {
+    Open,   // nc_open and metadata iteration
+    Read,   // nc_get_var_*
+    Decode, // coordinate variables to labels
+    Format, // grid cells to strings
+    Paint,  // Qt paint
+    Layout, // child window construction and show
+    Compress, // compressed store tiles, both directions
+    NbrStages
+  };
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //status bar
-  ///////////////////////////////////////////////////////////////////////////////////////
+  enum { nbr_buckets = 32 }; // bucket i has durations in [2^i, 2^(i+1)) microseconds
+  enum { max_events = 200000 }; // trace events kept, older events are dropped at export time
 
-  statusBar()->showMessage(tr("Ready"));
+  class stat_t
+  {
+  public:
+    stat_t()
+    {
+      clear();
+    }
+    void clear()
+    {
+      m_count = 0;
+      m_total = 0;
+      m_max = 0;
+      m_last = 0;
+      for(int idx = 0; idx < nbr_buckets; idx++)
+      {
+        m_bucket[idx] = 0;
+      }
+    }
+    unsigned long long m_count; // number of samples
+    long long m_total; // total time (microseconds)
+    long long m_max; // maximum time (microseconds)
+    long long m_last; // last sample (microseconds)
+    unsigned long long m_bucket[nbr_buckets]; // histogram
+  };
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //dock for tree
-  ///////////////////////////////////////////////////////////////////////////////////////
+  class event_t
+  {
+  public:
+    int m_stage;
+    int m_tid;
+    long long m_ts; // start (microseconds since process start)
+    long long m_dur; // duration (microseconds)
+    std::string m_name; // optional detail (file or variable name)
+  };
 
-  m_tree_dock = new QDockWidget(this);
-  m_tree_dock->setFeatures(QDockWidget::NoDockWidgetFeatures);
+  static perf_t& instance()
+  {
+    static perf_t perf;
+    return perf;
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //browser tree
-  ///////////////////////////////////////////////////////////////////////////////////////
+  static const char* stage_name(int stage)
+  {
+    switch(stage)
+    {
+    case Open: return "open";
+    case Read: return "read";
+    case Decode: return "decode";
+    case Format: return "format";
+    case Paint: return "paint";
+    case Layout: return "layout";
+    case Compress: return "compress";
+    }
+    return "";
+  }
 
-  m_tree = new FileTreeWidget();
-  m_tree->setHeaderHidden(1);
-  m_tree->set_main_window(this);
-  //add dock
-  m_tree_dock->setWidget(m_tree);
-  addDockWidget(Qt::LeftDockWidgetArea, m_tree_dock);
+  long long now() const
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //actions
-  ///////////////////////////////////////////////////////////////////////////////////////
+  void record(int stage, long long ts, long long dur, const std::string& name)
+  {
+    if(!m_recording)
+    {
+      return;
+    }
+    int bucket = 0;
+    while(bucket < nbr_buckets - 1 && (1LL << (bucket + 1)) <= dur)
+    {
+      bucket++;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stat_t &stat = m_stat[stage];
+    stat.m_count++;
+    stat.m_total += dur;
+    stat.m_last = dur;
+    stat.m_max = std::max(stat.m_max, dur);
+    stat.m_bucket[bucket]++;
+    event_t eve;
+    eve.m_stage = stage;
+    eve.m_tid = thread_index();
+    eve.m_ts = ts;
+    eve.m_dur = dur;
+    eve.m_name = name;
+    if(m_events.size() < max_events)
+    {
+      m_events.push_back(eve);
+    }
+    else
+    {
+      //ring buffer, m_next is the oldest event
+      m_events[m_next] = eve;
+      m_next = (m_next + 1) % max_events;
+    }
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //open
-  ///////////////////////////////////////////////////////////////////////////////////////
+  //copy of statistics, for display
+  std::vector<stat_t> stats()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::vector<stat_t>(m_stat, m_stat + NbrStages);
+  }
 
-  m_action_open = new QAction(tr("&Open..."), this);
-  m_action_open->setIcon(QIcon(":/images/open.png"));
-  m_action_open->setShortcut(QKeySequence::Open);
-  m_action_open->setStatusTip(tr("Open a file"));
-  connect(m_action_open, SIGNAL(triggered()), this, SLOT(open_file()));
+  //copy of trace events, oldest first
+  std::vector<event_t> events()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<event_t> events(m_events.begin() + m_next, m_events.end());
+    events.insert(events.end(), m_events.begin(), m_events.begin() + m_next);
+    return events;
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //open_dap
-  ///////////////////////////////////////////////////////////////////////////////////////
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(int idx = 0; idx < NbrStages; idx++)
+    {
+      m_stat[idx].clear();
+    }
+    m_events.clear();
+    m_next = 0;
+  }
 
-  m_action_opendap = new QAction(tr("OPeN&DAP..."), this);
-  m_action_opendap->setIcon(QIcon(":/images/open_dap.png"));
-  m_action_opendap->setStatusTip(tr("Open a OpenDap URL file"));
-  connect(m_action_opendap, SIGNAL(triggered()), this, SLOT(open_dap()));
+  void set_recording(bool recording)
+  {
+    m_recording = recording;
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //exit
-  ///////////////////////////////////////////////////////////////////////////////////////
+private:
+  perf_t() :
+    m_epoch(std::chrono::steady_clock::now()),
+    m_next(0),
+    m_recording(true)
+  {
+  }
 
-  m_action_exit = new QAction(tr("E&xit"), this);
-  m_action_exit->setShortcut(tr("Ctrl+Q"));
-  m_action_exit->setStatusTip(tr("Exit the application"));
-  connect(m_action_exit, SIGNAL(triggered()), this, SLOT(close()));
+  //small sequential thread id, stable for the thread lifetime (used as trace "tid")
+  static int thread_index()
+  {
+    static std::atomic<int> nbr_threads(0);
+    thread_local int idx = ++nbr_threads;
+    return idx;
+  }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //windows
-  ///////////////////////////////////////////////////////////////////////////////////////
+  std::chrono::steady_clock::time_point m_epoch;
+  std::mutex m_mutex;
+  stat_t m_stat[NbrStages];
+  std::vector<event_t> m_events;
+  size_t m_next;
+  std::atomic<bool> m_recording;
+};
 
-  m_action_close_all = new QAction(tr("Close &All"), this);
-  m_action_close_all->setStatusTip(tr("Close all the windows"));
-  connect(m_action_close_all, SIGNAL(triggered()), m_mdi_area, SLOT(closeAllSubWindows()));
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//perf_timer_t
+//scoped timer, records the lifetime of the object in a perf_t stage
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  m_action_tile = new QAction(tr("&Tile"), this);
-  m_action_tile->setStatusTip(tr("Tile the windows"));
-  connect(m_action_tile, SIGNAL(triggered()), m_mdi_area, SLOT(tileSubWindows()));
+class perf_timer_t
+{
+public:
+  perf_timer_t(perf_t::Stage stage, const std::string& name = std::string()) :
+    m_stage(stage),
+    m_name(name),
+    m_ts(perf_t::instance().now()),
+    m_stopped(false)
+  {
+  }
+  ~perf_timer_t()
+  {
+    stop();
+  }
+  //record the current stage and start timing another one
+  void next(perf_t::Stage stage)
+  {
+    stop();
+    m_stage = stage;
+    m_ts = perf_t::instance().now();
+    m_stopped = false;
+  }
+  void stop()
+  {
+    if(m_stopped)
+    {
+      return;
+    }
+    perf_t &perf = perf_t::instance();
+    perf.record(m_stage, m_ts, perf.now() - m_ts, m_name);
+    m_stopped = true;
+  }
+private:
+  perf_t::Stage m_stage;
+  std::string m_name;
+  long long m_ts;
+  bool m_stopped;
+};
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //about
-  ///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nc_mutex
+//the netCDF library is not thread safe: code that may run on worker threads (reads of ncfile_t and
+//read_hyperslab/read_series) holds this lock during netCDF calls
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  m_action_about = new QAction(tr("&About"), this);
-  m_action_about->setStatusTip(tr("Show the application's About box"));
-  connect(m_action_about, SIGNAL(triggered()), this, SLOT(about()));
+std::mutex& nc_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //recent files
-  ///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ncfile_t
+//an open netCDF file and the ID of a group in it (or an open HDF5 file); the file is closed on
+//destruction
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  for(int i = 0; i < max_recent_files; ++i)
+class ncfile_t
+{
+public:
+  ncfile_t() :
+    m_nc_id(-1),
+    m_grp_id(-1)
+#ifdef HAVE_HDF5
+    , m_h5_id(-1)
+#endif
+#ifdef HAVE_SQLITE
+    , m_db(NULL)
+#endif
   {
-    m_action_recent_file[i] = new QAction(this);
-    m_action_recent_file[i]->setVisible(false);
-    connect(m_action_recent_file[i], SIGNAL(triggered()), this, SLOT(open_recent_file()));
   }
+  ~ncfile_t()
+  {
+    close();
+  }
+  int open(const std::string& file_name, const std::string& grp_nm_fll)
+  {
+    int fl_fmt;
+    perf_timer_t timer(perf_t::Open, file_name);
+    close();
+    std::lock_guard<std::mutex> lock(nc_mutex());
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //menus
-  ///////////////////////////////////////////////////////////////////////////////////////
-
-  m_menu_file = menuBar()->addMenu(tr("&File"));
-  m_menu_file->addAction(m_action_open);
-  m_menu_file->addAction(m_action_opendap);
-  m_action_separator_recent = m_menu_file->addSeparator();
-  for(int i = 0; i < max_recent_files; ++i)
-    m_menu_file->addAction(m_action_recent_file[i]);
-  m_menu_file->addSeparator();
-  m_menu_file->addAction(m_action_exit);
-
-  m_menu_windows = menuBar()->addMenu(tr("&Window"));
-  m_menu_windows->addAction(m_action_tile);
-  m_menu_windows->addAction(m_action_close_all);
-
-  m_menu_help = menuBar()->addMenu(tr("&Help"));
-  m_menu_help->addAction(m_action_about);
-
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //toolbar
-  ///////////////////////////////////////////////////////////////////////////////////////
-
-  m_tool_bar = addToolBar(tr("&File"));
-  m_tool_bar->addAction(m_action_open);
-  m_tool_bar->addAction(m_action_opendap);
-
-  //avoid popup on toolbar
-  setContextMenuPolicy(Qt::NoContextMenu);
-
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //settings
-  ///////////////////////////////////////////////////////////////////////////////////////
-
-  QSettings settings("space", "data_explorer");
-  m_sl_recent_files = settings.value("recentFiles").toStringList();
-  update_recent_file_actions();
-
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //icons
-  ///////////////////////////////////////////////////////////////////////////////////////
-
-  m_icon_main = QIcon(":/images/sample.png");
-  m_icon_group = QIcon(":/images/folder.png");
-  m_icon_dataset = QIcon(":/images/document.png");
+    if(nc_open(file_name.c_str(), NC_NOWRITE, &m_nc_id) != NC_NOERR)
+    {
+      m_nc_id = -1;
+      return NC2_ERR;
+    }
 
-  ///////////////////////////////////////////////////////////////////////////////////////
-  //set main window icon
-  ///////////////////////////////////////////////////////////////////////////////////////
+    //need a file format inquiry, since nc_inq_grp_full_ncid does not handle netCDF3 cases
+    if(nc_inq_format(m_nc_id, &fl_fmt) != NC_NOERR)
+    {
+      nc_close(m_nc_id);
+      m_nc_id = -1;
+      return NC2_ERR;
+    }
 
-  setWindowIcon(m_icon_main);
-}
+    if(fl_fmt == NC_FORMAT_NETCDF4 || fl_fmt == NC_FORMAT_NETCDF4_CLASSIC)
+    {
+      // obtain group ID for netCDF4 files
+      if(nc_inq_grp_full_ncid(m_nc_id, grp_nm_fll.c_str(), &m_grp_id) != NC_NOERR)
+      {
+        nc_close(m_nc_id);
+        m_nc_id = -1;
+        m_grp_id = -1;
+        return NC2_ERR;
+      }
+    }
+    else
+    {
+      //make the group ID the file ID for netCDF3 cases
+      m_grp_id = m_nc_id;
+    }
+    return NC_NOERR;
+  }
+  void close()
+  {
+    if(m_nc_id != -1)
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      nc_close(m_nc_id);
+    }
+    m_nc_id = -1;
+    m_grp_id = -1;
+    for(std::map<int, chunk_cache_t*>::iterator it = m_chunk_caches.begin(); it != m_chunk_caches.end(); ++it)
+    {
+      delete it->second;
+    }
+    m_chunk_caches.clear();
+#ifdef HAVE_HDF5
+    if(m_h5_id >= 0)
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      H5Fclose(m_h5_id);
+    }
+    m_h5_id = -1;
+#endif
+#ifdef HAVE_SQLITE
+    sqlite3_close(m_db);
+    m_db = NULL;
+#endif
+  }
+#ifdef HAVE_HDF5
+  int open_hdf5(const std::string& file_name)
+  {
+    perf_timer_t timer(perf_t::Open, file_name);
+    close();
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    m_h5_id = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    return m_h5_id < 0 ? NC2_ERR : NC_NOERR;
+  }
+#endif
+  int m_nc_id;
+  int m_grp_id;
+  std::map<int, chunk_cache_t*> m_chunk_caches; // chunk cache of the variables read, by ID (keys only, NULL if not chunked)
+#ifdef HAVE_HDF5
+  hid_t m_h5_id;
+#endif
+#ifdef HAVE_SQLITE
+  int open_sqlite(const std::string& file_name)
+  {
+    close();
+    if(sqlite3_open_v2(file_name.c_str(), &m_db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK)
+    {
+      close();
+      return NC2_ERR;
+    }
+    return NC_NOERR;
+  }
+  sqlite3 *m_db;
+#endif
+};
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::about
+//nc_type_size
+//size in bytes of an element of an atomic netCDF type
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::about()
+size_t nc_type_size(const nc_type typ)
 {
-  QMessageBox::about(this,
-    tr("About Data Explorer"),
-    tr("(c) 2015-2016 Pedro Vicente -- Space Research Software LLC\n\n"));
+  switch(typ)
+  {
+  case NC_FLOAT:
+    return sizeof(float);
+  case NC_DOUBLE:
+    return sizeof(double);
+  case NC_INT:
+    return sizeof(int);
+  case NC_SHORT:
+    return sizeof(short);
+  case NC_CHAR:
+    return sizeof(char);
+  case NC_BYTE:
+    return sizeof(signed char);
+  case NC_UBYTE:
+    return sizeof(unsigned char);
+  case NC_USHORT:
+    return sizeof(unsigned short);
+  case NC_UINT:
+    return sizeof(unsigned int);
+  case NC_INT64:
+    return sizeof(long long);
+  case NC_UINT64:
+    return sizeof(unsigned long long);
+  case NC_STRING:
+    return sizeof(char*);
+  }
+  return 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::closeEvent
+//string_arena
+//pack 'nbr' strings allocated by the library into a single block: the table of pointers followed by
+//the bytes of all strings, so that the buffer of a string variable is indexed like the library one
+//(char**), its strings are contiguous and it is released with one free; the strings and their table
+//are released; NULL if the block cannot be allocated
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::closeEvent(QCloseEvent *eve)
+void* string_arena(char **buf, size_t nbr)
 {
-  QSettings settings("space", "data_explorer");
-  settings.setValue("recentFiles", m_sl_recent_files);
-  eve->accept();
+  size_t nbr_byt = 0;
+  for(size_t idx = 0; idx < nbr; idx++)
+  {
+    nbr_byt += (buf[idx] != NULL ? strlen(buf[idx]) : 0) + 1;
+  }
+  char **arena = static_cast<char**>(malloc(nbr * sizeof(char*) + nbr_byt));
+  if(arena != NULL)
+  {
+    char *str = reinterpret_cast<char*>(arena + nbr);
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      size_t len = buf[idx] != NULL ? strlen(buf[idx]) : 0;
+      memcpy(str, buf[idx], len);
+      str[len] = '\0';
+      arena[idx] = str;
+      str += len + 1;
+    }
+  }
+  nc_free_string(nbr, buf);
+  free(buf);
+  return arena;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//is_url
+//copy_hyperslab
+//copy a hyperslab (start, count) of a row major buffer with dimensions ncdim into a contiguous buffer
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool is_url(QString file_name)
+void copy_hyperslab(const void *src, const std::vector<ncdim_t> &ncdim, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, size_t elem_sz, void *dst)
 {
-  bool isurl = (file_name.left(4) == "http");
-  return isurl;
-}
+  size_t nbr_dmn = ncdim.size();
+  if(nbr_dmn == 0)
+  {
+    memcpy(dst, src, elem_sz);
+    return;
+  }
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//last_component
-/////////////////////////////////////////////////////////////////////////////////////////////////////
+  //stride (in elements) of each dimension in the source buffer
+  std::vector<size_t> stride(nbr_dmn, 1);
+  for(size_t idx_dmn = nbr_dmn - 1; idx_dmn > 0; idx_dmn--)
+  {
+    stride[idx_dmn - 1] = stride[idx_dmn] * ncdim[idx_dmn].m_size;
+  }
 
-QString last_component(const QString &full_file_name)
-{
-  return QFileInfo(full_file_name).fileName();
+  //copy contiguous runs along the last dimension
+  size_t run = count[nbr_dmn - 1] * elem_sz;
+  size_t nbr_run = 1;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn - 1; idx_dmn++)
+  {
+    nbr_run *= count[idx_dmn];
+  }
+  std::vector<size_t> pos(nbr_dmn, 0);
+  const char *in = static_cast<const char*>(src);
+  char *out = static_cast<char*>(dst);
+  for(size_t idx_run = 0; idx_run < nbr_run; idx_run++)
+  {
+    size_t off = start[nbr_dmn - 1];
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn - 1; idx_dmn++)
+    {
+      off += (start[idx_dmn] + pos[idx_dmn]) * stride[idx_dmn];
+    }
+    memcpy(out, in + off * elem_sz, run);
+    out += run;
+    for(size_t idx_dmn = nbr_dmn - 1; idx_dmn > 0; idx_dmn--)
+    {
+      if(++pos[idx_dmn - 1] < count[idx_dmn - 1])
+      {
+        break;
+      }
+      pos[idx_dmn - 1] = 0;
+    }
+  }
 }
 
+#ifdef HAVE_HDF5
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::update_recent_file_actions
+//hdf5_nc_type
+//netCDF type of an HDF5 datatype (NC_NAT if there is none)
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::update_recent_file_actions()
+nc_type hdf5_nc_type(hid_t tid)
 {
-  QMutableStringListIterator i(m_sl_recent_files);
-  while(i.hasNext())
+  size_t size = H5Tget_size(tid);
+  switch(H5Tget_class(tid))
   {
-    QString file_name = i.next();
-    if(is_url(file_name))
+  case H5T_INTEGER:
     {
-      continue;
+      bool sign = H5Tget_sign(tid) == H5T_SGN_2;
+      switch(size)
+      {
+      case 1:
+        return sign ? NC_BYTE : NC_UBYTE;
+      case 2:
+        return sign ? NC_SHORT : NC_USHORT;
+      case 4:
+        return sign ? NC_INT : NC_UINT;
+      case 8:
+        return sign ? NC_INT64 : NC_UINT64;
+      }
     }
-    if(!QFile::exists(file_name))
+    break;
+  case H5T_FLOAT:
+    if(size == 4)
     {
-      i.remove();
+      return NC_FLOAT;
     }
-  }
-
-  for(int j = 0; j < max_recent_files; ++j)
-  {
-    if(j < m_sl_recent_files.count())
+    if(size == 8)
     {
-      /////////////////////////////////////////////////////////////////////////////////////////////////////
-      //display full name of OpenDAP URL or just last component of local file
-      /////////////////////////////////////////////////////////////////////////////////////////////////////
-
-      QString file_name;
-      if(is_url(m_sl_recent_files[j]))
-      {
-        file_name = m_sl_recent_files[j];
-      }
-      else
-      {
-        file_name = last_component(m_sl_recent_files[j]);
-      }
-      QString text = tr("&%1 %2")
-        .arg(j + 1)
-        .arg(file_name);
-      m_action_recent_file[j]->setText(text);
-      m_action_recent_file[j]->setData(m_sl_recent_files[j]);
-      m_action_recent_file[j]->setVisible(true);
+      return NC_DOUBLE;
     }
-    else
+    break;
+  case H5T_STRING:
+    if(H5Tis_variable_str(tid) > 0)
     {
-      m_action_recent_file[j]->setVisible(false);
+      return NC_STRING;
     }
+    if(size == 1)
+    {
+      return NC_CHAR;
+    }
+    break;
+  default:
+    break;
   }
-  m_action_separator_recent->setVisible(!m_sl_recent_files.isEmpty());
+  return NC_NAT;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::set_current_file
+//hdf5_mem_type
+//native HDF5 memory datatype of a netCDF type (to be closed with H5Tclose)
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::set_current_file(const QString &file_name)
+hid_t hdf5_mem_type(const nc_type typ)
 {
-  m_str_current_file = file_name;
-
-  QString shownName = tr("Untitled");
-  if(!m_str_current_file.isEmpty())
+  hid_t tid;
+  switch(typ)
   {
-    shownName = last_component(m_str_current_file);
-    m_sl_recent_files.removeAll(m_str_current_file);
-    m_sl_recent_files.prepend(m_str_current_file);
-    update_recent_file_actions();
+  case NC_FLOAT:
+    return H5Tcopy(H5T_NATIVE_FLOAT);
+  case NC_DOUBLE:
+    return H5Tcopy(H5T_NATIVE_DOUBLE);
+  case NC_INT:
+    return H5Tcopy(H5T_NATIVE_INT);
+  case NC_SHORT:
+    return H5Tcopy(H5T_NATIVE_SHORT);
+  case NC_BYTE:
+    return H5Tcopy(H5T_NATIVE_SCHAR);
+  case NC_UBYTE:
+    return H5Tcopy(H5T_NATIVE_UCHAR);
+  case NC_USHORT:
+    return H5Tcopy(H5T_NATIVE_USHORT);
+  case NC_UINT:
+    return H5Tcopy(H5T_NATIVE_UINT);
+  case NC_INT64:
+    return H5Tcopy(H5T_NATIVE_LLONG);
+  case NC_UINT64:
+    return H5Tcopy(H5T_NATIVE_ULLONG);
+  case NC_CHAR:
+    tid = H5Tcopy(H5T_C_S1);
+    H5Tset_size(tid, 1);
+    return tid;
+  case NC_STRING:
+    tid = H5Tcopy(H5T_C_S1);
+    H5Tset_size(tid, H5T_VARIABLE);
+    return tid;
   }
+  return -1;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::open_file
+//read_hdf5_hyperslab
+//read a hyperslab of an HDF5 dataset with a selection of the file dataspace, so that only the
+//hyperslab is read (and decompressed); the file stays open in 'file' for the next reads
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::open_file()
+int read_hdf5_hyperslab(ItemData *item_data, ncfile_t &file, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, void *buf)
 {
-  QString file_name = QFileDialog::getOpenFileName(this,
-    tr("Open File"), ".",
-    tr("netCDF Files (*.nc);;All files (*.*)"));
+  ncvar_t *ncvar = item_data->m_ncvar;
+  std::string path = item_data->m_grp_nm_fll;
+  if(path.empty() || path[path.size() - 1] != '/')
+  {
+    path += "/";
+  }
+  path += item_data->m_item_nm;
 
-  if(file_name.isEmpty())
-    return;
+  if(file.m_h5_id < 0 && file.open_hdf5(item_data->m_file_name) != NC_NOERR)
+  {
+    return NC2_ERR;
+  }
 
-  if(this->read_file(file_name) == NC_NOERR)
+  perf_timer_t timer(perf_t::Read, ncvar->m_name);
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  hid_t did = H5Dopen2(file.m_h5_id, path.c_str(), H5P_DEFAULT);
+  if(did < 0)
+  {
+    return NC2_ERR;
+  }
+  hid_t tid = hdf5_mem_type(ncvar->m_nc_type);
+  hid_t fsid = H5Dget_space(did);
+  hid_t msid = H5S_ALL;
+  herr_t status = 0;
+  if(!count.empty())
+  {
+    std::vector<hsize_t> h5_start(start.begin(), start.end());
+    std::vector<hsize_t> h5_count(count.begin(), count.end());
+    status = H5Sselect_hyperslab(fsid, H5S_SELECT_SET, &h5_start[0], NULL, &h5_count[0], NULL);
+    msid = H5Screate_simple((int)h5_count.size(), &h5_count[0], NULL);
+  }
+  if(status >= 0)
+  {
+    status = H5Dread(did, tid, msid, fsid, H5P_DEFAULT, buf);
+  }
+  if(msid != H5S_ALL)
   {
-    this->set_current_file(file_name);
+    H5Sclose(msid);
   }
+  H5Sclose(fsid);
+  H5Tclose(tid);
+  H5Dclose(did);
+  return status < 0 ? NC2_ERR : NC_NOERR;
 }
 
+#endif
+
+#ifdef HAVE_SQLITE
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::open_dap
+//sql_quote
+//SQL identifier in double quotes
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::open_dap()
+std::string sql_quote(const std::string &name)
 {
-  QInputDialog dlg(this);
-  dlg.setInputMode(QInputDialog::TextInput);
-  dlg.setLabelText("DAP url");
-  dlg.resize(QSize(400, 60));
-  if(QDialog::Accepted == dlg.exec())
+  std::string str("\"");
+  for(size_t idx = 0; idx < name.size(); idx++)
   {
-    QString file_name = dlg.textValue();
-    if(this->read_file(file_name) == NC_NOERR)
+    str += name[idx];
+    if(name[idx] == '"')
     {
-      this->set_current_file(file_name);
+      str += '"';
     }
   }
+  return str + "\"";
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::open_recent_file
+//is_sqlite_file
+//the file starts with the SQLite header string
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void MainWindow::open_recent_file()
+bool is_sqlite_file(const std::string &file_name)
 {
-  QAction *action = qobject_cast<QAction *>(sender());
-  if(action)
+  char header[16];
+  FILE *file = fopen(file_name.c_str(), "rb");
+  if(file == NULL)
   {
-    read_file(action->data().toString());
+    return false;
   }
+  size_t nbr = fread(header, 1, sizeof(header), file);
+  fclose(file);
+  return nbr == sizeof(header) && memcmp(header, "SQLite format 3", sizeof(header)) == 0;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::read_file
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//sql_columns
+//quoted names of a range of columns of a table, comma separated
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int MainWindow::read_file(QString file_name)
+std::string sql_columns(ItemData *item_data, size_t start, size_t count)
 {
-  QByteArray ba;
-  int nc_id;
-  std::string path;
-  std::string str_file_name;
-  QString name;
-  int index;
-  int len;
+  std::string str;
+  for(size_t idx_col = start; idx_col < start + count && idx_col < item_data->m_columns.size(); idx_col++)
+  {
+    str += (idx_col > start ? ", " : "") + sql_quote(item_data->m_columns[idx_col]);
+  }
+  return str;
+}
 
-  //convert QString to char*
-  ba = file_name.toLatin1();
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//read_sqlite_hyperslab
+//read a block of cells of a table (rows by columns) as NC_STRING elements; rows are the rowid
+//range [first rowid + start, + count), read with one range query on the rowid (never OFFSET), so
+//the cost does not depend on the position in the table; rowids without a row are empty strings
+//tables without rowid (views) cannot be read by position
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  //convert to std::string
-  str_file_name = ba.data();
+int read_sqlite_hyperslab(ItemData *item_data, ncfile_t &file, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, void *buf)
+{
+  char **cells = static_cast<char**>(buf);
+  size_t nbr_rows = count[0];
+  size_t nbr_cols = count[1];
+  sqlite3_stmt *stmt;
 
-  if(nc_open(str_file_name.c_str(), NC_NOWRITE, &nc_id) != NC_NOERR)
+  if(item_data->m_rowid_first < 0 || nbr_cols == 0)
+  {
+    return NC2_ERR;
+  }
+  if(file.m_db == NULL && file.open_sqlite(item_data->m_file_name) != NC_NOERR)
   {
     return NC2_ERR;
   }
 
-  //group item
-  ItemData *item_data_grp = new ItemData(ItemData::Group,
-    str_file_name,
-    "/",
-    "/",
-    (ItemData*)NULL,
-    (ncvar_t*)NULL,
-    (grid_policy_t*)NULL);
+  perf_timer_t timer(perf_t::Read, item_data->m_item_nm);
+  std::string sql = "SELECT rowid, " + sql_columns(item_data, start[1], nbr_cols) + " FROM " +
+    sql_quote(item_data->m_item_nm) + " WHERE rowid >= ?1 AND rowid < ?2 ORDER BY rowid";
+  if(sqlite3_prepare_v2(file.m_db, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK)
+  {
+    return NC2_ERR;
+  }
+  long long first = item_data->m_rowid_first + (long long)start[0];
+  sqlite3_bind_int64(stmt, 1, first);
+  sqlite3_bind_int64(stmt, 2, first + (long long)nbr_rows);
+  std::fill(cells, cells + nbr_rows * nbr_cols, (char*)NULL);
+  while(sqlite3_step(stmt) == SQLITE_ROW)
+  {
+    size_t row = (size_t)(sqlite3_column_int64(stmt, 0) - first);
+    for(size_t idx_col = 0; idx_col < nbr_cols; idx_col++)
+    {
+      const char *text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, (int)idx_col + 1));
+      cells[row * nbr_cols + idx_col] = strdup(text ? text : "");
+    }
+  }
+  sqlite3_finalize(stmt);
+  for(size_t idx = 0; idx < nbr_rows * nbr_cols; idx++)
+  {
+    if(cells[idx] == NULL)
+    {
+      cells[idx] = strdup("");
+    }
+  }
+  return NC_NOERR;
+}
 
-  //add root
-  QTreeWidgetItem *root_item = new QTreeWidgetItem(m_tree);
-  index = file_name.lastIndexOf(QChar('/'));
-  len = file_name.length();
-  name = file_name.right(len - index - 1);
-  root_item->setText(0, name);
-  root_item->setIcon(0, m_icon_group);
-  QVariant data;
-  data.setValue(item_data_grp);
-  root_item->setData(0, Qt::UserRole, data);
+#endif
 
-  if(iterate(str_file_name, nc_id, root_item) != NC_NOERR)
-  {
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t
+//optional pool of reader processes (--reader): the netCDF and HDF5 libraries serialize all calls of a
+//process (nc_mutex), so hyperslabs are read by worker processes, each with its own open files, and
+//returned through a shared memory segment per worker; each worker is driven by a thread of the pool,
+//to which a reading thread hands its request; a worker that dies or hangs fails its request (the caller
+//then reads in process) and is started again on the next one
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
+class reader_pool_t
+{
+public:
+  reader_pool_t() :
+    m_enabled(false)
+  {
   }
-
-  if(nc_close(nc_id) != NC_NOERR)
+  ~reader_pool_t()
   {
-
+    stop();
+  }
+  void start(int nbr_readers);
+  void stop();
+  bool enabled() const
+  {
+    return m_enabled;
   }
+  int read(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count, void *buf);
 
+private:
+  class reader_t;
+  std::mutex m_mutex; // guards the readers' requests and the idle list
+  std::condition_variable m_cond;
+  std::vector<reader_t*> m_readers;
+  std::vector<reader_t*> m_idle;
+  std::atomic<bool> m_enabled;
+};
 
-  return NC_NOERR;
+reader_pool_t& reader_pool()
+{
+  static reader_pool_t pool;
+  return pool;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::iterate
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::reader_t
+//thread driving one worker process; the process is owned by the thread (QProcess waits block it only)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int MainWindow::iterate(const std::string& file_name, const int grp_id, QTreeWidgetItem *tree_item_parent)
+class reader_pool_t::reader_t : public QThread
 {
-  char grp_nm[NC_MAX_NAME + 1]; // group name 
-  char var_nm[NC_MAX_NAME + 1]; // variable name 
-  char *grp_nm_fll = NULL; // group full name 
-  int nbr_att; // number of attributes 
-  int nbr_dmn_grp; // number of dimensions for group 
-  int nbr_var; // number of variables 
-  int nbr_grp; // number of sub-groups in this group 
-  int nbr_dmn_var; // number of dimensions for variable 
-  nc_type var_typ; // netCDF type 
-  int *grp_ids; // sub-group IDs array
-  size_t grp_nm_lng; //lenght of full group name
-  int var_dimid[NC_MAX_VAR_DIMS]; // dimensions for variable
-  size_t dmn_sz[NC_MAX_VAR_DIMS]; // dimensions for variable sizes
-  char dmn_nm_var[NC_MAX_NAME + 1]; //dimension name
+public:
+  enum State
+  {
+    Idle,
+    Pending, // request set, not answered yet
+    Done // answered, hyperslab in the segment
+  };
+  reader_t(reader_pool_t *pool, const QString &key) :
+    m_pool(pool),
+    m_key(key),
+    m_nbr_shm(0),
+    m_state(Idle),
+    m_stop(false),
+    m_size(0),
+    m_status(NC_NOERR),
+    m_shm(NULL)
+  {
+  }
+  ~reader_t()
+  {
+    delete m_shm;
+  }
+  void run();
+  reader_pool_t *m_pool;
+  QString m_key; // prefix of the keys of the segments of the worker
+  int m_nbr_shm; // segments created
+  int m_state; // (under the pool mutex)
+  bool m_stop; // (under the pool mutex) exit when idle
+  QByteArray m_request; // serialized request
+  size_t m_size; // bytes of the requested hyperslab
+  int m_status; // read result
+  QSharedMemory *m_shm; // segment the worker writes to
+
+private:
+  enum { reader_timeout = 30000 }; // ms a worker has to answer a request
+  int exchange(QProcess &process);
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::reader_t::run
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  //get item data (of parent item), to store a list of variable names 
-  ItemData *item_data_prn = get_item_data(tree_item_parent);
-  assert(item_data_prn->m_kind == ItemData::Group || item_data_prn->m_kind == ItemData::Root);
+void reader_pool_t::reader_t::run()
+{
+  QProcess process;
+  process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  process.start(QCoreApplication::applicationFilePath(), QStringList() << "--reader");
+  process.waitForStarted();
 
-  // get full name of (parent) group
-  if(nc_inq_grpname_full(grp_id, &grp_nm_lng, NULL) != NC_NOERR)
+  std::unique_lock<std::mutex> lock(m_pool->m_mutex);
+  while(true)
   {
+    m_pool->m_cond.wait(lock, [this] { return m_state == Pending || m_stop; });
+    if(m_state != Pending)
+    {
+      break;
+    }
+    lock.unlock();
+    int status = exchange(process);
+    lock.lock();
+    m_status = status;
+    m_state = Done;
+    m_pool->m_cond.notify_all();
+  }
+  lock.unlock();
 
+  //end of input ends the worker
+  process.closeWriteChannel();
+  if(!process.waitForFinished(1000))
+  {
+    process.kill();
+    process.waitForFinished();
   }
+}
 
-  grp_nm_fll = new char[grp_nm_lng + 1];
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::reader_t::exchange
+//send the request to the worker (length, segment key, request) and wait for its status; the segment
+//is replaced by a larger one when the hyperslab does not fit; a worker that does not answer in
+//reader_timeout ms (hung in the library) is killed, the request fails and the caller reads in process
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  if(nc_inq_grpname_full(grp_id, &grp_nm_lng, grp_nm_fll) != NC_NOERR)
+int reader_pool_t::reader_t::exchange(QProcess &process)
+{
+  if(m_size > INT_MAX / 2)
   {
-
+    return NC2_ERR;
   }
-
-  if(nc_inq(grp_id, &nbr_dmn_grp, &nbr_var, &nbr_att, (int *)NULL) != NC_NOERR)
+  if(process.state() != QProcess::Running)
   {
-
+    process.start(QCoreApplication::applicationFilePath(), QStringList() << "--reader");
+    if(!process.waitForStarted())
+    {
+      return NC2_ERR;
+    }
   }
-
-  for(int idx_var = 0; idx_var < nbr_var; idx_var++)
+  if(m_shm == NULL || (size_t)m_shm->size() < m_size)
   {
-    std::vector<ncdim_t> ncdim; //dimensions for each variable 
-
-    if(nc_inq_var(grp_id, idx_var, var_nm, &var_typ, &nbr_dmn_var, var_dimid, &nbr_att) != NC_NOERR)
+    delete m_shm;
+    m_shm = new QSharedMemory(QString("%1_%2").arg(m_key).arg(m_nbr_shm++));
+    if(!m_shm->create((int)std::max(m_size + m_size / 2, (size_t)(1 << 20))))
     {
-
+      delete m_shm;
+      m_shm = NULL;
+      return NC2_ERR;
     }
+  }
 
-    //store variable name in parent group item (for coordinate variables detection)
-    item_data_prn->m_var_nms.push_back(var_nm);
-
-    //get dimensions
-    for(int idx_dmn = 0; idx_dmn < nbr_dmn_var; idx_dmn++)
+  QByteArray block;
+  QDataStream out(&block, QIODevice::WriteOnly);
+  out << m_shm->key().toUtf8() << m_request;
+  quint32 len = block.size();
+  QElapsedTimer timer;
+  timer.start();
+  process.write(reinterpret_cast<const char*>(&len), sizeof(len));
+  process.write(block);
+  while(process.bytesToWrite() > 0)
+  {
+    int remaining = reader_timeout - (int)timer.elapsed();
+    if(remaining <= 0 || !process.waitForBytesWritten(remaining))
     {
-      //dimensions belong to groups
-      if(nc_inq_dim(grp_id, var_dimid[idx_dmn], dmn_nm_var, &dmn_sz[idx_dmn]) != NC_NOERR)
-      {
-
-      }
-
-      //store dimension 
-      ncdim_t dim(dmn_nm_var, dmn_sz[idx_dmn]);
-      ncdim.push_back(dim);
+      process.kill();
+      process.waitForFinished();
+      return NC2_ERR;
     }
+  }
 
-    //store a ncvar_t
-    ncvar_t *ncvar = new ncvar_t(var_nm, var_typ, ncdim);
+  qint32 status;
+  while(process.bytesAvailable() < (qint64)sizeof(status))
+  {
+    int remaining = reader_timeout - (int)timer.elapsed();
+    if(remaining <= 0 || !process.waitForReadyRead(remaining))
+    {
+      process.kill();
+      process.waitForFinished();
+      return NC2_ERR;
+    }
+  }
+  process.read(reinterpret_cast<char*>(&status), sizeof(status));
+  return status;
+}
 
-    //define a grid dimensions policy
-    grid_policy_t *grid_policy = new grid_policy_t(ncdim);
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::start
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    //append item
-    ItemData *item_data_var = new ItemData(ItemData::Variable,
-      file_name,
-      grp_nm_fll,
-      var_nm,
-      item_data_prn,
-      ncvar,
-      grid_policy);
+void reader_pool_t::start(int nbr_readers)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_enabled)
+  {
+    return;
+  }
+  for(int idx_rdr = 0; idx_rdr < nbr_readers; idx_rdr++)
+  {
+    reader_t *reader = new reader_t(this, QString("data_explorer_%1_%2").arg(QCoreApplication::applicationPid()).arg(idx_rdr));
+    reader->start();
+    m_readers.push_back(reader);
+    m_idle.push_back(reader);
+  }
+  m_enabled = true;
+}
 
-    //append item
-    QTreeWidgetItem *item_var = new QTreeWidgetItem(tree_item_parent);
-    item_var->setText(0, var_nm);
-    item_var->setIcon(0, m_icon_dataset);
-    QVariant data;
-    data.setValue(item_data_var);
-    item_var->setData(0, Qt::UserRole, data);
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::stop
+//refuse new requests, wait for the ones in progress, then end the workers
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void reader_pool_t::stop()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_enabled = false;
+    m_cond.notify_all();
+    m_cond.wait(lock, [this] { return m_idle.size() == m_readers.size(); });
+    for(size_t idx_rdr = 0; idx_rdr < m_readers.size(); idx_rdr++)
+    {
+      m_readers[idx_rdr]->m_stop = true;
+    }
+    m_cond.notify_all();
   }
-
-  if(nc_inq_grps(grp_id, &nbr_grp, (int *)NULL) != NC_NOERR)
+  for(size_t idx_rdr = 0; idx_rdr < m_readers.size(); idx_rdr++)
   {
-
+    m_readers[idx_rdr]->wait();
+    delete m_readers[idx_rdr];
   }
+  m_readers.clear();
+  m_idle.clear();
+}
 
-  grp_ids = new int[nbr_grp];
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reader_pool_t::read
+//read a hyperslab through an idle worker (waiting for one if all are busy); NC2_ERR if the pool is
+//stopped or the worker failed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  if(nc_inq_grps(grp_id, &nbr_grp, grp_ids) != NC_NOERR)
+int reader_pool_t::read(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count, void *buf)
+{
+  ncvar_t *ncvar = item_data->m_ncvar;
+  size_t size = nc_type_size(ncvar->m_nc_type);
+  QVector<quint64> q_start;
+  QVector<quint64> q_count;
+  QVector<quint64> q_dim;
+  for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
   {
-
+    size *= count[idx_dmn];
+    q_start.push_back(start[idx_dmn]);
+    q_count.push_back(count[idx_dmn]);
+  }
+  for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+  {
+    q_dim.push_back(ncvar->m_ncdim[idx_dmn].m_size);
   }
+  QByteArray request;
+  QDataStream out(&request, QIODevice::WriteOnly);
+  out << QByteArray(item_data->m_file_name.c_str()) << QByteArray(item_data->m_grp_nm_fll.c_str())
+    << QByteArray(item_data->m_item_nm.c_str()) << (qint32)item_data->m_source << (qint32)ncvar->m_nc_type
+    << q_dim << (qint32)item_data->m_dim_step << q_start << q_count;
 
-  for(int idx_grp = 0; idx_grp < nbr_grp; idx_grp++)
+  reader_t *reader;
   {
-    if(nc_inq_grpname(grp_ids[idx_grp], grp_nm) != NC_NOERR)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_enabled || !m_idle.empty(); });
+    if(!m_enabled)
     {
-
+      return NC2_ERR;
     }
+    reader = m_idle.back();
+    m_idle.pop_back();
+    reader->m_request = request;
+    reader->m_size = size;
+    reader->m_state = reader_t::Pending;
+    m_cond.notify_all();
+    m_cond.wait(lock, [reader] { return reader->m_state == reader_t::Done; });
+  }
+  int status = reader->m_status;
+  if(status == NC_NOERR && size > 0)
+  {
+    memcpy(buf, reader->m_shm->constData(), size);
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  reader->m_state = reader_t::Idle;
+  m_idle.push_back(reader);
+  m_cond.notify_all();
+  return status;
+}
 
-    //group item
-    ItemData *item_data_grp = new ItemData(ItemData::Group,
-      file_name,
-      grp_nm_fll,
-      grp_nm,
-      item_data_prn,
-      (ncvar_t*)NULL,
-      (grid_policy_t*)NULL);
+#ifdef HAVE_HDF5
+int read_chunked_hyperslab(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  void *buf);
+#endif
 
-    //group item
-    QTreeWidgetItem *item_grp = new QTreeWidgetItem(tree_item_parent);
-    item_grp->setText(0, grp_nm);
-    item_grp->setIcon(0, m_icon_group);
-    QVariant data;
-    data.setValue(item_data_grp);
-    item_grp->setData(0, Qt::UserRole, data);
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//size_chunk_cache
+//size the chunk cache of the library for a variable of an open file after the reads made of it and
+//the layer dimension stepped in the windows (chunk_cache_t::resize): the default cache is often
+//smaller than the chunks of one slice, and each step then inflates them all again. The chunks of the
+//reads are followed in a cache of keys of the same capacity, to count the decompressions avoided (an
+//estimate: the library hashes chunks to slots and preempts chunks read whole)
+//called with the library lock held
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    if(iterate(file_name, grp_ids[idx_grp], item_grp) != NC_NOERR)
+void size_chunk_cache(ItemData *item_data, ncfile_t &file, int var_id, const std::vector<size_t> &start,
+  const std::vector<size_t> &count)
+{
+  const size_t max_chunks = 1 << 16; // chunks of a read that are followed
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  size_t nbr_dmn = ncdim.size();
+  std::map<int, chunk_cache_t*>::iterator it = file.m_chunk_caches.find(var_id);
+  if(it == file.m_chunk_caches.end())
+  {
+    std::vector<size_t> shape(std::max(nbr_dmn, (size_t)1));
+    chunk_cache_t *cache = NULL;
+    int storage;
+    size_t size;
+    size_t nelems;
+    float preemption;
+    if(nbr_dmn && nc_inq_var_chunking(file.m_grp_id, var_id, &storage, &shape[0]) == NC_NOERR &&
+      storage == NC_CHUNKED && nc_get_var_chunk_cache(file.m_grp_id, var_id, &size, &nelems, &preemption) == NC_NOERR)
     {
-
+      int shuffle;
+      int deflate = 0;
+      int level;
+      nc_inq_var_deflate(file.m_grp_id, var_id, &shuffle, &deflate, &level);
+      cache = new chunk_cache_t(shape, nc_type_size(item_data->m_ncvar->m_nc_type), size, deflate != 0);
     }
+    it = file.m_chunk_caches.insert(std::make_pair(var_id, cache)).first;
+  }
+  chunk_cache_t *cache = it->second;
+  if(cache == NULL)
+  {
+    return;
   }
 
-  delete[] grp_ids;
-  delete[] grp_nm_fll;
+  if(cache->resize(start, count, item_data->m_dim_step))
+  {
+    //hash slots: a prime well above the number of chunks held
+    size_t nelems = 10 * (cache->capacity() / cache->chunk_size()) + 1;
+    for(size_t div = 3; div * div <= nelems; div += 2)
+    {
+      if(nelems % div == 0)
+      {
+        nelems += 2;
+        div = 1;
+      }
+    }
+    nc_set_var_chunk_cache(file.m_grp_id, var_id, cache->capacity(), nelems, 0.75f);
+  }
 
-  return NC_NOERR;
+  //chunks of the read
+  const std::vector<size_t> &shape = cache->m_shape;
+  std::vector<size_t> first(nbr_dmn);
+  std::vector<size_t> nbr_chunks(nbr_dmn);
+  std::vector<size_t> org(nbr_dmn);
+  size_t nbr = 1;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(count[idx_dmn] == 0)
+    {
+      return;
+    }
+    first[idx_dmn] = start[idx_dmn] / shape[idx_dmn];
+    nbr_chunks[idx_dmn] = (start[idx_dmn] + count[idx_dmn] - 1) / shape[idx_dmn] - first[idx_dmn] + 1;
+    nbr *= nbr_chunks[idx_dmn];
+  }
+  for(size_t idx = 0; nbr <= max_chunks && idx < nbr; idx++)
+  {
+    size_t rem = idx;
+    for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+    {
+      org[idx_dmn - 1] = (first[idx_dmn - 1] + rem % nbr_chunks[idx_dmn - 1]) * shape[idx_dmn - 1];
+      rem /= nbr_chunks[idx_dmn - 1];
+    }
+    size_t key = cache->key(org, ncdim);
+    if(!cache->find(key, NULL))
+    {
+      cache->count_miss();
+      cache->insert(key, chunk_cache_t::chunk_t());
+    }
+  }
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//TableWidget
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//read_hyperslab
+//read a hyperslab of a variable, in the variable type, from the loaded buffer if there is one,
+//otherwise from the file (opened on first use in 'file', so that a sequence of reads opens it once);
+//derived variables are evaluated for the hyperslab; with the reader pool running, library reads are
+//done by the reader processes
+//NC_STRING elements are always returned as allocated strings, to be released with nc_free_string
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class TableWidget : public QTableWidget
+int read_hyperslab(ItemData *item_data, ncfile_t &file, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, void *buf)
 {
-public:
-  TableWidget(QWidget *parent, ItemData *item_data);
+  ncvar_t *ncvar = item_data->m_ncvar;
+  int var_id;
 
-protected:
-  void paintEvent(QPaintEvent *eve)
+  if(item_data->m_expr != NULL)
   {
-    QTableWidget::paintEvent(eve);
-    show_grid();
+    return item_data->m_expr->evaluate(start, count, static_cast<double*>(buf));
   }
 
-private:
-  void show_grid();
-  ItemData *m_item_data; // the tree item that generated this grid 
-  ncvar_t *m_ncvar; // netCDF variable to display (convenience pointer to data in ItemData) 
-  int m_nbr_rows;   // number of rows
-  int m_nbr_cols;   // number of columns
-  int m_dim_rows;   // choose rows (convenience duplicate to data in ItemData)
-  int m_dim_cols;   // choose columns (convenience duplicate to data in ItemData)
-  std::vector<ncvar_t *> m_ncvar_crd; // optional coordinate variables for variable (convenience duplicate to data in ItemData)
-};
+  if(ncvar->m_store != NULL)
+  {
+    ncvar->m_store->copy_hyperslab(ncvar->m_ncdim, start, count, buf);
+    return NC_NOERR;
+  }
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//ChildWindowTable
-/////////////////////////////////////////////////////////////////////////////////////////////////////
+  //user-defined types are shown from the loaded buffer only (their elements point to library data)
+  if(ncvar->m_nc_type >= NC_FIRSTUSERTYPEID)
+  {
+    return NC2_ERR;
+  }
 
-class ChildWindowTable : public ChildWindow
-{
-public:
-  ChildWindowTable(QWidget *parent, ItemData *item_data) :
-    ChildWindow(parent, item_data)
+  if(ncvar->m_buf != NULL)
   {
-    m_table = new TableWidget(parent, item_data);
-    setCentralWidget(m_table);
+    copy_hyperslab(ncvar->m_buf, ncvar->m_ncdim, start, count, nc_type_size(ncvar->m_nc_type), buf);
+    if(ncvar->m_nc_type == NC_STRING)
+    {
+      size_t nbr = 1;
+      for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
+      {
+        nbr *= count[idx_dmn];
+      }
+      char **buf_string = static_cast<char**>(buf);
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        buf_string[idx] = strdup(buf_string[idx]);
+      }
+    }
+    return NC_NOERR;
   }
-private:
-  TableWidget *m_table;
-};
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//RenderWidget
-/////////////////////////////////////////////////////////////////////////////////////////////////////
+  //library reads in a reader process, when the pool runs; in process if it fails
+  if(reader_pool().enabled() && ncvar->m_nc_type != NC_STRING &&
+    (item_data->m_source == ItemData::SourceNetCDF || item_data->m_source == ItemData::SourceHDF5))
+  {
+    perf_timer_t timer(perf_t::Read, ncvar->m_name);
+    if(reader_pool().read(item_data, start, count, buf) == NC_NOERR)
+    {
+      return NC_NOERR;
+    }
+  }
 
-class RenderWidget : public QWidget
-{
-public:
-  RenderWidget(QWidget *parent, ItemData *item_data) :
-    QWidget(parent),
-    m_item_data(item_data)
+#ifdef HAVE_HDF5
+  if(item_data->m_source == ItemData::SourceHDF5)
+  {
+    return read_hdf5_hyperslab(item_data, file, start, count, buf);
+  }
+#endif
+#ifdef HAVE_SQLITE
+  if(item_data->m_source == ItemData::SourceSQLite)
   {
+    return read_sqlite_hyperslab(item_data, file, start, count, buf);
+  }
+#endif
+#ifdef HAVE_ZARR
+  if(item_data->m_zarr != NULL)
+  {
+    perf_timer_t timer(perf_t::Read, ncvar->m_name);
+    return item_data->m_zarr->read(start, count, buf);
+  }
+#endif
 
+  if(file.m_nc_id == -1)
+  {
+    if(file.open(item_data->m_file_name, item_data->m_grp_nm_fll) != NC_NOERR)
+    {
+      return NC2_ERR;
+    }
   }
-  QSize sizeHint() const;
 
-protected:
-  void paintEvent(QPaintEvent *);
+#ifdef HAVE_HDF5
+  //deflated netCDF-4 variables: chunks inflated on all threads
+  if(read_chunked_hyperslab(item_data, start, count, buf) == NC_NOERR)
+  {
+    return NC_NOERR;
+  }
+#endif
 
-private:
-  ItemData *m_item_data; // the tree item that generated this image 
-};
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  if(nc_inq_varid(file.m_grp_id, item_data->m_item_nm.c_str(), &var_id) != NC_NOERR)
+  {
+    return NC2_ERR;
+  }
+  size_chunk_cache(item_data, file, var_id, start, count);
+
+  perf_timer_t timer(perf_t::Read, ncvar->m_name);
+  return nc_get_vara(file.m_grp_id, var_id, start.data(), count.data(), buf);
+}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//ChildWindowImage
+//read_series
+//read the values of a variable along one dimension at a fixed index of all other dimensions; from the
+//loaded buffer a strided copy, otherwise one strided read of the file, so that the cost depends on the
+//length of the series and not on the size of the variable
+//NC_STRING elements are always returned as allocated strings, to be released with nc_free_string
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class ChildWindowImage : public ChildWindow
+int read_series(ItemData *item_data, ncfile_t &file, const std::vector<size_t> &index, size_t dim, void *buf)
 {
-public:
-  ChildWindowImage(QWidget *parent, ItemData *item_data) :
-    ChildWindow(parent, item_data)
+  ncvar_t *ncvar = item_data->m_ncvar;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  size_t nbr = ncvar->m_ncdim[dim].m_size;
+  std::vector<size_t> start(index);
+  std::vector<size_t> count(nbr_dmn, 1);
+  std::vector<ptrdiff_t> stride(nbr_dmn, 1);
+  int var_id;
+
+  start[dim] = 0;
+  count[dim] = nbr;
+
+  //with all other counts 1, the hyperslab is the series
+  if(item_data->m_expr != NULL || ncvar->m_store != NULL || item_data->m_source != ItemData::SourceNetCDF)
   {
-    m_render_area = new RenderWidget(parent, item_data);
-    setCentralWidget(m_render_area);
+    return read_hyperslab(item_data, file, start, count, buf);
   }
 
-private:
-  RenderWidget *m_render_area;
-};
-
-///////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::add_table
-///////////////////////////////////////////////////////////////////////////////////////
-
-void MainWindow::add_table(ItemData *item_data)
-{
-  ChildWindowTable *window = new ChildWindowTable(this, item_data);
-  m_mdi_area->addSubWindow(window);
-  window->show();
-}
-
-///////////////////////////////////////////////////////////////////////////////////////
-//MainWindow::add_image
-///////////////////////////////////////////////////////////////////////////////////////
-
-void MainWindow::add_image(ItemData *item_data)
-{
-  ChildWindowImage *window = new ChildWindowImage(this, item_data);
-  m_mdi_area->addSubWindow(window);
-  window->show();
-}
-
-///////////////////////////////////////////////////////////////////////////////////////
-//ChildWindow::ChildWindow
-///////////////////////////////////////////////////////////////////////////////////////
-
-ChildWindow::ChildWindow(QWidget *parent, ItemData *item_data) :
-QMainWindow(parent),
-m_ncvar(item_data->m_ncvar)
-{
-  float *buf_float = NULL;
-  double *buf_double = NULL;
-  int *buf_int = NULL;
-  short *buf_short = NULL;
-  signed char *buf_byte = NULL;
-  unsigned char *buf_ubyte = NULL;
-  unsigned short *buf_ushort = NULL;
-  unsigned int *buf_uint = NULL;
-  long long *buf_int64 = NULL;
-  unsigned long long *buf_uint64 = NULL;
-  QString str;
-
-  str.sprintf(" : %s", item_data->m_item_nm.c_str());
-  this->setWindowTitle(last_component(item_data->m_file_name.c_str()) + str);
-
-  //currently selected layers for dimensions greater than two are the first layer
-  if(m_ncvar->m_ncdim.size() > 2)
+  if(ncvar->m_buf != NULL)
   {
-    for(size_t idx_dmn = 0; idx_dmn < m_ncvar->m_ncdim.size() - 2; idx_dmn++)
+    size_t elem_sz = nc_type_size(ncvar->m_nc_type);
+    size_t step = 1;
+    size_t off = 0;
+    //offset of the first element and distance between elements, in elements
+    for(size_t idx_dmn = dim + 1; idx_dmn < nbr_dmn; idx_dmn++)
     {
-      m_layer.push_back(0);
+      step *= ncvar->m_ncdim[idx_dmn].m_size;
+    }
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      off = off * ncvar->m_ncdim[idx_dmn].m_size + start[idx_dmn];
+    }
+    const char *in = static_cast<const char*>(ncvar->m_buf) + off * elem_sz;
+    char *out = static_cast<char*>(buf);
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      memcpy(out + idx * elem_sz, in + idx * step * elem_sz, elem_sz);
+    }
+    if(ncvar->m_nc_type == NC_STRING)
+    {
+      char **buf_string = static_cast<char**>(buf);
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        buf_string[idx] = strdup(buf_string[idx]);
+      }
     }
+    return NC_NOERR;
   }
 
-  QSignalMapper *signal_mapper_next = NULL;
-  QSignalMapper *signal_mapper_previous = NULL;
-  QSignalMapper *signal_mapper_combo = NULL;
-  //data has layers
-  if(item_data->m_ncvar->m_ncdim.size() > 2)
+  if(file.m_nc_id == -1)
   {
-    m_tool_bar = addToolBar(tr("Layers"));
-    signal_mapper_next = new QSignalMapper(this);
-    signal_mapper_previous = new QSignalMapper(this);
-    signal_mapper_combo = new QSignalMapper(this);
-    connect(signal_mapper_next, SIGNAL(mapped(int)), this, SLOT(next_layer(int)));
-    connect(signal_mapper_previous, SIGNAL(mapped(int)), this, SLOT(previous_layer(int)));
-    connect(signal_mapper_combo, SIGNAL(mapped(int)), this, SLOT(combo_layer(int)));
+    if(file.open(item_data->m_file_name, item_data->m_grp_nm_fll) != NC_NOERR)
+    {
+      return NC2_ERR;
+    }
   }
 
-  //number of dimensions above a two-dimensional dataset
-  for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  if(nc_inq_varid(file.m_grp_id, item_data->m_item_nm.c_str(), &var_id) != NC_NOERR)
   {
-    ///////////////////////////////////////////////////////////////////////////////////////
-    //next layer
-    ///////////////////////////////////////////////////////////////////////////////////////
-
-    QAction *action_next  = new QAction(tr("&Next layer..."), this);
-    action_next->setIcon(QIcon(":/images/right.png"));
-    action_next->setStatusTip(tr("Next layer"));
-    connect(action_next, SIGNAL(triggered()), signal_mapper_next, SLOT(map()));
-    signal_mapper_next->setMapping(action_next, idx_dmn);
-
-    ///////////////////////////////////////////////////////////////////////////////////////
-    //previous layer
-    ///////////////////////////////////////////////////////////////////////////////////////
-
-    QAction *action_previous = new QAction(tr("&Previous layer..."), this);
-    action_previous->setIcon(QIcon(":/images/left.png"));
-    action_previous->setStatusTip(tr("Previous layer"));
-    connect(action_previous, SIGNAL(triggered()), signal_mapper_previous, SLOT(map()));
-    signal_mapper_previous->setMapping(action_previous, idx_dmn);
+    return NC2_ERR;
+  }
 
-    ///////////////////////////////////////////////////////////////////////////////////////
-    //add to toolbar
-    ///////////////////////////////////////////////////////////////////////////////////////
+  perf_timer_t timer(perf_t::Read, ncvar->m_name);
+  return nc_get_vars(file.m_grp_id, var_id, start.data(), count.data(), stride.data(), buf);
+}
 
-    m_tool_bar->addAction(action_next);
-    m_tool_bar->addAction(action_previous);
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//slab_iterator_t
+//splits a hyperslab in consecutive blocks of at most a given number of elements;
+//blocks cover whole inner dimensions when possible, so that they are contiguous in the file
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    ///////////////////////////////////////////////////////////////////////////////////////
-    //add combo box with layers, fill with possible coordinate variables and store combo in vector 
-    ///////////////////////////////////////////////////////////////////////////////////////
+class slab_iterator_t
+{
+public:
+  slab_iterator_t(const std::vector<size_t> &start, const std::vector<size_t> &count, size_t max_elem) :
+    m_start(start),
+    m_count(count),
+    m_pos(count.size(), 0),
+    m_dim_split(0),
+    m_step(1),
+    m_done(false)
+  {
+    size_t nbr_dmn = count.size();
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      if(count[idx_dmn] == 0)
+      {
+        m_done = true;
+      }
+    }
+    if(nbr_dmn == 0)
+    {
+      return;
+    }
 
-    QComboBox *combo = new QComboBox;
-    QFont font = combo->font();
-    font.setPointSize(9);
-    combo->setFont(font);
-    QStringList list;
+    //find the dimension to split: all inner dimensions fit in a block
+    size_t inner = 1;
+    m_dim_split = nbr_dmn - 1;
+    while(m_dim_split > 0 && inner * count[m_dim_split] <= max_elem)
+    {
+      inner *= count[m_dim_split];
+      m_dim_split--;
+    }
+    m_step = std::max((size_t)1, max_elem / inner);
+    m_step = std::min(m_step, count[m_dim_split]);
+  }
 
-    //coordinate variable exists
-    if(item_data->m_ncvar_crd[idx_dmn] != NULL)
+  //get next block, returns false when all blocks were visited
+  bool next(std::vector<size_t> &blk_start, std::vector<size_t> &blk_count)
+  {
+    size_t nbr_dmn = m_count.size();
+    if(m_done)
+    {
+      return false;
+    }
+    blk_start.resize(nbr_dmn);
+    blk_count.resize(nbr_dmn);
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
     {
-      void *buf = item_data->m_ncvar_crd[idx_dmn]->m_buf;
-      size_t size = item_data->m_ncvar->m_ncdim[idx_dmn].m_size;
-      switch(item_data->m_ncvar_crd[idx_dmn]->m_nc_type)
+      if(idx_dmn < m_dim_split)
       {
-      case NC_FLOAT:
-        buf_float = static_cast<float*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_FLOAT), buf_float[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_DOUBLE:
-        buf_double = static_cast<double*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_DOUBLE), buf_double[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_INT:
-        buf_int = static_cast<int*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_INT), buf_int[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_SHORT:
-        buf_short = static_cast<short*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_SHORT), buf_short[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_BYTE:
-        buf_byte = static_cast<signed char*>  (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_BYTE), buf_byte[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_UBYTE:
-        buf_ubyte = static_cast<unsigned char*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_USHORT:
-        buf_ushort = static_cast<unsigned short*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_USHORT), buf_ushort[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_UINT:
-        buf_uint = static_cast<unsigned int*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_UINT), buf_uint[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_INT64:
-        buf_int64 = static_cast<long long*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_INT64), buf_int64[idx]);
-          list.append(str);
-        }
-        break;
-      case NC_UINT64:
-        buf_uint64 = static_cast<unsigned long long*> (buf);
-        for(size_t idx = 0; idx < size; idx++)
-        {
-          str.sprintf(get_format(NC_UINT64), buf_uint64[idx]);
-          list.append(str);
-        }
-        break;
-      } //switch
+        blk_start[idx_dmn] = m_start[idx_dmn] + m_pos[idx_dmn];
+        blk_count[idx_dmn] = 1;
+      }
+      else if(idx_dmn == m_dim_split)
+      {
+        blk_start[idx_dmn] = m_start[idx_dmn] + m_pos[idx_dmn];
+        blk_count[idx_dmn] = std::min(m_step, m_count[idx_dmn] - m_pos[idx_dmn]);
+      }
+      else
+      {
+        blk_start[idx_dmn] = m_start[idx_dmn];
+        blk_count[idx_dmn] = m_count[idx_dmn];
+      }
+    }
 
+    //advance
+    if(nbr_dmn == 0)
+    {
+      m_done = true;
+      return true;
     }
-    else
+    m_pos[m_dim_split] += m_step;
+    size_t idx_dmn = m_dim_split;
+    while(m_pos[idx_dmn] >= m_count[idx_dmn])
     {
-      for(unsigned int idx = 0; idx < item_data->m_ncvar->m_ncdim[idx_dmn].m_size; idx++)
+      m_pos[idx_dmn] = 0;
+      if(idx_dmn == 0)
       {
-        str.sprintf("%u", idx + 1);
-        list.append(str);
+        m_done = true;
+        break;
       }
+      idx_dmn--;
+      m_pos[idx_dmn]++;
     }
-
-    combo->addItems(list);
-    connect(combo, SIGNAL(currentIndexChanged(int)), signal_mapper_combo, SLOT(map()));
-    signal_mapper_combo->setMapping(combo, idx_dmn);
-    m_tool_bar->addWidget(combo);
-    m_vec_combo.push_back(combo);
+    return true;
   }
-}
 
-///////////////////////////////////////////////////////////////////////////////////////
-//ChildWindow::previous_layer
-///////////////////////////////////////////////////////////////////////////////////////
+private:
+  std::vector<size_t> m_start;
+  std::vector<size_t> m_count;
+  std::vector<size_t> m_pos; // position of next block, relative to start
+  size_t m_dim_split; // dimension along which blocks advance by m_step
+  size_t m_step;
+  bool m_done;
+};
 
-void ChildWindow::previous_layer(int idx_layer)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nbr_threads
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int nbr_threads()
 {
-  m_layer[idx_layer]--;
-  if(m_layer[idx_layer] < 0)
-  {
-    m_layer[idx_layer] = 0;
-    return;
-  }
-  QComboBox *combo = m_vec_combo.at(idx_layer);
-  combo->setCurrentIndex(m_layer[idx_layer]);
-  update();
+  unsigned int nbr = std::thread::hardware_concurrency();
+  return nbr ? (int)nbr : 1;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//ChildWindow::next_layer
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//parallel_for
+//split [0, nbr) in contiguous ranges, at most one per hardware thread and at least 'grain' long,
+//and call func(begin, end, idx_thread) for each; the first range runs on the calling thread
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ChildWindow::next_layer(int idx_layer)
+template<typename F>
+void parallel_for(size_t nbr, size_t grain, F func)
 {
-  m_layer[idx_layer]++;
-  if((size_t)m_layer[idx_layer] >= m_ncvar->m_ncdim[idx_layer].m_size)
+  size_t nbr_rng = std::min((size_t)nbr_threads(), std::max((size_t)1, nbr / std::max(grain, (size_t)1)));
+  size_t rng_sz = (nbr + nbr_rng - 1) / nbr_rng;
+  std::vector<std::thread> threads;
+  for(size_t idx_rng = 1; idx_rng < nbr_rng; idx_rng++)
   {
-    m_layer[idx_layer] = m_ncvar->m_ncdim[idx_layer].m_size - 1;
-    return;
+    size_t begin = idx_rng * rng_sz;
+    size_t end = std::min(nbr, begin + rng_sz);
+    if(begin >= end)
+    {
+      break;
+    }
+    threads.push_back(std::thread(func, begin, end, (int)idx_rng));
+  }
+  func((size_t)0, std::min(nbr, rng_sz), 0);
+  for(size_t idx_thr = 0; idx_thr < threads.size(); idx_thr++)
+  {
+    threads[idx_thr].join();
   }
-  QComboBox *combo = m_vec_combo.at(idx_layer);
-  combo->setCurrentIndex(m_layer[idx_layer]);
-  update();
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//ChildWindow::combo_layer
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_totals
+//bytes held by all compressed stores, raw and compressed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ChildWindow::combo_layer(int idx_layer)
+std::atomic<size_t>* tile_store_totals()
 {
-  QComboBox *combo = m_vec_combo.at(idx_layer);
-  m_layer[idx_layer] = combo->currentIndex();;
-  update();
+  static std::atomic<size_t> totals[2];
+  return totals;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//TableWidget::TableWidget
-///////////////////////////////////////////////////////////////////////////////////////
+size_t tile_store_t::total_raw_size()
+{
+  return tile_store_totals()[0];
+}
 
-TableWidget::TableWidget(QWidget *parent, ItemData *item_data) :
-QTableWidget(parent),
-m_item_data(item_data),
-m_ncvar(item_data->m_ncvar),
-m_dim_rows(item_data->m_grid_policy->m_dim_rows),
-m_dim_cols(item_data->m_grid_policy->m_dim_cols),
-m_ncvar_crd(item_data->m_ncvar_crd)
+size_t tile_store_t::total_stored_size()
 {
-  setWindowTitle(QString::fromStdString(item_data->m_item_nm));
+  return tile_store_totals()[1];
+}
 
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
-  //define grid
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_counts
+//chunks decompressed and decompressions avoided by a chunk cache, for all variables
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  if(m_ncvar->m_ncdim.size() == 0)
-  {
-    m_nbr_rows = 1;
-    m_nbr_cols = 1;
-  }
-  else if(m_ncvar->m_ncdim.size() == 1)
-  {
-    assert(m_dim_rows == 0);
-    m_nbr_rows = m_ncvar->m_ncdim[m_dim_rows].m_size;
-    m_nbr_cols = 1;
-  }
-  else
-  {
-    m_nbr_rows = m_ncvar->m_ncdim[m_dim_rows].m_size;
-    m_nbr_cols = m_ncvar->m_ncdim[m_dim_cols].m_size;
-  }
-  setRowCount(m_nbr_rows);
-  setColumnCount(m_nbr_cols);
+std::atomic<size_t>* chunk_cache_counts()
+{
+  static std::atomic<size_t> counts[2];
+  return counts;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//get_format
-//Provide sprintf() format string for specified netCDF type
-//Based on NCO utilities
+//chunk_cache_total
+//bytes of the inflated chunks held by all chunk caches
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-const char* get_format(const nc_type typ)
+std::atomic<size_t>& chunk_cache_total()
 {
-  switch(typ)
+  static std::atomic<size_t> total(0);
+  return total;
+}
+
+size_t chunk_cache_t::nbr_inflated()
+{
+  return chunk_cache_counts()[0];
+}
+
+size_t chunk_cache_t::nbr_avoided()
+{
+  return chunk_cache_counts()[1];
+}
+
+void chunk_cache_t::reset_counts()
+{
+  chunk_cache_counts()[0] = 0;
+  chunk_cache_counts()[1] = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::chunk_cache_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+chunk_cache_t::chunk_cache_t(const std::vector<size_t> &shape, size_t elem_sz, size_t capacity, bool counted) :
+  m_shape(shape),
+  m_chunk_sz(elem_sz),
+  m_capacity(capacity),
+  m_bytes(0),
+  m_counted(counted)
+{
+  for(size_t idx_dmn = 0; idx_dmn < m_shape.size(); idx_dmn++)
   {
-  case NC_FLOAT:
-    return "%g";
-  case NC_DOUBLE:
-    return "%.12g";
-  case NC_INT:
-    return "%i";
-  case NC_SHORT:
-    return "%hi";
-  case NC_CHAR:
-    return "%c";
-  case NC_BYTE:
-    return "%hhi";
-  case NC_UBYTE:
-    return "%hhu";
-  case NC_USHORT:
-    return "%hu";
-  case NC_UINT:
-    return "%u";
-  case NC_INT64:
-    return "%lli";
-  case NC_UINT64:
-    return "%llu";
-  case NC_STRING:
-    return "%s";
+    m_chunk_sz *= m_shape[idx_dmn];
   }
-  return NULL;
+  m_chunk_sz = std::max(m_chunk_sz, (size_t)1);
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//TableWidget::show_grid
-///////////////////////////////////////////////////////////////////////////////////////
+chunk_cache_t::~chunk_cache_t()
+{
+  chunk_cache_total() -= m_bytes;
+}
 
-void TableWidget::show_grid()
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::find
+//true if the chunk is in the cache (and 'chunk' its data, if not NULL), made the most recently used;
+//a chunk asked for its data that has none (a key only) is a miss
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool chunk_cache_t::find(size_t key, chunk_t *chunk)
 {
-  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
-  size_t idx_buf = 0;
-  //3D
-  if(parent->m_layer.size() == 1)
+  std::lock_guard<std::mutex> lock(m_mutex);
+  chunks_t::iterator it = m_chunks.find(key);
+  if(it == m_chunks.end() || (chunk != NULL && !it->second.second))
   {
-    idx_buf = parent->m_layer[0] * m_nbr_rows * m_nbr_cols;
+    return false;
   }
-  //4D
-  else if(parent->m_layer.size() == 2)
+  m_order.splice(m_order.begin(), m_order, it->second.first);
+  if(chunk != NULL)
   {
-    idx_buf = parent->m_layer[0] * m_ncvar->m_ncdim[1].m_size + parent->m_layer[1];
-    idx_buf *= m_nbr_rows * m_nbr_cols;
+    *chunk = it->second.second;
   }
-  //5D
-  else if(parent->m_layer.size() == 3)
+  if(m_counted)
   {
-    idx_buf = parent->m_layer[0] * m_ncvar->m_ncdim[1].m_size * m_ncvar->m_ncdim[2].m_size
-      + parent->m_layer[1] * m_ncvar->m_ncdim[2].m_size
-      + parent->m_layer[2];
-    idx_buf *= m_nbr_rows * m_nbr_cols;
+    chunk_cache_counts()[1]++;
   }
-  float *buf_float = NULL;
-  double *buf_double = NULL;
-  int *buf_int = NULL;
-  short *buf_short = NULL;
-  char *buf_char = NULL;
-  signed char *buf_byte = NULL;
-  unsigned char *buf_ubyte = NULL;
-  unsigned short *buf_ushort = NULL;
-  unsigned int *buf_uint = NULL;
-  long long *buf_int64 = NULL;
-  unsigned long long *buf_uint64 = NULL;
-  char* *buf_string = NULL;
-  QString str;
+  return true;
+}
 
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
-  //labels for columns
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::insert
+//add a chunk that was just inflated (NULL to follow the library cache), evicting the least recently
+//used ones beyond the capacity; when the chunks of all caches reach max_total, the least recently
+//used chunks of this cache make room, and the chunk is not kept if that is not enough
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  //columns not defined
-  if(m_dim_cols == -1)
+void chunk_cache_t::insert(size_t key, const chunk_t &chunk)
+{
+  const size_t max_total = 512 << 20; // all caches
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t nbr_max = m_capacity / m_chunk_sz;
+  size_t size = chunk ? chunk->size() : 0;
+  chunks_t::iterator it = m_chunks.find(key);
+  if(nbr_max == 0 || (it != m_chunks.end() && (it->second.second || !chunk)))
   {
-    assert(m_nbr_cols == 1);
-    str.sprintf("%d", 1);
-    this->setHorizontalHeaderItem(0, new QTableWidgetItem(str));
+    return;
   }
-  else
+  if(it != m_chunks.end())
   {
-    //coordinate variable exists
-    if(m_ncvar_crd[m_dim_cols] != NULL)
+    erase(it);
+  }
+  while(m_chunks.size() >= nbr_max)
+  {
+    erase(m_chunks.find(m_order.back()));
+  }
+  while(size > 0 && chunk_cache_total().fetch_add(size) + size > max_total)
+  {
+    chunk_cache_total() -= size;
+    if(m_chunks.empty())
     {
-      switch(m_ncvar_crd[m_dim_cols]->m_nc_type)
-      {
-      case NC_FLOAT:
-        buf_float = static_cast<float*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_FLOAT), buf_float[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_DOUBLE:
-        buf_double = static_cast<double*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_DOUBLE), buf_double[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_INT:
-        buf_int = static_cast<int*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_INT), buf_int[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_SHORT:
-        buf_short = static_cast<short*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_SHORT), buf_short[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_BYTE:
-        buf_byte = static_cast<signed char*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_BYTE), buf_byte[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_UBYTE:
-        buf_ubyte = static_cast<unsigned char*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_USHORT:
-        buf_ushort = static_cast<unsigned short*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_USHORT), buf_ushort[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_UINT:
-        buf_uint = static_cast<unsigned int*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_UINT), buf_uint[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_INT64:
-        buf_int64 = static_cast<long long*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_INT64), buf_int64[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_UINT64:
-        buf_uint64 = static_cast<unsigned long long*> (m_ncvar_crd[m_dim_cols]->m_buf);
-        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-        {
-          str.sprintf(get_format(NC_UINT64), buf_uint64[idx_col]);
-          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-        }
-        break;
-      }//switch  
+      return;
     }
-    //coordinate variable does not exist
-    else
+    erase(m_chunks.find(m_order.back()));
+  }
+  m_bytes += size;
+  m_order.push_front(key);
+  m_chunks[key] = std::make_pair(m_order.begin(), chunk);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::erase
+//remove a chunk (called with the mutex held)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void chunk_cache_t::erase(chunks_t::iterator it)
+{
+  size_t size = it->second.second ? it->second.second->size() : 0;
+  m_bytes -= size;
+  chunk_cache_total() -= size;
+  m_order.erase(it->second.first);
+  m_chunks.erase(it);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::count_miss
+//count a chunk that was decompressed because it was not in the cache
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void chunk_cache_t::count_miss()
+{
+  if(m_counted)
+  {
+    chunk_cache_counts()[0]++;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::resize
+//grow the capacity to the chunks that a read of this hyperslab touches, when stepping along
+//'dim_step' (-1 if not known) reads them again: the next layers are in the same chunks as long as
+//the step stays inside them; a dimension with chunks of one layer gains nothing from a larger cache.
+//Never shrinks (the library reopens the dataset to change its cache); true if it grew
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool chunk_cache_t::resize(const std::vector<size_t> &start, const std::vector<size_t> &count, int dim_step)
+{
+  const size_t max_capacity = 256 << 20; // per variable
+  size_t nbr = 1;
+  if(m_shape.empty() || m_shape.size() != count.size() ||
+    (dim_step >= 0 && (size_t)dim_step < m_shape.size() && m_shape[dim_step] == 1))
+  {
+    return false;
+  }
+  for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
+  {
+    if(count[idx_dmn] == 0)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf("%d", idx_col + 1);
-        this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
-      }
+      return false;
     }
+    nbr *= (start[idx_dmn] + count[idx_dmn] - 1) / m_shape[idx_dmn] - start[idx_dmn] / m_shape[idx_dmn] + 1;
   }
+  size_t capacity = std::min(nbr * m_chunk_sz, std::max(max_capacity, m_chunk_sz));
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(capacity <= m_capacity)
+  {
+    return false;
+  }
+  m_capacity = capacity;
+  return true;
+}
 
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
-  //labels for rows
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::clear
+//release the chunks and the capacity, which grows again with the next reads
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  //rows not defined
-  if(m_dim_rows == -1)
+void chunk_cache_t::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  chunk_cache_total() -= m_bytes;
+  m_bytes = 0;
+  m_capacity = 0;
+  m_chunks.clear();
+  m_order.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//chunk_cache_t::key
+//row major index of the chunk that starts at 'org' in the grid of chunks of the variable
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t chunk_cache_t::key(const std::vector<size_t> &org, const std::vector<ncdim_t> &ncdim) const
+{
+  size_t key = 0;
+  for(size_t idx_dmn = 0; idx_dmn < m_shape.size(); idx_dmn++)
   {
-    str.sprintf("%d", 1);
-    this->setVerticalHeaderItem(0, new QTableWidgetItem(str));
+    key = key * ((ncdim[idx_dmn].m_size + m_shape[idx_dmn] - 1) / m_shape[idx_dmn]) + org[idx_dmn] / m_shape[idx_dmn];
   }
-  else
+  return key;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_t::tile_store_t
+//compress a buffer of 'nbr' elements, tiles in parallel
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+tile_store_t::tile_store_t(const void *buf, size_t nbr, size_t elem_sz) :
+  m_nbr(nbr),
+  m_elem_sz(elem_sz),
+  m_stored(0),
+  m_tiles((nbr + tile_nbr - 1) / tile_nbr)
+{
+  perf_timer_t timer(perf_t::Compress, "store");
+  const char *in = static_cast<const char*>(buf);
+  parallel_for(m_tiles.size(), 1, [&](size_t begin, size_t end, int)
   {
-    //coordinate variable exists
-    if(m_ncvar_crd[m_dim_rows] != NULL)
+    std::vector<char> tmp(tile_nbr * elem_sz);
+    for(size_t idx_tile = begin; idx_tile < end; idx_tile++)
     {
-      switch(m_ncvar_crd[m_dim_rows]->m_nc_type)
+      size_t first = idx_tile * tile_nbr;
+      size_t nbr_tile = std::min((size_t)tile_nbr, nbr - first);
+      const char *src = in + first * elem_sz;
+      for(size_t idx_byt = 0; idx_byt < elem_sz; idx_byt++)
       {
-      case NC_FLOAT:
-        buf_float = static_cast<float*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        char *dst = &tmp[idx_byt * nbr_tile];
+        for(size_t idx = 0; idx < nbr_tile; idx++)
         {
-          str.sprintf(get_format(NC_FLOAT), buf_float[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
-        }
-        break;
-      case NC_DOUBLE:
-        buf_double = static_cast<double*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
-        {
-          str.sprintf(get_format(NC_DOUBLE), buf_double[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          dst[idx] = src[idx * elem_sz + idx_byt];
         }
+      }
+      m_tiles[idx_tile] = qCompress(reinterpret_cast<const uchar*>(&tmp[0]), (int)(nbr_tile * elem_sz), 1);
+    }
+  });
+  for(size_t idx_tile = 0; idx_tile < m_tiles.size(); idx_tile++)
+  {
+    m_stored += m_tiles[idx_tile].size();
+  }
+  tile_store_totals()[0] += raw_size();
+  tile_store_totals()[1] += m_stored;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_t::~tile_store_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+tile_store_t::~tile_store_t()
+{
+  tile_store_totals()[0] -= raw_size();
+  tile_store_totals()[1] -= m_stored;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_t::decompress
+//inflate and unshuffle a tile into 'out' ('tmp' is scratch)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void tile_store_t::decompress(size_t idx_tile, std::vector<char> &out, std::vector<char> &tmp) const
+{
+  size_t nbr_tile = std::min((size_t)tile_nbr, m_nbr - idx_tile * tile_nbr);
+  QByteArray raw = qUncompress(m_tiles[idx_tile]);
+  out.resize(nbr_tile * m_elem_sz);
+  if((size_t)raw.size() != out.size())
+  {
+    std::fill(out.begin(), out.end(), 0);
+    return;
+  }
+  tmp.assign(raw.constData(), raw.constData() + raw.size());
+  for(size_t idx_byt = 0; idx_byt < m_elem_sz; idx_byt++)
+  {
+    const char *src = &tmp[idx_byt * nbr_tile];
+    for(size_t idx = 0; idx < nbr_tile; idx++)
+    {
+      out[idx * m_elem_sz + idx_byt] = src[idx];
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//tile_store_t::copy_hyperslab
+//copy a hyperslab into a contiguous buffer, as copy_hyperslab does for a raw buffer; the tiles touched
+//by the contiguous runs along the last dimension are inflated in parallel, in batches, so that sparse
+//hyperslabs (a series across many tiles) do not hold all their tiles at once
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void tile_store_t::copy_hyperslab(const std::vector<ncdim_t> &ncdim, const std::vector<size_t> &start,
+  const std::vector<size_t> &count, void *dst) const
+{
+  perf_timer_t timer(perf_t::Compress, "load");
+  size_t nbr_dmn = ncdim.size();
+  if(m_nbr == 0)
+  {
+    return;
+  }
+  if(nbr_dmn == 0)
+  {
+    std::vector<char> tile;
+    std::vector<char> tmp;
+    decompress(0, tile, tmp);
+    memcpy(dst, &tile[0], m_elem_sz);
+    return;
+  }
+
+  //offset (in elements) of the contiguous runs along the last dimension, in output order
+  std::vector<size_t> stride(nbr_dmn, 1);
+  for(size_t idx_dmn = nbr_dmn - 1; idx_dmn > 0; idx_dmn--)
+  {
+    stride[idx_dmn - 1] = stride[idx_dmn] * ncdim[idx_dmn].m_size;
+  }
+  size_t run = count[nbr_dmn - 1];
+  size_t nbr_run = 1;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn - 1; idx_dmn++)
+  {
+    nbr_run *= count[idx_dmn];
+  }
+  if(run == 0 || nbr_run == 0)
+  {
+    return;
+  }
+  std::vector<size_t> run_off(nbr_run);
+  std::vector<size_t> pos(nbr_dmn, 0);
+  std::vector<size_t> tiles; // touched tiles, ascending
+  for(size_t idx_run = 0; idx_run < nbr_run; idx_run++)
+  {
+    size_t off = start[nbr_dmn - 1];
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn - 1; idx_dmn++)
+    {
+      off += (start[idx_dmn] + pos[idx_dmn]) * stride[idx_dmn];
+    }
+    run_off[idx_run] = off;
+    for(size_t idx_tile = off / tile_nbr; idx_tile <= (off + run - 1) / tile_nbr; idx_tile++)
+    {
+      if(tiles.empty() || tiles.back() < idx_tile)
+      {
+        tiles.push_back(idx_tile);
+      }
+    }
+    for(size_t idx_dmn = nbr_dmn - 1; idx_dmn > 0; idx_dmn--)
+    {
+      if(++pos[idx_dmn - 1] < count[idx_dmn - 1])
+      {
         break;
-      case NC_INT:
-        buf_int = static_cast<int*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
-        {
-          str.sprintf(get_format(NC_INT), buf_int[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
-        }
+      }
+      pos[idx_dmn - 1] = 0;
+    }
+  }
+
+  //inflate a batch of tiles, then copy the parts of the runs that fall in it
+  size_t nbr_bat = 4 * (size_t)nbr_threads();
+  std::vector<std::vector<char> > batch(nbr_bat);
+  std::vector<std::vector<char> > scratch(nbr_threads());
+  char *out = static_cast<char*>(dst);
+  size_t idx_run = 0;
+  size_t idx_elm = 0; // position in the current run
+  for(size_t idx_bat = 0; idx_bat < tiles.size(); idx_bat += nbr_bat)
+  {
+    size_t nbr_tile = std::min(nbr_bat, tiles.size() - idx_bat);
+    parallel_for(nbr_tile, 1, [&](size_t begin, size_t end, int idx_thr)
+    {
+      for(size_t idx = begin; idx < end; idx++)
+      {
+        decompress(tiles[idx_bat + idx], batch[idx], scratch[idx_thr]);
+      }
+    });
+    size_t idx_tile = 0;
+    while(idx_run < nbr_run)
+    {
+      size_t off = run_off[idx_run] + idx_elm;
+      while(idx_tile < nbr_tile && tiles[idx_bat + idx_tile] < off / tile_nbr)
+      {
+        idx_tile++;
+      }
+      if(idx_tile == nbr_tile)
+      {
         break;
-      case NC_SHORT:
-        buf_short = static_cast<short*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+      }
+      size_t first = tiles[idx_bat + idx_tile] * tile_nbr;
+      size_t nbr = std::min(run - idx_elm, first + batch[idx_tile].size() / m_elem_sz - off);
+      memcpy(out + (idx_run * run + idx_elm) * m_elem_sz, &batch[idx_tile][(off - first) * m_elem_sz], nbr * m_elem_sz);
+      idx_elm += nbr;
+      if(idx_elm == run)
+      {
+        idx_elm = 0;
+        idx_run++;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//copy_chunk
+//copy the part of a chunk that falls in a hyperslab to the (row major) hyperslab buffer; the chunk has
+//its origin and shape in the variable, and its element strides (row or column major)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void copy_chunk(const char *chunk, const std::vector<size_t> &org, const std::vector<size_t> &shape,
+  const std::vector<size_t> &stride_chunk, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  size_t elem_sz, char *out)
+{
+  size_t nbr_dmn = shape.size();
+  std::vector<size_t> lo(nbr_dmn); // intersection of the chunk and the hyperslab, in variable indices
+  std::vector<size_t> len(nbr_dmn);
+  std::vector<size_t> pos(nbr_dmn, 0);
+  std::vector<size_t> stride_out(nbr_dmn, 1);
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    lo[idx_dmn] = std::max(org[idx_dmn], start[idx_dmn]);
+    len[idx_dmn] = std::min(org[idx_dmn] + shape[idx_dmn], start[idx_dmn] + count[idx_dmn]) - lo[idx_dmn];
+  }
+  for(size_t idx_dmn = nbr_dmn; idx_dmn > 1; idx_dmn--)
+  {
+    stride_out[idx_dmn - 2] = stride_out[idx_dmn - 1] * count[idx_dmn - 1];
+  }
+
+  //runs along the last dimension, contiguous in the chunk unless it is in column major order
+  size_t run = nbr_dmn ? len[nbr_dmn - 1] : 1;
+  size_t run_stride = nbr_dmn ? stride_chunk[nbr_dmn - 1] : 1;
+  while(true)
+  {
+    size_t off_chunk = 0;
+    size_t off_out = 0;
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      off_chunk += (lo[idx_dmn] + pos[idx_dmn] - org[idx_dmn]) * stride_chunk[idx_dmn];
+      off_out += (lo[idx_dmn] + pos[idx_dmn] - start[idx_dmn]) * stride_out[idx_dmn];
+    }
+    if(run_stride == 1)
+    {
+      memcpy(out + off_out * elem_sz, chunk + off_chunk * elem_sz, run * elem_sz);
+    }
+    else
+    {
+      for(size_t idx_elm = 0; idx_elm < run; idx_elm++)
+      {
+        memcpy(out + (off_out + idx_elm) * elem_sz, chunk + (off_chunk + idx_elm * run_stride) * elem_sz, elem_sz);
+      }
+    }
+    size_t idx_dmn = nbr_dmn > 1 ? nbr_dmn - 1 : 0;
+    for(; idx_dmn > 0; idx_dmn--)
+    {
+      if(++pos[idx_dmn - 1] < len[idx_dmn - 1])
+      {
+        break;
+      }
+      pos[idx_dmn - 1] = 0;
+    }
+    if(idx_dmn == 0)
+    {
+      break;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//in_range
+//true if a double converts to T without overflow (the conversion of a value out of the range of T is
+//undefined); integer conversions truncate, so the bounds are open one past the extremes
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+bool in_range(double val)
+{
+  if(val != val)
+  {
+    return std::numeric_limits<T>::has_quiet_NaN;
+  }
+  if(std::numeric_limits<T>::is_integer)
+  {
+    return val > (double)std::numeric_limits<T>::lowest() - 1.0 && val < (double)std::numeric_limits<T>::max() + 1.0;
+  }
+  return val >= (double)std::numeric_limits<T>::lowest() && val <= (double)std::numeric_limits<T>::max();
+}
+
+#ifdef HAVE_ZARR
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_array_t::dtype_nc_type
+//netCDF type of a Zarr dtype ("<f4", "|u1", ...; NC_NAT if there is none)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+nc_type zarr_array_t::dtype_nc_type(const std::string &dtype)
+{
+  if(dtype.size() < 3)
+  {
+    return NC_NAT;
+  }
+  int size = atoi(dtype.c_str() + 2);
+  switch(dtype[1])
+  {
+  case 'f':
+    return size == 4 ? NC_FLOAT : size == 8 ? NC_DOUBLE : NC_NAT;
+  case 'i':
+    return size == 1 ? NC_BYTE : size == 2 ? NC_SHORT : size == 4 ? NC_INT : size == 8 ? NC_INT64 : NC_NAT;
+  case 'u':
+    return size == 1 ? NC_UBYTE : size == 2 ? NC_USHORT : size == 4 ? NC_UINT : size == 8 ? NC_UINT64 : NC_NAT;
+  case 'b':
+    return size == 1 ? NC_UBYTE : NC_NAT;
+  case 'S':
+    return size == 1 ? NC_CHAR : NC_NAT;
+  }
+  return NC_NAT;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_fill
+//bytes of an element of type T with a value; false (and a zero element) if the value does not convert
+//to T (NaN or infinity for integer types)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+bool zarr_fill(std::vector<char> &fill, double value)
+{
+  bool valid = in_range<T>(value);
+  T typed = valid ? static_cast<T>(value) : T(0);
+  fill.assign(reinterpret_cast<const char*>(&typed), reinterpret_cast<const char*>(&typed) + sizeof(T));
+  return valid;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_array_t::zarr_array_t
+//parse the .zarray metadata (JSON) of the array in directory 'dir'
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+zarr_array_t::zarr_array_t(const std::string &dir, const std::string &meta) :
+  m_dir(dir),
+  m_nc_type(NC_NAT),
+  m_elem_sz(1),
+  m_swap(false),
+  m_fortran(false),
+  m_separator('.'),
+  m_has_fill(false),
+  m_fill_value(0),
+  m_valid(false)
+{
+  QJsonObject obj = QJsonDocument::fromJson(QByteArray(meta.c_str())).object();
+  std::string dtype = obj.value("dtype").toString().toStdString();
+  QJsonArray chunks = obj.value("chunks").toArray();
+  QJsonValue compressor = obj.value("compressor");
+  QJsonValue filters = obj.value("filters");
+  QJsonValue fill = obj.value("fill_value");
+
+  m_nc_type = dtype_nc_type(dtype);
+  m_elem_sz = m_nc_type == NC_NAT ? 1 : nc_type_size(m_nc_type);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+  m_swap = m_elem_sz > 1 && dtype[0] == '<';
+#else
+  m_swap = m_elem_sz > 1 && dtype[0] == '>';
+#endif
+  m_fortran = obj.value("order").toString() == "F";
+  if(obj.value("dimension_separator").toString() == "/")
+  {
+    m_separator = '/';
+  }
+  for(int idx_dmn = 0; idx_dmn < chunks.size(); idx_dmn++)
+  {
+    m_chunks.push_back((size_t)std::max(1.0, chunks[idx_dmn].toDouble()));
+  }
+  if(compressor.isObject())
+  {
+    m_compressor = compressor.toObject().value("id").toString().toStdString();
+  }
+
+  //fill value: a number, or "NaN" / "Infinity" / "-Infinity" for floating point types
+  if(fill.isDouble())
+  {
+    m_has_fill = true;
+    m_fill_value = fill.toDouble();
+  }
+  else if(fill.isString())
+  {
+    m_has_fill = true;
+    QString str = fill.toString();
+    m_fill_value = str == "NaN" ? std::nan("") : str == "Infinity" ? HUGE_VAL : str == "-Infinity" ? -HUGE_VAL : 0;
+  }
+  bool valid;
+  switch(m_nc_type)
+  {
+  case NC_FLOAT: valid = zarr_fill<float>(m_fill, m_fill_value); break;
+  case NC_DOUBLE: valid = zarr_fill<double>(m_fill, m_fill_value); break;
+  case NC_BYTE: valid = zarr_fill<signed char>(m_fill, m_fill_value); break;
+  case NC_SHORT: valid = zarr_fill<short>(m_fill, m_fill_value); break;
+  case NC_INT: valid = zarr_fill<int>(m_fill, m_fill_value); break;
+  case NC_INT64: valid = zarr_fill<long long>(m_fill, m_fill_value); break;
+  case NC_USHORT: valid = zarr_fill<unsigned short>(m_fill, m_fill_value); break;
+  case NC_UINT: valid = zarr_fill<unsigned int>(m_fill, m_fill_value); break;
+  case NC_UINT64: valid = zarr_fill<unsigned long long>(m_fill, m_fill_value); break;
+  default: valid = zarr_fill<unsigned char>(m_fill, m_fill_value); break;
+  }
+  //a fill value the type cannot hold (NaN or infinity for integer types) means no fill value
+  if(!valid)
+  {
+    m_has_fill = false;
+    m_fill_value = 0;
+  }
+
+  //filters (delta, scale-offset, ...) are not supported; neither are the codecs of libraries not built in
+  m_valid = m_nc_type != NC_NAT && (filters.isNull() || filters.toArray().isEmpty()) &&
+    (m_compressor.empty() || m_compressor == "zlib" || m_compressor == "gzip"
+#ifdef HAVE_ZSTD
+    || m_compressor == "zstd"
+#endif
+#ifdef HAVE_BLOSC
+    || m_compressor == "blosc"
+#endif
+    );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_array_t::read_chunk
+//read the file of a chunk and decompress it into 'chunk' (in stored element order, host byte order);
+//a chunk without a file (ENOENT) is all fill value; a chunk file that exists but cannot be opened
+//(permissions, too many open files, ...) is an error ('raw' is scratch)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int zarr_array_t::read_chunk(const std::vector<size_t> &idx_chunk, std::vector<char> &raw, std::vector<char> &chunk) const
+{
+  size_t nbr = 1;
+  std::string path = m_dir + "/";
+  for(size_t idx_dmn = 0; idx_dmn < m_chunks.size(); idx_dmn++)
+  {
+    nbr *= m_chunks[idx_dmn];
+    path += (idx_dmn ? std::string(1, m_separator) : std::string()) + std::to_string(idx_chunk[idx_dmn]);
+  }
+  if(m_chunks.empty())
+  {
+    path += "0";
+  }
+  chunk.resize(nbr * m_elem_sz);
+
+  errno = 0;
+  FILE *file = fopen(path.c_str(), "rb");
+  if(file == NULL)
+  {
+    if(errno != ENOENT)
+    {
+      return NC2_ERR;
+    }
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      memcpy(&chunk[idx * m_elem_sz], &m_fill[0], m_elem_sz);
+    }
+    return NC_NOERR;
+  }
+  fseek(file, 0, SEEK_END);
+  long file_sz = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  raw.resize(std::max(file_sz, 1L));
+  size_t nbr_read = file_sz > 0 ? fread(&raw[0], 1, (size_t)file_sz, file) : 0;
+  fclose(file);
+  if(file_sz < 0 || nbr_read != (size_t)file_sz)
+  {
+    return NC2_ERR;
+  }
+
+  bool ok = false;
+  if(m_compressor.empty())
+  {
+    ok = nbr_read == chunk.size();
+    if(ok)
+    {
+      memcpy(&chunk[0], &raw[0], chunk.size());
+    }
+  }
+  else if(m_compressor == "zlib" || m_compressor == "gzip")
+  {
+    //window bits 15 + 32: zlib or gzip header, detected
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if(inflateInit2(&stream, 15 + 32) == Z_OK)
+    {
+      stream.next_in = reinterpret_cast<Bytef*>(&raw[0]);
+      stream.avail_in = (uInt)nbr_read;
+      stream.next_out = reinterpret_cast<Bytef*>(&chunk[0]);
+      stream.avail_out = (uInt)chunk.size();
+      ok = inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == chunk.size();
+      inflateEnd(&stream);
+    }
+  }
+#ifdef HAVE_ZSTD
+  else if(m_compressor == "zstd")
+  {
+    size_t nbr_out = ZSTD_decompress(&chunk[0], chunk.size(), &raw[0], nbr_read);
+    ok = !ZSTD_isError(nbr_out) && nbr_out == chunk.size();
+  }
+#endif
+#ifdef HAVE_BLOSC
+  else if(m_compressor == "blosc")
+  {
+    //blosc undoes its own shuffle; the context call is safe on concurrent threads
+    ok = blosc_decompress_ctx(&raw[0], &chunk[0], chunk.size(), 1) == (int)chunk.size();
+  }
+#endif
+  if(!ok)
+  {
+    return NC2_ERR;
+  }
+
+  if(m_swap)
+  {
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      std::reverse(chunk.begin() + idx * m_elem_sz, chunk.begin() + (idx + 1) * m_elem_sz);
+    }
+  }
+  return NC_NOERR;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//zarr_array_t::read
+//read a hyperslab: the chunks it intersects are split among the threads, each reads, decompresses
+//and copies its chunks to their (disjoint) parts of the output
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int zarr_array_t::read(const std::vector<size_t> &start, const std::vector<size_t> &count, void *buf) const
+{
+  size_t nbr_dmn = m_chunks.size();
+  std::vector<size_t> first(nbr_dmn); // first chunk index along each dimension
+  std::vector<size_t> nbr_chunks(nbr_dmn);
+  std::vector<size_t> stride_chunk(nbr_dmn, 1);
+  size_t nbr = 1;
+
+  if(!m_valid || start.size() != nbr_dmn || count.size() != nbr_dmn)
+  {
+    return NC2_ERR;
+  }
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(count[idx_dmn] == 0)
+    {
+      return NC_NOERR;
+    }
+    first[idx_dmn] = start[idx_dmn] / m_chunks[idx_dmn];
+    nbr_chunks[idx_dmn] = (start[idx_dmn] + count[idx_dmn] - 1) / m_chunks[idx_dmn] - first[idx_dmn] + 1;
+    nbr *= nbr_chunks[idx_dmn];
+  }
+  for(size_t idx_dmn = 1; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(m_fortran)
+    {
+      stride_chunk[idx_dmn] = stride_chunk[idx_dmn - 1] * m_chunks[idx_dmn - 1];
+    }
+    else
+    {
+      stride_chunk[nbr_dmn - 1 - idx_dmn] = stride_chunk[nbr_dmn - idx_dmn] * m_chunks[nbr_dmn - idx_dmn];
+    }
+  }
+
+  std::atomic<int> status(NC_NOERR);
+  parallel_for(nbr, 1, [&](size_t begin, size_t end, int)
+  {
+    std::vector<char> raw;
+    std::vector<char> chunk;
+    std::vector<size_t> idx_chunk(nbr_dmn);
+    std::vector<size_t> org(nbr_dmn);
+    for(size_t idx = begin; idx < end; idx++)
+    {
+      size_t rem = idx;
+      for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+      {
+        idx_chunk[idx_dmn - 1] = first[idx_dmn - 1] + rem % nbr_chunks[idx_dmn - 1];
+        org[idx_dmn - 1] = idx_chunk[idx_dmn - 1] * m_chunks[idx_dmn - 1];
+        rem /= nbr_chunks[idx_dmn - 1];
+      }
+      if(read_chunk(idx_chunk, raw, chunk) != NC_NOERR)
+      {
+        status = NC2_ERR;
+        continue;
+      }
+      copy_chunk(&chunk[0], org, m_chunks, stride_chunk, start, count, m_elem_sz, static_cast<char*>(buf));
+    }
+  });
+  return status;
+}
+
+#endif
+
+#ifdef HAVE_HDF5
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//unfilter_chunk
+//undo the filters of a raw HDF5 chunk, last applied first, except those skipped for the chunk (bit i
+//of 'mask' set for filter i); only deflate and shuffle are expected; 'tmp' is scratch
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool unfilter_chunk(std::vector<char> &data, unsigned mask, const std::vector<int> &filters, size_t elem_sz,
+  size_t chunk_sz, std::vector<char> &tmp)
+{
+  for(size_t idx_flt = filters.size(); idx_flt > 0; idx_flt--)
+  {
+    if(mask & (1u << (idx_flt - 1)))
+    {
+      continue;
+    }
+    tmp.resize(chunk_sz);
+    if(filters[idx_flt - 1] == H5Z_FILTER_DEFLATE)
+    {
+      uLongf nbr_out = (uLongf)chunk_sz;
+      if(uncompress(reinterpret_cast<Bytef*>(&tmp[0]), &nbr_out, reinterpret_cast<const Bytef*>(&data[0]),
+        (uLong)data.size()) != Z_OK || nbr_out != chunk_sz)
+      {
+        return false;
+      }
+    }
+    else
+    {
+      //shuffle: byte i of all elements was stored together
+      size_t nbr = chunk_sz / elem_sz;
+      if(data.size() != chunk_sz)
+      {
+        return false;
+      }
+      for(size_t idx_byt = 0; idx_byt < elem_sz; idx_byt++)
+      {
+        const char *src = &data[idx_byt * nbr];
+        for(size_t idx = 0; idx < nbr; idx++)
         {
-          str.sprintf(get_format(NC_SHORT), buf_short[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          tmp[idx * elem_sz + idx_byt] = src[idx];
         }
-        break;
-      case NC_BYTE:
-        buf_byte = static_cast<signed char*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+      }
+    }
+    data.swap(tmp);
+  }
+  return data.size() == chunk_sz;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//filter_chunk
+//apply the filters of a dataset to a chunk, in pipeline order, as H5Dwrite_chunk expects it; only
+//deflate (at 'level') and shuffle are expected; 'tmp' is scratch
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool filter_chunk(std::vector<char> &data, const std::vector<int> &filters, int level, size_t elem_sz,
+  std::vector<char> &tmp)
+{
+  for(size_t idx_flt = 0; idx_flt < filters.size(); idx_flt++)
+  {
+    if(filters[idx_flt] == H5Z_FILTER_DEFLATE)
+    {
+      uLongf nbr_out = compressBound((uLong)data.size());
+      tmp.resize(nbr_out);
+      if(compress2(reinterpret_cast<Bytef*>(&tmp[0]), &nbr_out, reinterpret_cast<const Bytef*>(&data[0]),
+        (uLong)data.size(), level) != Z_OK)
+      {
+        return false;
+      }
+      tmp.resize(nbr_out);
+    }
+    else if(filters[idx_flt] == H5Z_FILTER_SHUFFLE)
+    {
+      //byte i of all elements together
+      size_t nbr = data.size() / elem_sz;
+      tmp.resize(data.size());
+      for(size_t idx_byt = 0; idx_byt < elem_sz; idx_byt++)
+      {
+        char *dst = &tmp[idx_byt * nbr];
+        for(size_t idx = 0; idx < nbr; idx++)
         {
-          str.sprintf(get_format(NC_BYTE), buf_byte[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          dst[idx] = data[idx * elem_sz + idx_byt];
         }
-        break;
-      case NC_UBYTE:
-        buf_ubyte = static_cast<unsigned char*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+      }
+    }
+    else
+    {
+      return false;
+    }
+    data.swap(tmp);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//read_chunked_hyperslab
+//fast path for deflated netCDF-4 variables: the raw chunks of the hyperslab are read directly from the
+//HDF5 file (H5Dread_chunk, under the library lock) and inflated, unshuffled and copied on all threads,
+//where nc_get_vara inflates them one at a time; NC2_ERR when the read fails, or when the variable is not
+//a chunked and deflated dataset of a native numeric type (remembered in the item data, so that it is
+//read with netCDF from then on)
+//inflated chunks are kept only for the slices read by the windows stepping a layer dimension; whole
+//variable loads and scans (find, export, reductions, subsets, reader processes) do not fill the cache
+//the netCDF library must have the file open: the HDF5 file is opened with its file close degree
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int read_chunked_hyperslab(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  void *buf)
+{
+  ncvar_t *ncvar = item_data->m_ncvar;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  size_t elem_sz = nc_type_size(ncvar->m_nc_type);
+  std::vector<hsize_t> chunk_dims(std::max(nbr_dmn, (size_t)1));
+  std::vector<int> filters; // filter pipeline, in the order applied when writing
+  std::vector<char> fill(std::max(elem_sz, (size_t)1), 0);
+  hid_t fid = -1;
+  hid_t did = -1;
+  bool chunked = false;
+  bool deflated = false;
+
+  if(item_data->m_chunked == 0 || nbr_dmn == 0 || elem_sz == 0 ||
+    ncvar->m_nc_type == NC_CHAR || ncvar->m_nc_type == NC_STRING)
+  {
+    return NC2_ERR;
+  }
+
+  perf_timer_t timer(perf_t::Read, ncvar->m_name);
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    const H5F_close_degree_t degree[] = { H5F_CLOSE_SEMI, H5F_CLOSE_STRONG, H5F_CLOSE_WEAK };
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    std::string path = item_data->m_grp_nm_fll;
+    if(path.empty() || path[path.size() - 1] != '/')
+    {
+      path += "/";
+    }
+    H5E_BEGIN_TRY
+    {
+      for(size_t idx_deg = 0; fid < 0 && idx_deg < sizeof(degree) / sizeof(degree[0]); idx_deg++)
+      {
+        H5Pset_fclose_degree(fapl, degree[idx_deg]);
+        fid = H5Fopen(item_data->m_file_name.c_str(), H5F_ACC_RDONLY, fapl);
+      }
+      //netCDF-4 stores a variable that has the name of a dimension it is not the coordinate of under a prefix
+      if(fid >= 0)
+      {
+        did = H5Dopen2(fid, (path + item_data->m_item_nm).c_str(), H5P_DEFAULT);
+      }
+      if(fid >= 0 && did < 0)
+      {
+        did = H5Dopen2(fid, (path + "_nc4_non_coord_" + item_data->m_item_nm).c_str(), H5P_DEFAULT);
+      }
+    }
+    H5E_END_TRY;
+    H5Pclose(fapl);
+
+    if(did >= 0)
+    {
+      hid_t dcpl = H5Dget_create_plist(did);
+      hid_t tid = H5Dget_type(did);
+      hid_t mem_tid = hdf5_mem_type(ncvar->m_nc_type);
+      chunked = H5Pget_layout(dcpl) == H5D_CHUNKED && H5Pget_chunk(dcpl, (int)nbr_dmn, &chunk_dims[0]) == (int)nbr_dmn &&
+        H5Tequal(tid, mem_tid) > 0;
+      int nbr_flt = H5Pget_nfilters(dcpl);
+      for(int idx_flt = 0; chunked && idx_flt < nbr_flt; idx_flt++)
+      {
+        unsigned int flags;
+        size_t nbr_cd = 0;
+        H5Z_filter_t id = H5Pget_filter2(dcpl, (unsigned)idx_flt, &flags, &nbr_cd, NULL, 0, NULL, NULL);
+        deflated = deflated || id == H5Z_FILTER_DEFLATE;
+        chunked = id == H5Z_FILTER_DEFLATE || id == H5Z_FILTER_SHUFFLE;
+        filters.push_back(id);
+      }
+      if(chunked && deflated)
+      {
+        H5Pget_fill_value(dcpl, mem_tid, &fill[0]);
+      }
+      H5Tclose(mem_tid);
+      H5Tclose(tid);
+      H5Pclose(dcpl);
+    }
+    if(!chunked || !deflated)
+    {
+      if(did >= 0)
+      {
+        H5Dclose(did);
+      }
+      if(fid >= 0)
+      {
+        H5Fclose(fid);
+      }
+      item_data->m_chunked = 0;
+      return NC2_ERR;
+    }
+  }
+  item_data->m_chunked = 1;
+
+  //chunks of the hyperslab
+  std::vector<size_t> shape(chunk_dims.begin(), chunk_dims.begin() + nbr_dmn);
+  std::vector<size_t> stride_chunk(nbr_dmn, 1);
+  std::vector<size_t> first(nbr_dmn);
+  std::vector<size_t> nbr_chunks(nbr_dmn);
+  size_t chunk_nbr = 1;
+  size_t nbr = 1;
+  for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+  {
+    stride_chunk[idx_dmn - 1] = chunk_nbr;
+    chunk_nbr *= shape[idx_dmn - 1];
+  }
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(count[idx_dmn] == 0)
+    {
+      nbr = 0;
+      break;
+    }
+    first[idx_dmn] = start[idx_dmn] / shape[idx_dmn];
+    nbr_chunks[idx_dmn] = (start[idx_dmn] + count[idx_dmn] - 1) / shape[idx_dmn] - first[idx_dmn] + 1;
+    nbr *= nbr_chunks[idx_dmn];
+  }
+
+  //inflated chunks are kept for the next reads, as many as this read touches when stepping reads them
+  //again: a slice (one layer of the stepped dimension) read for a window of the variable
+  int dim_step = item_data->m_dim_step;
+  bool keep = item_data->m_nbr_windows > 0 && dim_step >= 0 && (size_t)dim_step < nbr_dmn && count[dim_step] == 1;
+  chunk_cache_t *cache;
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(item_data->m_chunk_cache == NULL && keep)
+    {
+      item_data->m_chunk_cache = new chunk_cache_t(shape, elem_sz, 0, true);
+    }
+    cache = item_data->m_chunk_cache;
+  }
+  if(keep)
+  {
+    cache->resize(start, count, dim_step);
+  }
+
+  std::atomic<int> status(NC_NOERR);
+  parallel_for(nbr, 1, [&](size_t begin, size_t end, int)
+  {
+    std::vector<char> data;
+    std::vector<char> tmp;
+    std::vector<size_t> org(nbr_dmn);
+    std::vector<hsize_t> offset(nbr_dmn);
+    chunk_cache_t::chunk_t chunk;
+    for(size_t idx = begin; idx < end && status == NC_NOERR; idx++)
+    {
+      size_t rem = idx;
+      for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+      {
+        org[idx_dmn - 1] = (first[idx_dmn - 1] + rem % nbr_chunks[idx_dmn - 1]) * shape[idx_dmn - 1];
+        offset[idx_dmn - 1] = org[idx_dmn - 1];
+        rem /= nbr_chunks[idx_dmn - 1];
+      }
+      size_t key = cache != NULL ? cache->key(org, ncvar->m_ncdim) : 0;
+      if(cache != NULL && cache->find(key, &chunk))
+      {
+        copy_chunk(&(*chunk)[0], org, shape, stride_chunk, start, count, elem_sz, static_cast<char*>(buf));
+        continue;
+      }
+      hsize_t raw_sz = 0;
+      haddr_t addr = HADDR_UNDEF;
+      unsigned mask = 0;
+      herr_t result;
+      {
+        std::lock_guard<std::mutex> lock(nc_mutex());
+        H5E_BEGIN_TRY
         {
-          str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          result = H5Dget_chunk_info_by_coord(did, &offset[0], &mask, &addr, &raw_sz);
+          if(result >= 0 && addr == HADDR_UNDEF)
+          {
+            raw_sz = 0;
+          }
+          else if(result >= 0 && raw_sz > 0)
+          {
+            data.resize((size_t)raw_sz);
+            result = H5Dread_chunk(did, H5P_DEFAULT, &offset[0], &mask, &data[0]);
+          }
         }
-        break;
-      case NC_USHORT:
-        buf_ushort = static_cast<unsigned short*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        H5E_END_TRY;
+      }
+      if(result < 0)
+      {
+        status = NC2_ERR;
+        continue;
+      }
+
+      //a chunk never written is all fill value
+      if(raw_sz == 0)
+      {
+        data.resize(chunk_nbr * elem_sz);
+        for(size_t idx_elm = 0; idx_elm < chunk_nbr; idx_elm++)
         {
-          str.sprintf(get_format(NC_USHORT), buf_ushort[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          memcpy(&data[idx_elm * elem_sz], &fill[0], elem_sz);
         }
-        break;
-      case NC_UINT:
-        buf_uint = static_cast<unsigned int*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+      }
+      else if(!unfilter_chunk(data, mask, filters, elem_sz, chunk_nbr * elem_sz, tmp))
+      {
+        status = NC2_ERR;
+        continue;
+      }
+      else if(keep)
+      {
+        //kept if the cache has room (insert decides, under its lock)
+        cache->count_miss();
+        chunk = std::make_shared<std::vector<char> >();
+        chunk->swap(data);
+        cache->insert(key, chunk);
+        copy_chunk(&(*chunk)[0], org, shape, stride_chunk, start, count, elem_sz, static_cast<char*>(buf));
+        continue;
+      }
+      else
+      {
+        chunk_cache_counts()[0]++;
+      }
+      copy_chunk(&data[0], org, shape, stride_chunk, start, count, elem_sz, static_cast<char*>(buf));
+    }
+  });
+
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  H5Dclose(did);
+  H5Fclose(fid);
+  return status;
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//value_at
+//element 'idx' of a buffer of numeric netCDF type 'typ', as a double
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double value_at(const void *buf, const nc_type typ, size_t idx)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    return static_cast<const float*>(buf)[idx];
+  case NC_DOUBLE:
+    return static_cast<const double*>(buf)[idx];
+  case NC_INT:
+    return static_cast<const int*>(buf)[idx];
+  case NC_SHORT:
+    return static_cast<const short*>(buf)[idx];
+  case NC_CHAR:
+    return static_cast<const char*>(buf)[idx];
+  case NC_BYTE:
+    return static_cast<const signed char*>(buf)[idx];
+  case NC_UBYTE:
+    return static_cast<const unsigned char*>(buf)[idx];
+  case NC_USHORT:
+    return static_cast<const unsigned short*>(buf)[idx];
+  case NC_UINT:
+    return static_cast<const unsigned int*>(buf)[idx];
+  case NC_INT64:
+    return (double)static_cast<const long long*>(buf)[idx];
+  case NC_UINT64:
+    return (double)static_cast<const unsigned long long*>(buf)[idx];
+  }
+  return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//is_numeric
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool is_numeric(const nc_type typ)
+{
+  return typ != NC_STRING && typ != NC_CHAR && nc_type_size(typ) != 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t::~nctype_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+nctype_t::~nctype_t()
+{
+  delete m_base_user;
+  for(size_t idx_fld = 0; idx_fld < m_fields.size(); idx_fld++)
+  {
+    delete m_fields[idx_fld].m_user;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t::inquire
+//describe a user-defined type of a group, with the user-defined types it is made of; NULL if the
+//type cannot be described; called with the library lock held
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+nctype_t* nctype_t::inquire(const int grp_id, const nc_type typ)
+{
+  char name[NC_MAX_NAME + 1];
+  size_t size;
+  nc_type base;
+  size_t nbr;
+  int cls;
+
+  if(nc_inq_user_type(grp_id, typ, name, &size, &base, &nbr, &cls) != NC_NOERR)
+  {
+    return NULL;
+  }
+  nctype_t *type = new nctype_t;
+  type->m_class = cls;
+  type->m_name = name;
+  type->m_size = size;
+  type->m_base = base;
+  bool ok = true;
+  switch(cls)
+  {
+  case NC_COMPOUND:
+    for(int idx_fld = 0; ok && idx_fld < (int)nbr; idx_fld++)
+    {
+      field_t field;
+      int nbr_dmn;
+      int dim_sz[NC_MAX_VAR_DIMS];
+      ok = nc_inq_compound_field(grp_id, typ, idx_fld, name, &field.m_offset, &field.m_nc_type, &nbr_dmn, dim_sz) == NC_NOERR;
+      field.m_name = name;
+      for(int idx_dmn = 0; ok && idx_dmn < nbr_dmn; idx_dmn++)
+      {
+        field.m_nbr *= dim_sz[idx_dmn];
+      }
+      if(ok && field.m_nc_type >= NC_FIRSTUSERTYPEID)
+      {
+        field.m_user = inquire(grp_id, field.m_nc_type);
+        ok = field.m_user != NULL;
+      }
+      type->m_fields.push_back(field);
+    }
+    break;
+  case NC_VLEN:
+    if(base >= NC_FIRSTUSERTYPEID)
+    {
+      type->m_base_user = inquire(grp_id, base);
+      ok = type->m_base_user != NULL;
+    }
+    break;
+  case NC_ENUM:
+    for(int idx_mbr = 0; ok && idx_mbr < (int)nbr; idx_mbr++)
+    {
+      char value[sizeof(long long)];
+      ok = nc_inq_enum_member(grp_id, typ, idx_mbr, name, value) == NC_NOERR;
+      type->m_labels[(long long)value_at(value, base, 0)] = name;
+    }
+    break;
+  case NC_OPAQUE:
+    break;
+  default:
+    ok = false;
+  }
+  if(!ok)
+  {
+    delete type;
+    return NULL;
+  }
+  return type;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t::format
+//text of an element: compounds as {member, ...}, VLEN as [value, ...], enum values as their label,
+//opaque data in hexadecimal
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void nctype_t::format(std::string &str, const char *elem) const
+{
+  const size_t max_vlen = 64; // VLEN elements shown
+  char buf[NC_MAX_NAME + 1];
+  switch(m_class)
+  {
+  case NC_COMPOUND:
+    str += "{";
+    for(size_t idx_fld = 0; idx_fld < m_fields.size(); idx_fld++)
+    {
+      if(idx_fld)
+      {
+        str += ", ";
+      }
+      format_field(str, elem, idx_fld);
+    }
+    str += "}";
+    break;
+  case NC_VLEN:
+    {
+      const nc_vlen_t *vlen = reinterpret_cast<const nc_vlen_t*>(elem);
+      size_t elem_sz = m_base_user ? m_base_user->m_size : nc_type_size(m_base);
+      str += "[";
+      for(size_t idx = 0; idx < vlen->len && idx < max_vlen; idx++)
+      {
+        if(idx)
         {
-          str.sprintf(get_format(NC_UINT), buf_uint[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          str += ", ";
         }
-        break;
-      case NC_INT64:
-        buf_int64 = static_cast<long long*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        if(m_base_user)
         {
-          str.sprintf(get_format(NC_INT64), buf_int64[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          m_base_user->format(str, static_cast<const char*>(vlen->p) + idx * elem_sz);
         }
-        break;
-      case NC_UINT64:
-        buf_uint64 = static_cast<unsigned long long*> (m_ncvar_crd[m_dim_rows]->m_buf);
-        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        else
         {
-          str.sprintf(get_format(NC_UINT64), buf_uint64[idx_row]);
-          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+          format_value(buf, sizeof(buf), vlen->p, m_base, idx);
+          str += buf;
         }
-        break;
-      }//switch
+      }
+      str += vlen->len > max_vlen ? ", ...]" : "]";
+    }
+    break;
+  case NC_ENUM:
+    {
+      long long value = (long long)value_at(elem, m_base, 0);
+      std::map<long long, std::string>::const_iterator it = m_labels.find(value);
+      if(it != m_labels.end())
+      {
+        str += it->second;
+      }
+      else
+      {
+        format_value(buf, sizeof(buf), elem, m_base, 0);
+        str += buf;
+      }
+    }
+    break;
+  case NC_OPAQUE:
+    str += "0x";
+    for(size_t idx = 0; idx < m_size; idx++)
+    {
+      snprintf(buf, sizeof(buf), "%02x", (unsigned char)elem[idx]);
+      str += buf;
+    }
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t::format_field
+//text of a member of a compound element (array members as [value, ...])
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void nctype_t::format_field(std::string &str, const char *elem, size_t idx_fld) const
+{
+  const field_t &field = m_fields[idx_fld];
+  size_t elem_sz = field.m_user ? field.m_user->m_size : nc_type_size(field.m_nc_type);
+  char buf[NC_MAX_NAME + 1];
+  if(field.m_nbr > 1)
+  {
+    str += "[";
+  }
+  for(size_t idx = 0; idx < field.m_nbr; idx++)
+  {
+    if(idx)
+    {
+      str += ", ";
+    }
+    if(field.m_user)
+    {
+      field.m_user->format(str, elem + field.m_offset + idx * elem_sz);
+    }
+    else
+    {
+      format_value(buf, sizeof(buf), elem + field.m_offset, field.m_nc_type, idx);
+      str += buf;
+    }
+  }
+  if(field.m_nbr > 1)
+  {
+    str += "]";
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nctype_t::release
+//free what the library allocated for 'nbr' elements (VLEN data, strings), not the buffer itself; the
+//data of the VLEN elements of a buffer is released at once with nc_free_vlens
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void nctype_t::release(char *buf, size_t nbr) const
+{
+  switch(m_class)
+  {
+  case NC_COMPOUND:
+    for(size_t idx_fld = 0; idx_fld < m_fields.size(); idx_fld++)
+    {
+      const field_t &field = m_fields[idx_fld];
+      if(field.m_user == NULL && field.m_nc_type != NC_STRING)
+      {
+        continue;
+      }
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        char *data = buf + idx * m_size + field.m_offset;
+        if(field.m_user)
+        {
+          field.m_user->release(data, field.m_nbr);
+        }
+        else
+        {
+          nc_free_string(field.m_nbr, reinterpret_cast<char**>(data));
+        }
+      }
+    }
+    break;
+  case NC_VLEN:
+    {
+      nc_vlen_t *vlen = reinterpret_cast<nc_vlen_t*>(buf);
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        if(vlen[idx].p == NULL)
+        {
+          continue;
+        }
+        if(m_base_user)
+        {
+          m_base_user->release(static_cast<char*>(vlen[idx].p), vlen[idx].len);
+        }
+        else if(m_base == NC_STRING)
+        {
+          nc_free_string(vlen[idx].len, static_cast<char**>(vlen[idx].p));
+        }
+      }
+      nc_free_vlens(nbr, vlen);
+    }
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//get_fill_value
+//_FillValue attribute of a variable (or the fill value of an HDF5 dataset, read by the walk), or the
+//netCDF default fill value for its type
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void get_fill_value(ItemData *item_data, double *fill)
+{
+  ncfile_t file;
+  int var_id;
+  if(item_data->m_has_fill)
+  {
+    *fill = item_data->m_fill_value;
+    return;
+  }
+#ifdef HAVE_ZARR
+  if(item_data->m_zarr != NULL && item_data->m_zarr->m_has_fill)
+  {
+    *fill = item_data->m_zarr->m_fill_value;
+    return;
+  }
+#endif
+  if(item_data->m_source == ItemData::SourceNetCDF &&
+    file.open(item_data->m_file_name, item_data->m_grp_nm_fll) == NC_NOERR)
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_inq_varid(file.m_grp_id, item_data->m_item_nm.c_str(), &var_id) == NC_NOERR &&
+      nc_get_att_double(file.m_grp_id, var_id, _FillValue, fill) == NC_NOERR)
+    {
+      return;
+    }
+  }
+  switch(item_data->m_ncvar->m_nc_type)
+  {
+  case NC_FLOAT:
+    *fill = NC_FILL_FLOAT;
+    break;
+  case NC_DOUBLE:
+    *fill = NC_FILL_DOUBLE;
+    break;
+  case NC_INT:
+    *fill = NC_FILL_INT;
+    break;
+  case NC_SHORT:
+    *fill = NC_FILL_SHORT;
+    break;
+  case NC_BYTE:
+    *fill = NC_FILL_BYTE;
+    break;
+  case NC_UBYTE:
+    *fill = NC_FILL_UBYTE;
+    break;
+  case NC_USHORT:
+    *fill = NC_FILL_USHORT;
+    break;
+  case NC_UINT:
+    *fill = NC_FILL_UINT;
+    break;
+  case NC_INT64:
+    *fill = (double)NC_FILL_INT64;
+    break;
+  case NC_UINT64:
+    *fill = (double)NC_FILL_UINT64;
+    break;
+  default:
+    *fill = 0;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//name_index_t
+//index of the names of variables, dimensions, attributes and groups of all open files, filled in
+//file iteration; queries of 3 or more characters are substring matches found through a trigram
+//index, shorter queries are prefix matches found by binary search in the sorted names
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class name_index_t
+{
+public:
+  enum NameKind
+  {
+    Variable,
+    Dimension,
+    Attribute,
+    Group
+  };
+
+  class entry_t
+  {
+  public:
+    std::string m_name; // name as in file
+    std::string m_lower; // lower case name (searched)
+    std::string m_path; // file and full path, to display
+    int m_kind; // NameKind
+    QTreeWidgetItem *m_item; // tree item to select (for dimensions and attributes, the owner)
+  };
+
+  name_index_t() :
+    m_sorted_valid(false)
+  {
+  }
+
+  void add(const std::string &name, const std::string &path, int kind, QTreeWidgetItem *item)
+  {
+    entry_t entry;
+    entry.m_name = name;
+    entry.m_lower = to_lower(name);
+    entry.m_path = path;
+    entry.m_kind = kind;
+    entry.m_item = item;
+    uint32_t idx_entry = (uint32_t)m_entries.size();
+    m_entries.push_back(entry);
+
+    for(size_t idx = 0; idx + 3 <= entry.m_lower.size(); idx++)
+    {
+      std::vector<uint32_t> &posting = m_trigram[trigram(entry.m_lower, idx)];
+      if(posting.empty() || posting.back() != idx_entry)
+      {
+        posting.push_back(idx_entry);
+      }
+    }
+    m_sorted_valid = false;
+  }
+
+  //get up to 'max_results' entries that match the query; exact matches first, then prefix matches
+  void search(const std::string &query, size_t max_results, std::vector<uint32_t> &results)
+  {
+    std::string lower = to_lower(query);
+    std::vector<uint32_t> exact;
+    std::vector<uint32_t> prefix;
+    std::vector<uint32_t> other;
+    results.clear();
+    if(lower.empty())
+    {
+      return;
+    }
+
+    if(lower.size() < 3)
+    {
+      sort();
+      std::vector<uint32_t>::const_iterator it = std::lower_bound(m_sorted.begin(), m_sorted.end(), lower, compare_t(m_entries));
+      for(; it != m_sorted.end() && prefix.size() + exact.size() < max_results; ++it)
+      {
+        const std::string &name = m_entries[*it].m_lower;
+        if(name.compare(0, lower.size(), lower) != 0)
+        {
+          break;
+        }
+        (name.size() == lower.size() ? exact : prefix).push_back(*it);
+      }
+    }
+    else
+    {
+      //candidates are the shortest posting list of the query trigrams
+      const std::vector<uint32_t> *candidates = NULL;
+      for(size_t idx = 0; idx + 3 <= lower.size(); idx++)
+      {
+        std::unordered_map<uint32_t, std::vector<uint32_t> >::const_iterator it = m_trigram.find(trigram(lower, idx));
+        if(it == m_trigram.end())
+        {
+          return;
+        }
+        if(candidates == NULL || it->second.size() < candidates->size())
+        {
+          candidates = &it->second;
+        }
+      }
+      for(size_t idx = 0; idx < candidates->size(); idx++)
+      {
+        const std::string &name = m_entries[(*candidates)[idx]].m_lower;
+        size_t pos = name.find(lower);
+        if(pos == std::string::npos)
+        {
+          continue;
+        }
+        if(name.size() == lower.size())
+        {
+          exact.push_back((*candidates)[idx]);
+        }
+        else if(pos == 0)
+        {
+          prefix.push_back((*candidates)[idx]);
+        }
+        else if(other.size() < max_results)
+        {
+          other.push_back((*candidates)[idx]);
+        }
+      }
+    }
+
+    results.insert(results.end(), exact.begin(), exact.end());
+    results.insert(results.end(), prefix.begin(), prefix.end());
+    results.insert(results.end(), other.begin(), other.end());
+    if(results.size() > max_results)
+    {
+      results.resize(max_results);
+    }
+  }
+
+  const entry_t& entry(uint32_t idx) const
+  {
+    return m_entries[idx];
+  }
+
+  size_t size() const
+  {
+    return m_entries.size();
+  }
+
+private:
+  class compare_t
+  {
+  public:
+    compare_t(const std::vector<entry_t> &entries) :
+      m_entries(entries)
+    {
+    }
+    bool operator()(uint32_t a, uint32_t b) const
+    {
+      return m_entries[a].m_lower < m_entries[b].m_lower;
+    }
+    bool operator()(uint32_t a, const std::string &b) const
+    {
+      return m_entries[a].m_lower < b;
+    }
+    const std::vector<entry_t> &m_entries;
+  };
+
+  static std::string to_lower(const std::string &str)
+  {
+    std::string lower(str);
+    for(size_t idx = 0; idx < lower.size(); idx++)
+    {
+      lower[idx] = (char)tolower((unsigned char)lower[idx]);
+    }
+    return lower;
+  }
+
+  static uint32_t trigram(const std::string &str, size_t idx)
+  {
+    return ((uint32_t)(unsigned char)str[idx] << 16) | ((uint32_t)(unsigned char)str[idx + 1] << 8) | (unsigned char)str[idx + 2];
+  }
+
+  //sorted order is rebuilt on the first short query after names were added
+  void sort()
+  {
+    if(m_sorted_valid)
+    {
+      return;
+    }
+    m_sorted.resize(m_entries.size());
+    for(size_t idx = 0; idx < m_sorted.size(); idx++)
+    {
+      m_sorted[idx] = (uint32_t)idx;
+    }
+    std::stable_sort(m_sorted.begin(), m_sorted.end(), compare_t(m_entries));
+    m_sorted_valid = true;
+  }
+
+  std::vector<entry_t> m_entries;
+  std::unordered_map<uint32_t, std::vector<uint32_t> > m_trigram; // trigram to entries that have it
+  std::vector<uint32_t> m_sorted; // entries sorted by lower case name
+  bool m_sorted_valid;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::MainWindow
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MainWindow::MainWindow()
+{
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //mdi area
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_mdi_area = new QMdiArea;
+  setCentralWidget(m_mdi_area);
+
+  setWindowTitle(tr("Data Explorer"));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //status bar
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  statusBar()->showMessage(tr("Ready"));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //dock for tree
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_tree_dock = new QDockWidget(this);
+  m_tree_dock->setFeatures(QDockWidget::NoDockWidgetFeatures);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //browser tree
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_tree = new FileTreeWidget();
+  m_tree->setHeaderHidden(1);
+  m_tree->set_main_window(this);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //name search above the tree, results listed between the search box and the tree
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_name_index = new name_index_t;
+  m_edit_search = new QLineEdit;
+  m_edit_search->setPlaceholderText(tr("Search names"));
+  m_edit_search->setClearButtonEnabled(true);
+  connect(m_edit_search, SIGNAL(textChanged(const QString &)), this, SLOT(search_names(const QString &)));
+  m_list_search = new QListWidget;
+  m_list_search->setUniformItemSizes(true);
+  m_list_search->hide();
+  connect(m_list_search, SIGNAL(itemClicked(QListWidgetItem *)), this, SLOT(select_search_result(QListWidgetItem *)));
+  connect(m_list_search, SIGNAL(itemActivated(QListWidgetItem *)), this, SLOT(select_search_result(QListWidgetItem *)));
+
+  QWidget *widget_tree = new QWidget;
+  QVBoxLayout *layout_tree = new QVBoxLayout(widget_tree);
+  layout_tree->setContentsMargins(0, 0, 0, 0);
+  layout_tree->addWidget(m_edit_search);
+  layout_tree->addWidget(m_list_search);
+  layout_tree->addWidget(m_tree);
+
+  //add dock
+  m_tree_dock->setWidget(widget_tree);
+  addDockWidget(Qt::LeftDockWidgetArea, m_tree_dock);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //dock for timing statistics (hidden, toggled from the Window menu)
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_perf_dock = new PerfDock(this);
+  addDockWidget(Qt::RightDockWidgetArea, m_perf_dock);
+  m_perf_dock->hide();
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //actions
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //open
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_open = new QAction(tr("&Open..."), this);
+  m_action_open->setIcon(QIcon(":/images/open.png"));
+  m_action_open->setShortcut(QKeySequence::Open);
+  m_action_open->setStatusTip(tr("Open a file"));
+  connect(m_action_open, SIGNAL(triggered()), this, SLOT(open_file()));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //open_dap
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_opendap = new QAction(tr("OPeN&DAP..."), this);
+  m_action_opendap->setIcon(QIcon(":/images/open_dap.png"));
+  m_action_opendap->setStatusTip(tr("Open a OpenDap URL file"));
+  connect(m_action_opendap, SIGNAL(triggered()), this, SLOT(open_dap()));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //exit
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_exit = new QAction(tr("E&xit"), this);
+  m_action_exit->setShortcut(tr("Ctrl+Q"));
+  m_action_exit->setStatusTip(tr("Exit the application"));
+  connect(m_action_exit, SIGNAL(triggered()), this, SLOT(close()));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //compressed store
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_compress = new QAction(tr("&Compress Loaded Variables"), this);
+  m_action_compress->setStatusTip(tr("Keep large variables compressed in memory, decompressing the displayed tiles"));
+  m_action_compress->setCheckable(true);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //reader processes
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_readers = new QAction(tr("Read in &Worker Processes"), this);
+  m_action_readers->setStatusTip(tr("Read netCDF and HDF5 variables in a pool of processes, so that windows read concurrently"));
+  m_action_readers->setCheckable(true);
+  connect(m_action_readers, SIGNAL(toggled(bool)), this, SLOT(set_readers(bool)));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //windows
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_close_all = new QAction(tr("Close &All"), this);
+  m_action_close_all->setStatusTip(tr("Close all the windows"));
+  connect(m_action_close_all, SIGNAL(triggered()), m_mdi_area, SLOT(closeAllSubWindows()));
+
+  m_action_tile = new QAction(tr("&Tile"), this);
+  m_action_tile->setStatusTip(tr("Tile the windows"));
+  connect(m_action_tile, SIGNAL(triggered()), m_mdi_area, SLOT(tileSubWindows()));
+
+  m_action_link_layers = new QAction(tr("&Link Layers"), this);
+  m_action_link_layers->setStatusTip(tr("Step the layers of all windows that share a dimension together"));
+  m_action_link_layers->setCheckable(true);
+  m_syncing = false;
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //about
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_action_about = new QAction(tr("&About"), this);
+  m_action_about->setStatusTip(tr("Show the application's About box"));
+  connect(m_action_about, SIGNAL(triggered()), this, SLOT(about()));
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //recent files
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  for(int i = 0; i < max_recent_files; ++i)
+  {
+    m_action_recent_file[i] = new QAction(this);
+    m_action_recent_file[i]->setVisible(false);
+    connect(m_action_recent_file[i], SIGNAL(triggered()), this, SLOT(open_recent_file()));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //menus
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_menu_file = menuBar()->addMenu(tr("&File"));
+  m_menu_file->addAction(m_action_open);
+  m_menu_file->addAction(m_action_opendap);
+  m_action_separator_recent = m_menu_file->addSeparator();
+  for(int i = 0; i < max_recent_files; ++i)
+    m_menu_file->addAction(m_action_recent_file[i]);
+  m_menu_file->addSeparator();
+  m_menu_file->addAction(m_action_compress);
+  m_menu_file->addAction(m_action_readers);
+  m_menu_file->addSeparator();
+  m_menu_file->addAction(m_action_exit);
+
+  m_menu_windows = menuBar()->addMenu(tr("&Window"));
+  m_menu_windows->addAction(m_action_tile);
+  m_menu_windows->addAction(m_action_close_all);
+  m_menu_windows->addAction(m_action_link_layers);
+  m_menu_windows->addSeparator();
+  m_menu_windows->addAction(m_perf_dock->toggleViewAction());
+
+  m_menu_help = menuBar()->addMenu(tr("&Help"));
+  m_menu_help->addAction(m_action_about);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //toolbar
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_tool_bar = addToolBar(tr("&File"));
+  m_tool_bar->addAction(m_action_open);
+  m_tool_bar->addAction(m_action_opendap);
+
+  //avoid popup on toolbar
+  setContextMenuPolicy(Qt::NoContextMenu);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //settings
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  QSettings settings("space", "data_explorer");
+  m_sl_recent_files = settings.value("recentFiles").toStringList();
+  update_recent_file_actions();
+  m_action_compress->setChecked(settings.value("compressLoaded", false).toBool());
+  m_action_readers->blockSignals(true);
+  m_action_readers->setChecked(settings.value("readerProcesses", false).toBool());
+  m_action_readers->blockSignals(false);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //files are walked on worker threads and added to the tree by a timer; icons are loaded and
+  //reader processes started after the window is first shown
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_walk_timer = new QTimer(this);
+  m_walk_timer->setInterval(10);
+  connect(m_walk_timer, SIGNAL(timeout()), this, SLOT(insert_walked()));
+  m_startup_clock = NULL;
+  for(int idx = 0; idx < NbrStartup; idx++)
+  {
+    m_startup_ms[idx] = -1;
+  }
+  QTimer::singleShot(0, this, SLOT(load_icons()));
+  QTimer::singleShot(0, this, SLOT(start_readers()));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::~MainWindow
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MainWindow::~MainWindow()
+{
+  for(size_t idx_wlk = 0; idx_wlk < m_walks.size(); idx_wlk++)
+  {
+    delete m_walks[idx_wlk];
+  }
+  delete m_name_index;
+  reader_pool().stop();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::set_readers
+//start or stop the reader pool, one reader process per hardware thread
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::set_readers(bool on)
+{
+  if(on)
+  {
+    reader_pool().start(nbr_threads());
+  }
+  else
+  {
+    reader_pool().stop();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::start_readers
+//start the reader pool if it was on in the last session, once the window is shown
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::start_readers()
+{
+  set_readers(m_action_readers->isChecked());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::about
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::about()
+{
+  QMessageBox::about(this,
+    tr("About Data Explorer"),
+    tr("(c) 2015-2016 Pedro Vicente -- Space Research Software LLC\n\n"));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::closeEvent
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::closeEvent(QCloseEvent *eve)
+{
+  QSettings settings("space", "data_explorer");
+  settings.setValue("recentFiles", m_sl_recent_files);
+  settings.setValue("compressLoaded", m_action_compress->isChecked());
+  settings.setValue("readerProcesses", m_action_readers->isChecked());
+  eve->accept();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//is_url
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool is_url(QString file_name)
+{
+  bool isurl = (file_name.left(4) == "http");
+  return isurl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//last_component
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+QString last_component(const QString &full_file_name)
+{
+  return QFileInfo(full_file_name).fileName();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::update_recent_file_actions
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::update_recent_file_actions()
+{
+  QMutableStringListIterator i(m_sl_recent_files);
+  while(i.hasNext())
+  {
+    QString file_name = i.next();
+    if(is_url(file_name))
+    {
+      continue;
+    }
+    if(!QFile::exists(file_name))
+    {
+      i.remove();
+    }
+  }
+
+  for(int j = 0; j < max_recent_files; ++j)
+  {
+    if(j < m_sl_recent_files.count())
+    {
+      /////////////////////////////////////////////////////////////////////////////////////////////////////
+      //display full name of OpenDAP URL or just last component of local file
+      /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+      QString file_name;
+      if(is_url(m_sl_recent_files[j]))
+      {
+        file_name = m_sl_recent_files[j];
+      }
+      else
+      {
+        file_name = last_component(m_sl_recent_files[j]);
+      }
+      QString text = tr("&%1 %2")
+        .arg(j + 1)
+        .arg(file_name);
+      m_action_recent_file[j]->setText(text);
+      m_action_recent_file[j]->setData(m_sl_recent_files[j]);
+      m_action_recent_file[j]->setVisible(true);
+    }
+    else
+    {
+      m_action_recent_file[j]->setVisible(false);
+    }
+  }
+  m_action_separator_recent->setVisible(!m_sl_recent_files.isEmpty());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::set_current_file
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::set_current_file(const QString &file_name)
+{
+  m_str_current_file = file_name;
+
+  QString shownName = tr("Untitled");
+  if(!m_str_current_file.isEmpty())
+  {
+    shownName = last_component(m_str_current_file);
+    m_sl_recent_files.removeAll(m_str_current_file);
+    m_sl_recent_files.prepend(m_str_current_file);
+    update_recent_file_actions();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::open_file
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::open_file()
+{
+  QStringList file_names = QFileDialog::getOpenFileNames(this,
+    tr("Open Files"), ".",
+    tr("netCDF Files (*.nc);;All files (*.*)"));
+
+  if(file_names.isEmpty())
+    return;
+
+  this->read_files(file_names);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::open_dap
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::open_dap()
+{
+  QInputDialog dlg(this);
+  dlg.setInputMode(QInputDialog::TextInput);
+  dlg.setLabelText("DAP url");
+  dlg.resize(QSize(400, 60));
+  if(QDialog::Accepted == dlg.exec())
+  {
+    QString file_name = dlg.textValue();
+    this->read_file(file_name);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::open_recent_file
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::open_recent_file()
+{
+  QAction *action = qobject_cast<QAction *>(sender());
+  if(action)
+  {
+    read_file(action->data().toString());
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//walk_node_t
+//metadata of a group or a variable, as found by a walk of a file
+///////////////////////////////////////////////////////////////////////////////////////
+
+class walk_node_t
+{
+public:
+  walk_node_t() :
+    m_kind(ItemData::Group),
+    m_parent(-1),
+    m_nc_type(NC_NAT),
+    m_rowid_first(-1),
+    m_has_fill(false),
+    m_fill_value(0)
+  {
+  }
+  int m_kind; // ItemData::Group or ItemData::Variable
+  int m_parent; // index of the node of the parent group (-1 for the root group)
+  std::string m_name;
+  std::string m_grp_nm_fll; // full name of the group (of the variable)
+  nc_type m_nc_type;
+  std::vector<ncdim_t> m_ncdim;
+  std::vector<std::string> m_dmn_nm; // (group) dimension names
+  std::vector<std::string> m_att_nm; // attribute names (column names of an SQLite table)
+  long long m_rowid_first; // (SQLite table) first rowid, -1 if rows are not keyed by rowid
+  bool m_has_fill; // (HDF5 dataset) fill value found
+  double m_fill_value; // (HDF5 dataset) fill value
+  std::string m_meta; // (Zarr array) .zarray metadata (JSON)
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+//walk_node_t serialization
+//nodes written by a walk worker process to its standard output
+///////////////////////////////////////////////////////////////////////////////////////
+
+QDataStream& operator<<(QDataStream &out, const walk_node_t &node)
+{
+  out << (qint32)node.m_kind << (qint32)node.m_parent << QByteArray(node.m_name.c_str())
+    << QByteArray(node.m_grp_nm_fll.c_str()) << (qint32)node.m_nc_type << (quint32)node.m_ncdim.size();
+  for(size_t idx_dmn = 0; idx_dmn < node.m_ncdim.size(); idx_dmn++)
+  {
+    out << QByteArray(node.m_ncdim[idx_dmn].m_name.c_str()) << (quint64)node.m_ncdim[idx_dmn].m_size;
+  }
+  out << (quint32)node.m_dmn_nm.size();
+  for(size_t idx = 0; idx < node.m_dmn_nm.size(); idx++)
+  {
+    out << QByteArray(node.m_dmn_nm[idx].c_str());
+  }
+  out << (quint32)node.m_att_nm.size();
+  for(size_t idx = 0; idx < node.m_att_nm.size(); idx++)
+  {
+    out << QByteArray(node.m_att_nm[idx].c_str());
+  }
+  out << (qint64)node.m_rowid_first << node.m_has_fill << node.m_fill_value << QByteArray(node.m_meta.c_str());
+  return out;
+}
+
+QDataStream& operator>>(QDataStream &in, walk_node_t &node)
+{
+  qint32 kind, parent, nc_type_int;
+  quint32 nbr;
+  quint64 size;
+  QByteArray name;
+  QByteArray grp_nm_fll;
+  in >> kind >> parent >> name >> grp_nm_fll >> nc_type_int >> nbr;
+  node.m_kind = kind;
+  node.m_parent = parent;
+  node.m_name = name.constData();
+  node.m_grp_nm_fll = grp_nm_fll.constData();
+  node.m_nc_type = nc_type_int;
+  for(quint32 idx = 0; idx < nbr && in.status() == QDataStream::Ok; idx++)
+  {
+    in >> name >> size;
+    node.m_ncdim.push_back(ncdim_t(name.constData(), (size_t)size));
+  }
+  in >> nbr;
+  for(quint32 idx = 0; idx < nbr && in.status() == QDataStream::Ok; idx++)
+  {
+    in >> name;
+    node.m_dmn_nm.push_back(name.constData());
+  }
+  in >> nbr;
+  for(quint32 idx = 0; idx < nbr && in.status() == QDataStream::Ok; idx++)
+  {
+    in >> name;
+    node.m_att_nm.push_back(name.constData());
+  }
+  qint64 rowid_first;
+  in >> rowid_first >> node.m_has_fill >> node.m_fill_value >> name;
+  node.m_rowid_first = rowid_first;
+  node.m_meta = name.constData();
+  return in;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//walk_t
+//walk of the metadata of a file; nodes are produced in tree order (a group, its variables, then
+//its sub-groups) and taken in batches by the UI thread, which adds the tree items while the walk
+//goes on
+//the walk runs on a worker thread, or in a worker process (this program with --walk) when many
+//files are opened together: the library is not thread safe, so threads of one process walk one
+//group at a time, while processes walk their files in parallel
+///////////////////////////////////////////////////////////////////////////////////////
+
+class walk_t
+{
+public:
+  walk_t(const std::string &file_name, QTreeWidgetItem *root, bool use_worker) :
+    m_file_name(file_name),
+    m_root(root),
+    m_use_worker(use_worker),
+    m_process(NULL),
+    m_started(false),
+    m_done(false),
+    m_crashed(false),
+    m_status(NC_NOERR),
+    m_source(ItemData::SourceNetCDF),
+    m_cancel(false)
+  {
+  }
+  ~walk_t()
+  {
+    m_cancel = true;
+    if(m_thread.joinable())
+    {
+      m_thread.join();
+    }
+    if(m_process != NULL)
+    {
+      m_process->kill();
+      m_process->waitForFinished();
+      delete m_process;
+    }
+  }
+
+  void start()
+  {
+    m_started = true;
+    if(!m_use_worker)
+    {
+      m_thread = std::thread(&walk_t::run, this);
+      return;
+    }
+    m_process = new QProcess;
+    m_process->start(QCoreApplication::applicationFilePath(),
+      QStringList() << "--walk" << QString::fromStdString(m_file_name));
+  }
+
+  bool started() const
+  {
+    return m_started;
+  }
+
+  //library that reads the file (known before the first node is taken)
+  int source()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_source;
+  }
+
+  //worker process still walking
+  bool running() const
+  {
+    return m_process != NULL;
+  }
+
+  //the worker process crashed or its output is not a walk (the file is not walked in process, where
+  //it could crash the program too)
+  bool crashed()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_crashed;
+  }
+
+  //take up to 'max_nodes' nodes; 'done' when the walk ended and all nodes were taken
+  void take(std::vector<walk_node_t> &nodes, size_t max_nodes, bool &done, int &status)
+  {
+    if(m_process != NULL)
+    {
+      poll_process();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t nbr = std::min(max_nodes, m_nodes.size());
+    nodes.assign(std::make_move_iterator(m_nodes.begin()), std::make_move_iterator(m_nodes.begin() + nbr));
+    m_nodes.erase(m_nodes.begin(), m_nodes.begin() + nbr);
+    done = m_done && m_nodes.empty();
+    status = m_status;
+  }
+
+  //walk on the calling thread
+  void run()
+  {
+    int nc_id;
+    int status;
+    {
+      perf_timer_t timer(perf_t::Open, m_file_name);
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      status = nc_open(m_file_name.c_str(), NC_NOWRITE, &nc_id);
+    }
+    if(status == NC_NOERR)
+    {
+      int nbr_nodes = 0;
+      walk_group(nc_id, -1, nbr_nodes);
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      nc_close(nc_id);
+    }
+#ifdef HAVE_HDF5
+    else if(walk_hdf5() == NC_NOERR)
+    {
+      status = NC_NOERR;
+    }
+#endif
+#ifdef HAVE_SQLITE
+    else if(walk_sqlite() == NC_NOERR)
+    {
+      status = NC_NOERR;
+    }
+#endif
+#ifdef HAVE_ZARR
+    else if(walk_zarr() == NC_NOERR)
+    {
+      status = NC_NOERR;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_status = status;
+    m_done = true;
+  }
+
+  //write the walked nodes (after run) to a stream, as a worker process
+  void write(QDataStream &out)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << (qint32)m_status << (qint32)m_source << (quint32)m_nodes.size();
+    for(size_t idx_nod = 0; idx_nod < m_nodes.size(); idx_nod++)
+    {
+      out << m_nodes[idx_nod];
+    }
+  }
+
+  std::string m_file_name;
+  QTreeWidgetItem *m_root;
+  bool m_use_worker; // walk in a worker process (not on a thread)
+  std::vector<QTreeWidgetItem*> m_items; // tree items of the taken nodes, by node index (UI thread)
+
+private:
+
+  //read the output of a finished worker process; a worker that cannot be started is replaced by a
+  //walk on a thread, one that crashes or writes something else than a walk fails the walk
+  void poll_process()
+  {
+    m_output += m_process->readAllStandardOutput();
+    if(m_process->state() != QProcess::NotRunning)
+    {
+      return;
+    }
+    m_output += m_process->readAllStandardOutput();
+    bool started = m_process->error() != QProcess::FailedToStart;
+    bool ok = started && m_process->exitStatus() == QProcess::NormalExit;
+    delete m_process;
+    m_process = NULL;
+    if(!started)
+    {
+      m_output.clear();
+      m_use_worker = false;
+      start();
+      return;
+    }
+
+    QDataStream in(m_output);
+    qint32 status = NC2_ERR;
+    qint32 source = ItemData::SourceNetCDF;
+    quint32 nbr = 0;
+    std::deque<walk_node_t> nodes;
+    if(ok)
+    {
+      in >> status >> source >> nbr;
+      for(quint32 idx_nod = 0; idx_nod < nbr && in.status() == QDataStream::Ok; idx_nod++)
+      {
+        nodes.push_back(walk_node_t());
+        in >> nodes.back();
+      }
+      ok = in.status() == QDataStream::Ok;
+    }
+    m_output.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!ok)
+    {
+      m_status = NC2_ERR;
+      m_crashed = true;
+      m_done = true;
+      return;
+    }
+    m_nodes.swap(nodes);
+    m_status = status;
+    m_source = source;
+    m_done = true;
+  }
+
+  //nodes of a group and of its variables, then of its sub-groups; the library lock is held for one
+  //group at a time, so that reads of other threads are not stalled by a whole walk
+  void walk_group(const int grp_id, const int parent, int &nbr_nodes)
+  {
+    char name[NC_MAX_NAME + 1];
+    int nbr_att; // number of attributes
+    int nbr_dmn_grp; // number of dimensions for group
+    int nbr_var; // number of variables
+    int nbr_grp = 0; // number of sub-groups in this group
+    int nbr_dmn_var; // number of dimensions for variable
+    int var_dimid[NC_MAX_VAR_DIMS]; // dimensions for variable
+    size_t dmn_sz; // dimension size
+    size_t grp_nm_lng; //lenght of full group name
+    std::vector<walk_node_t> nodes(1);
+    std::vector<int> grp_ids;
+
+    if(m_cancel)
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      walk_node_t &grp = nodes[0];
+      grp.m_parent = parent;
+      if(nc_inq_grpname_full(grp_id, &grp_nm_lng, NULL) == NC_NOERR)
+      {
+        std::vector<char> grp_nm_fll(grp_nm_lng + 1);
+        if(nc_inq_grpname_full(grp_id, &grp_nm_lng, &grp_nm_fll[0]) == NC_NOERR)
+        {
+          grp.m_grp_nm_fll = &grp_nm_fll[0];
+        }
+      }
+      if(nc_inq_grpname(grp_id, name) == NC_NOERR)
+      {
+        grp.m_name = name;
+      }
+      if(nc_inq(grp_id, &nbr_dmn_grp, &nbr_var, &nbr_att, (int *)NULL) != NC_NOERR)
+      {
+        nbr_dmn_grp = nbr_var = nbr_att = 0;
+      }
+      attribute_names(grp_id, NC_GLOBAL, nbr_att, grp.m_att_nm);
+
+      std::vector<int> dmn_ids(nbr_dmn_grp);
+      if(nbr_dmn_grp && nc_inq_dimids(grp_id, &nbr_dmn_grp, &dmn_ids[0], 0) == NC_NOERR)
+      {
+        for(int idx_dmn = 0; idx_dmn < nbr_dmn_grp; idx_dmn++)
+        {
+          if(nc_inq_dimname(grp_id, dmn_ids[idx_dmn], name) == NC_NOERR)
+          {
+            grp.m_dmn_nm.push_back(name);
+          }
+        }
+      }
+
+      for(int idx_var = 0; idx_var < nbr_var; idx_var++)
+      {
+        walk_node_t var;
+        var.m_kind = ItemData::Variable;
+        var.m_grp_nm_fll = nodes[0].m_grp_nm_fll;
+        if(nc_inq_var(grp_id, idx_var, name, &var.m_nc_type, &nbr_dmn_var, var_dimid, &nbr_att) != NC_NOERR)
+        {
+          continue;
+        }
+        var.m_name = name;
+
+        //dimensions belong to groups
+        for(int idx_dmn = 0; idx_dmn < nbr_dmn_var; idx_dmn++)
+        {
+          if(nc_inq_dim(grp_id, var_dimid[idx_dmn], name, &dmn_sz) != NC_NOERR)
+          {
+            name[0] = '\0';
+            dmn_sz = 0;
+          }
+          var.m_ncdim.push_back(ncdim_t(name, dmn_sz));
+        }
+        attribute_names(grp_id, idx_var, nbr_att, var.m_att_nm);
+        nodes.push_back(var);
+      }
+
+      if(nc_inq_grps(grp_id, &nbr_grp, (int *)NULL) == NC_NOERR && nbr_grp)
+      {
+        grp_ids.resize(nbr_grp);
+        if(nc_inq_grps(grp_id, &nbr_grp, &grp_ids[0]) != NC_NOERR)
+        {
+          grp_ids.clear();
+        }
+      }
+    }
+
+    //variables have the group node as parent
+    int idx_grp = nbr_nodes;
+    for(size_t idx_nod = 1; idx_nod < nodes.size(); idx_nod++)
+    {
+      nodes[idx_nod].m_parent = idx_grp;
+    }
+    nbr_nodes += (int)nodes.size();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(size_t idx_nod = 0; idx_nod < nodes.size(); idx_nod++)
+      {
+        m_nodes.push_back(std::move(nodes[idx_nod]));
+      }
+    }
+
+    for(size_t idx_grp_sub = 0; idx_grp_sub < grp_ids.size(); idx_grp_sub++)
+    {
+      walk_group(grp_ids[idx_grp_sub], idx_grp, nbr_nodes);
+    }
+  }
+
+#ifdef HAVE_HDF5
+
+  //HDF5 file that is not readable as netCDF: datasets become variables; HDF5 dimensions have no
+  //names, so they are named by size in a group as the netCDF library does ("phony_dim_N"): the
+  //datasets of a group share the names of a size, and a size repeated in a dataset (a square grid)
+  //takes one more name per occurrence
+  int walk_hdf5()
+  {
+    hid_t fid;
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      if(H5Fis_hdf5(m_file_name.c_str()) <= 0)
+      {
+        return NC2_ERR;
+      }
+      fid = H5Fopen(m_file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    }
+    if(fid < 0)
+    {
+      return NC2_ERR;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_source = ItemData::SourceHDF5;
+    }
+    int nbr_nodes = 0;
+    int nbr_phony = 0;
+    walk_hdf5_group(fid, "/", "/", -1, nbr_nodes, nbr_phony);
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    H5Fclose(fid);
+    return NC_NOERR;
+  }
+
+  static herr_t hdf5_name(hid_t, const char *name, const H5L_info_t*, void *data)
+  {
+    static_cast<std::vector<std::string>*>(data)->push_back(name);
+    return 0;
+  }
+
+  static herr_t hdf5_attribute_name(hid_t, const char *name, const H5A_info_t*, void *data)
+  {
+    static_cast<std::vector<std::string>*>(data)->push_back(name);
+    return 0;
+  }
+
+  //fill value of a dataset: its _FillValue attribute (one number), otherwise the fill value set when it was
+  //created; called with the library lock held
+  static void hdf5_fill_value(hid_t did, walk_node_t &var)
+  {
+    H5E_BEGIN_TRY
+    {
+      hid_t aid = H5Aexists(did, "_FillValue") > 0 ? H5Aopen(did, "_FillValue", H5P_DEFAULT) : -1;
+      if(aid >= 0)
+      {
+        hid_t sid = H5Aget_space(aid);
+        var.m_has_fill = H5Sget_simple_extent_npoints(sid) == 1 && H5Aread(aid, H5T_NATIVE_DOUBLE, &var.m_fill_value) >= 0;
+        H5Sclose(sid);
+        H5Aclose(aid);
+      }
+      if(!var.m_has_fill)
+      {
+        hid_t dcpl = H5Dget_create_plist(did);
+        H5D_fill_value_t defined;
+        var.m_has_fill = H5Pfill_value_defined(dcpl, &defined) >= 0 && defined == H5D_FILL_VALUE_USER_DEFINED &&
+          H5Pget_fill_value(dcpl, H5T_NATIVE_DOUBLE, &var.m_fill_value) >= 0;
+        H5Pclose(dcpl);
+      }
+    }
+    H5E_END_TRY;
+  }
+
+  void walk_hdf5_group(const hid_t fid, const std::string &grp_nm_fll, const std::string &grp_nm, const int parent,
+    int &nbr_nodes, int &nbr_phony)
+  {
+    std::vector<walk_node_t> nodes(1);
+    std::vector<std::string> names;
+    std::vector<std::string> grp_names; // sub-groups
+    std::map<hsize_t, std::vector<std::string> > phony; // dimension names by size
+    std::string prefix = (grp_nm_fll == "/") ? grp_nm_fll : grp_nm_fll + "/";
+
+    if(m_cancel)
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      hid_t gid = H5Gopen2(fid, grp_nm_fll.c_str(), H5P_DEFAULT);
+      if(gid < 0)
+      {
+        return;
+      }
+      walk_node_t &grp = nodes[0];
+      grp.m_parent = parent;
+      grp.m_name = grp_nm;
+      grp.m_grp_nm_fll = grp_nm_fll;
+      H5Aiterate2(gid, H5_INDEX_NAME, H5_ITER_INC, NULL, hdf5_attribute_name, &grp.m_att_nm);
+      H5Literate(gid, H5_INDEX_NAME, H5_ITER_INC, NULL, hdf5_name, &names);
+
+      for(size_t idx_obj = 0; idx_obj < names.size(); idx_obj++)
+      {
+        hid_t oid = H5Oopen(gid, names[idx_obj].c_str(), H5P_DEFAULT);
+        if(oid < 0)
+        {
+          continue;
+        }
+        if(H5Iget_type(oid) == H5I_GROUP)
+        {
+          grp_names.push_back(names[idx_obj]);
+        }
+        else if(H5Iget_type(oid) == H5I_DATASET)
+        {
+          walk_node_t var;
+          hid_t tid = H5Dget_type(oid);
+          hid_t sid = H5Dget_space(oid);
+          int rank = H5Sget_simple_extent_ndims(sid);
+          std::vector<hsize_t> dims(std::max(rank, 0));
+          var.m_kind = ItemData::Variable;
+          var.m_name = names[idx_obj];
+          var.m_grp_nm_fll = grp_nm_fll;
+          var.m_nc_type = hdf5_nc_type(tid);
+          if(rank > 0)
+          {
+            H5Sget_simple_extent_dims(sid, &dims[0], NULL);
+          }
+          std::map<hsize_t, size_t> used; // names of a size taken by the dataset
+          for(int idx_dmn = 0; idx_dmn < rank; idx_dmn++)
+          {
+            std::vector<std::string> &names_sz = phony[dims[idx_dmn]];
+            size_t idx_nm = used[dims[idx_dmn]]++;
+            if(idx_nm == names_sz.size())
+            {
+              std::ostringstream name;
+              name << "phony_dim_" << nbr_phony++;
+              names_sz.push_back(name.str());
+              grp.m_dmn_nm.push_back(name.str());
+            }
+            var.m_ncdim.push_back(ncdim_t(names_sz[idx_nm].c_str(), (size_t)dims[idx_dmn]));
+          }
+          H5Aiterate2(oid, H5_INDEX_NAME, H5_ITER_INC, NULL, hdf5_attribute_name, &var.m_att_nm);
+          if(is_numeric(var.m_nc_type))
+          {
+            hdf5_fill_value(oid, var);
+          }
+          H5Sclose(sid);
+          H5Tclose(tid);
+          //types without a netCDF equivalent (compound, reference, ...) are not shown
+          if(var.m_nc_type != NC_NAT)
+          {
+            nodes.push_back(var);
+          }
+        }
+        H5Oclose(oid);
+      }
+      H5Gclose(gid);
+    }
+
+    int idx_grp = nbr_nodes;
+    for(size_t idx_nod = 1; idx_nod < nodes.size(); idx_nod++)
+    {
+      nodes[idx_nod].m_parent = idx_grp;
+    }
+    nbr_nodes += (int)nodes.size();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(size_t idx_nod = 0; idx_nod < nodes.size(); idx_nod++)
+      {
+        m_nodes.push_back(std::move(nodes[idx_nod]));
+      }
+    }
+
+    for(size_t idx_grp_sub = 0; idx_grp_sub < grp_names.size(); idx_grp_sub++)
+    {
+      walk_hdf5_group(fid, prefix + grp_names[idx_grp_sub], grp_names[idx_grp_sub], idx_grp, nbr_nodes, nbr_phony);
+    }
+  }
+
+#endif
+
+#ifdef HAVE_SQLITE
+
+  //SQLite database: tables and views become two-dimensional (rows, columns) string variables of
+  //the root group, their column names are indexed as attributes; a rowid table spans its rowid
+  //range (min and max rowid are two b-tree lookups, so that a table of any size opens at once),
+  //views and tables without rowid have rows only as they are fetched
+  int walk_sqlite()
+  {
+    sqlite3 *db = NULL;
+    sqlite3_stmt *stmt;
+    std::vector<walk_node_t> nodes(1);
+
+    if(!is_sqlite_file(m_file_name))
+    {
+      return NC2_ERR;
+    }
+    if(sqlite3_open_v2(m_file_name.c_str(), &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK)
+    {
+      sqlite3_close(db);
+      return NC2_ERR;
+    }
+    nodes[0].m_name = "/";
+    nodes[0].m_grp_nm_fll = "/";
+    nodes[0].m_dmn_nm.push_back("rows");
+    nodes[0].m_dmn_nm.push_back("columns");
+
+    const char *sql = "SELECT name, type FROM sqlite_master WHERE type IN ('table', 'view') "
+      "AND name NOT LIKE 'sqlite_%' ORDER BY name";
+    if(sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK)
+    {
+      while(sqlite3_step(stmt) == SQLITE_ROW && !m_cancel)
+      {
+        walk_node_t var;
+        var.m_kind = ItemData::Variable;
+        var.m_parent = 0;
+        var.m_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        var.m_grp_nm_fll = "/";
+        var.m_nc_type = NC_STRING;
+        bool table = strcmp(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)), "table") == 0;
+        size_t nbr_rows = 0;
+
+        sqlite3_stmt *stmt_info;
+        std::string sql_info = "PRAGMA table_info(" + sql_quote(var.m_name) + ")";
+        if(sqlite3_prepare_v2(db, sql_info.c_str(), -1, &stmt_info, NULL) == SQLITE_OK)
+        {
+          while(sqlite3_step(stmt_info) == SQLITE_ROW)
+          {
+            var.m_att_nm.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt_info, 1)));
+          }
+          sqlite3_finalize(stmt_info);
+        }
+
+        //preparing fails for tables without rowid
+        sqlite3_stmt *stmt_rowid;
+        std::string sql_rowid = "SELECT min(rowid), max(rowid) FROM " + sql_quote(var.m_name);
+        if(table && sqlite3_prepare_v2(db, sql_rowid.c_str(), -1, &stmt_rowid, NULL) == SQLITE_OK)
+        {
+          var.m_rowid_first = 0;
+          if(sqlite3_step(stmt_rowid) == SQLITE_ROW && sqlite3_column_type(stmt_rowid, 0) != SQLITE_NULL)
+          {
+            var.m_rowid_first = sqlite3_column_int64(stmt_rowid, 0);
+            nbr_rows = (size_t)(sqlite3_column_int64(stmt_rowid, 1) - var.m_rowid_first + 1);
+          }
+          sqlite3_finalize(stmt_rowid);
+        }
+        var.m_ncdim.push_back(ncdim_t("rows", nbr_rows));
+        var.m_ncdim.push_back(ncdim_t("columns", var.m_att_nm.size()));
+        nodes.push_back(var);
+      }
+      sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(size_t idx_nod = 0; idx_nod < nodes.size(); idx_nod++)
+    {
+      m_nodes.push_back(std::move(nodes[idx_nod]));
+    }
+    m_source = ItemData::SourceSQLite;
+    return NC_NOERR;
+  }
+
+#endif
+
+#ifdef HAVE_ZARR
+
+  //Zarr (version 2) directory store: groups are directories with a .zgroup, arrays directories with a
+  //.zarray; dimension names are the xarray "_ARRAY_DIMENSIONS" attribute of an array, otherwise they
+  //are named by size in a group as for HDF5 ("phony_dim_N", one more per repeat of a size in an
+  //array); consolidated metadata (.zmetadata), when the
+  //store has it, gives the whole hierarchy in one read
+  int walk_zarr()
+  {
+    QString dir = QString::fromStdString(m_file_name);
+    QJsonObject consolidated;
+    QJsonObject obj;
+    if(zarr_json(dir, consolidated, ".zmetadata", obj))
+    {
+      consolidated = obj.value("metadata").toObject();
+    }
+    if(!zarr_json(dir, consolidated, ".zgroup", obj))
+    {
+      return NC2_ERR;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_source = ItemData::SourceZarr;
+    }
+    int nbr_nodes = 0;
+    int nbr_phony = 0;
+    walk_zarr_group(dir, consolidated, "/", "/", -1, nbr_nodes, nbr_phony);
+    return NC_NOERR;
+  }
+
+  //metadata document 'key' (path relative to the store), from the consolidated metadata if there is one
+  static bool zarr_json(const QString &dir, const QJsonObject &consolidated, const QString &key, QJsonObject &obj)
+  {
+    if(!consolidated.isEmpty())
+    {
+      obj = consolidated.value(key).toObject();
+      return consolidated.contains(key);
+    }
+    QFile file(dir + "/" + key);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      return false;
+    }
+    obj = QJsonDocument::fromJson(file.readAll()).object();
+    return true;
+  }
+
+  void walk_zarr_group(const QString &dir, const QJsonObject &consolidated, const std::string &grp_nm_fll,
+    const std::string &grp_nm, const int parent, int &nbr_nodes, int &nbr_phony)
+  {
+    std::vector<walk_node_t> nodes(1);
+    QStringList names;
+    std::vector<std::string> grp_names; // sub-groups
+    std::map<size_t, std::vector<std::string> > phony; // dimension names by size
+    std::set<std::string> dmn_nm;
+    QString prefix = (grp_nm_fll == "/") ? QString() : QString::fromStdString(grp_nm_fll.substr(1)) + "/";
+    QJsonObject obj;
+
+    if(m_cancel)
+    {
+      return;
+    }
+
+    walk_node_t &grp = nodes[0];
+    grp.m_parent = parent;
+    grp.m_name = grp_nm;
+    grp.m_grp_nm_fll = grp_nm_fll;
+    if(zarr_json(dir, consolidated, prefix + ".zattrs", obj))
+    {
+      for(QJsonObject::const_iterator it = obj.constBegin(); it != obj.constEnd(); ++it)
+      {
+        grp.m_att_nm.push_back(it.key().toStdString());
+      }
+    }
+
+    //members: the directories of the group, or the keys one level below it
+    if(consolidated.isEmpty())
+    {
+      names = QDir(dir + "/" + prefix).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    }
+    else
+    {
+      for(QJsonObject::const_iterator it = consolidated.constBegin(); it != consolidated.constEnd(); ++it)
+      {
+        QString key = it.key();
+        if(key.startsWith(prefix) && (key.endsWith("/.zarray") || key.endsWith("/.zgroup")) &&
+          key.count('/') == prefix.count('/') + 1)
+        {
+          names << key.mid(prefix.size(), key.lastIndexOf('/') - prefix.size());
+        }
+      }
+      names.sort();
+      names.removeDuplicates();
+    }
+
+    for(int idx_obj = 0; idx_obj < names.size(); idx_obj++)
+    {
+      QString path = prefix + names[idx_obj] + "/";
+      if(zarr_json(dir, consolidated, path + ".zgroup", obj))
+      {
+        grp_names.push_back(names[idx_obj].toStdString());
+        continue;
+      }
+      if(!zarr_json(dir, consolidated, path + ".zarray", obj))
+      {
+        continue;
+      }
+      walk_node_t var;
+      QJsonArray shape = obj.value("shape").toArray();
+      QJsonArray dims;
+      var.m_kind = ItemData::Variable;
+      var.m_name = names[idx_obj].toStdString();
+      var.m_grp_nm_fll = grp_nm_fll;
+      var.m_nc_type = zarr_array_t::dtype_nc_type(obj.value("dtype").toString().toStdString());
+      var.m_meta = QJsonDocument(obj).toJson(QJsonDocument::Compact).constData();
+      if(zarr_json(dir, consolidated, path + ".zattrs", obj))
+      {
+        dims = obj.value("_ARRAY_DIMENSIONS").toArray();
+        for(QJsonObject::const_iterator it = obj.constBegin(); it != obj.constEnd(); ++it)
+        {
+          if(it.key() != "_ARRAY_DIMENSIONS")
+          {
+            var.m_att_nm.push_back(it.key().toStdString());
+          }
+        }
+      }
+      std::map<size_t, size_t> used; // names of a size taken by the array
+      for(int idx_dmn = 0; idx_dmn < shape.size(); idx_dmn++)
+      {
+        size_t size = (size_t)shape[idx_dmn].toDouble();
+        std::string name;
+        if(dims.size() == shape.size())
+        {
+          name = dims[idx_dmn].toString().toStdString();
+        }
+        else
+        {
+          std::vector<std::string> &names_sz = phony[size];
+          size_t idx_nm = used[size]++;
+          if(idx_nm == names_sz.size())
+          {
+            std::ostringstream str;
+            str << "phony_dim_" << nbr_phony++;
+            names_sz.push_back(str.str());
+          }
+          name = names_sz[idx_nm];
+        }
+        if(dmn_nm.insert(name).second)
+        {
+          grp.m_dmn_nm.push_back(name);
+        }
+        var.m_ncdim.push_back(ncdim_t(name.c_str(), size));
+      }
+      //dtypes without a netCDF equivalent (structured, unicode, ...) are not shown
+      if(var.m_nc_type != NC_NAT)
+      {
+        nodes.push_back(var);
+      }
+    }
+
+    int idx_grp = nbr_nodes;
+    for(size_t idx_nod = 1; idx_nod < nodes.size(); idx_nod++)
+    {
+      nodes[idx_nod].m_parent = idx_grp;
+    }
+    nbr_nodes += (int)nodes.size();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for(size_t idx_nod = 0; idx_nod < nodes.size(); idx_nod++)
+      {
+        m_nodes.push_back(std::move(nodes[idx_nod]));
+      }
+    }
+
+    std::string grp_prefix = (grp_nm_fll == "/") ? grp_nm_fll : grp_nm_fll + "/";
+    for(size_t idx_grp_sub = 0; idx_grp_sub < grp_names.size(); idx_grp_sub++)
+    {
+      walk_zarr_group(dir, consolidated, grp_prefix + grp_names[idx_grp_sub], grp_names[idx_grp_sub], idx_grp,
+        nbr_nodes, nbr_phony);
+    }
+  }
+
+#endif
+
+  void attribute_names(const int grp_id, const int var_id, const int nbr_att, std::vector<std::string> &names)
+  {
+    char att_nm[NC_MAX_NAME + 1]; // attribute name
+    for(int idx_att = 0; idx_att < nbr_att; idx_att++)
+    {
+      if(nc_inq_attname(grp_id, var_id, idx_att, att_nm) == NC_NOERR)
+      {
+        names.push_back(att_nm);
+      }
+    }
+  }
+
+  QProcess *m_process; // worker process (NULL if not running)
+  QByteArray m_output; // output of the worker process
+  bool m_started;
+  std::mutex m_mutex;
+  std::deque<walk_node_t> m_nodes; // produced nodes not taken yet
+  bool m_done;
+  bool m_crashed; // the worker process crashed or wrote something else than a walk
+  int m_status; // nc_open result
+  int m_source; // ItemData::Source of the file
+  std::atomic<bool> m_cancel;
+  std::thread m_thread;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+//walk_worker
+//worker process (--walk): walk the metadata of a file and write the nodes to standard output
+///////////////////////////////////////////////////////////////////////////////////////
+
+int walk_worker(const char *file_name)
+{
+  walk_t walk(file_name, NULL, false);
+  QFile file;
+  walk.run();
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  if(!file.open(stdout, QIODevice::WriteOnly))
+  {
+    return 1;
+  }
+  QDataStream out(&file);
+  walk.write(out);
+  file.flush();
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//reader_worker
+//worker process (--reader) of the reader pool: read the requested hyperslabs into the shared memory
+//segment named by each request, answering with the read status; files stay open between requests,
+//and each variable keeps its item (dimension sizes sent with the request, direct chunk reads; it has
+//no window, so no inflated chunks are kept); the end of the input (the application exited) ends the worker
+///////////////////////////////////////////////////////////////////////////////////////
+
+int reader_worker()
+{
+  std::map<std::string, ncfile_t*> files; // open files by file and group name
+  std::map<std::string, ItemData*> items; // variables read by file, group and variable name
+  QSharedMemory shm;
+  quint32 len;
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  while(fread(&len, sizeof(len), 1, stdin) == 1)
+  {
+    QByteArray block(len, '\0');
+    if(fread(block.data(), 1, len, stdin) != len)
+    {
+      break;
+    }
+    QByteArray key;
+    QByteArray request;
+    QByteArray file_name;
+    QByteArray grp_nm_fll;
+    QByteArray var_nm;
+    qint32 source;
+    qint32 nc_type_int;
+    qint32 dim_step;
+    QVector<quint64> q_dim;
+    QVector<quint64> q_start;
+    QVector<quint64> q_count;
+    QDataStream in(block);
+    in >> key >> request;
+    QDataStream in_request(request);
+    in_request >> file_name >> grp_nm_fll >> var_nm >> source >> nc_type_int >> q_dim >> dim_step >> q_start >> q_count;
+
+    qint32 status = NC2_ERR;
+    shm.setKey(QString::fromUtf8(key));
+    if(shm.isAttached() || shm.attach())
+    {
+      std::string file_key = std::string(file_name.constData()) + "\n" + grp_nm_fll.constData();
+      ncfile_t *&file = files[file_key];
+      if(file == NULL)
+      {
+        file = new ncfile_t;
+      }
+      //dimension names are not needed to read
+      ItemData *&item_data = items[file_key + "\n" + var_nm.constData()];
+      if(item_data == NULL)
+      {
+        std::vector<ncdim_t> ncdim;
+        for(int idx_dmn = 0; idx_dmn < q_dim.size(); idx_dmn++)
+        {
+          ncdim.push_back(ncdim_t("", (size_t)q_dim[idx_dmn]));
+        }
+        item_data = new ItemData(ItemData::Variable, file_name.constData(), grp_nm_fll.constData(), var_nm.constData(),
+          (ItemData*)NULL, new ncvar_t(var_nm.constData(), nc_type_int, ncdim), (grid_policy_t*)NULL);
+        item_data->m_source = source;
+      }
+      item_data->m_dim_step = dim_step;
+      std::vector<size_t> start(q_start.begin(), q_start.end());
+      std::vector<size_t> count(q_count.begin(), q_count.end());
+      status = read_hyperslab(item_data, *file, start, count, shm.data());
+    }
+    fwrite(&status, sizeof(status), 1, stdout);
+    fflush(stdout);
+  }
+  for(std::map<std::string, ItemData*>::iterator it = items.begin(); it != items.end(); ++it)
+  {
+    delete it->second;
+  }
+  for(std::map<std::string, ncfile_t*>::iterator it = files.begin(); it != files.end(); ++it)
+  {
+    delete it->second;
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//batch_variable
+//item of a variable given by its full name, for the command line modes; NULL (and the reason
+//printed to 'out') if the file or the variable cannot be opened
+///////////////////////////////////////////////////////////////////////////////////////
+
+ItemData* batch_variable(const QString &file_name, const QString &var_nm_fll, QTextStream &out)
+{
+  ncfile_t file;
+  std::string var_path = var_nm_fll.toStdString();
+  size_t pos = var_path.rfind('/');
+  std::string grp_nm_fll = (pos == std::string::npos || pos == 0) ? "/" : var_path.substr(0, pos);
+  std::string var_nm = (pos == std::string::npos) ? var_path : var_path.substr(pos + 1);
+  std::vector<ncdim_t> ncdim;
+  nc_type var_type;
+  int var_id;
+  int nbr_dmn;
+  int dim_ids[NC_MAX_VAR_DIMS];
+
+  if(file.open(file_name.toStdString(), grp_nm_fll) != NC_NOERR)
+  {
+    out << "cannot open " << file_name << "\n";
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  if(nc_inq_varid(file.m_grp_id, var_nm.c_str(), &var_id) != NC_NOERR ||
+    nc_inq_var(file.m_grp_id, var_id, NULL, &var_type, &nbr_dmn, dim_ids, NULL) != NC_NOERR)
+  {
+    out << "no variable " << var_nm_fll << "\n";
+    return NULL;
+  }
+  for(int idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    char dmn_nm[NC_MAX_NAME + 1];
+    size_t size;
+    nc_inq_dim(file.m_grp_id, dim_ids[idx_dmn], dmn_nm, &size);
+    ncdim.push_back(ncdim_t(dmn_nm, size));
+  }
+  return new ItemData(ItemData::Variable, file_name.toStdString(), grp_nm_fll, var_nm, (ItemData*)NULL,
+    new ncvar_t(var_nm.c_str(), var_type, ncdim), (grid_policy_t*)NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//read_benchmark
+//--read-benchmark: read all the slices of a variable along its first dimension on all threads, in
+//process (where the library serializes the reads) and through the reader pool, and print the times;
+//an untimed pass first brings the file into the page cache, so that both timed passes find it there
+///////////////////////////////////////////////////////////////////////////////////////
+
+int read_benchmark(const QString &file_name, const QString &var_nm_fll)
+{
+  QTextStream out(stdout);
+  ItemData *item_data = batch_variable(file_name, var_nm_fll, out);
+  if(item_data == NULL)
+  {
+    return 1;
+  }
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  nc_type var_type = item_data->m_ncvar->m_nc_type;
+  if(ncdim.empty() || var_type == NC_STRING)
+  {
+    out << "the variable has no dimension or is a string variable\n";
+    delete item_data;
+    return 1;
+  }
+
+  std::vector<size_t> count;
+  size_t slice_sz = nc_type_size(var_type);
+  for(size_t idx_dmn = 0; idx_dmn < ncdim.size(); idx_dmn++)
+  {
+    count.push_back(idx_dmn ? ncdim[idx_dmn].m_size : 1);
+    slice_sz *= count.back();
+  }
+  size_t nbr_slices = ncdim[0].m_size;
+  const double mb = 1024.0 * 1024.0;
+  item_data->m_dim_step = 0;
+
+  //each thread reads its range of slices; milliseconds of the pass, -1 if a read failed
+  auto pass = [&]() -> qint64
+  {
+    QElapsedTimer timer;
+    std::atomic<bool> ok(true);
+    timer.start();
+    parallel_for(nbr_slices, 1, [&](size_t begin, size_t end, int)
+    {
+      ncfile_t file_thr;
+      std::vector<size_t> start(count.size(), 0);
+      std::vector<char> buf(slice_sz);
+      for(size_t idx = begin; idx < end; idx++)
+      {
+        start[0] = idx;
+        if(read_hyperslab(item_data, file_thr, start, count, buf.data()) != NC_NOERR)
+        {
+          ok = false;
+        }
+      }
+    });
+    return ok ? timer.elapsed() : -1;
+  };
+
+  out << "variable: " << var_nm_fll << " (" << nbr_slices << " slices of " << slice_sz / mb << " MB)\n";
+  out << "threads: " << nbr_threads() << "\n";
+  out.flush();
+  pass();
+  qint64 ms_process = pass();
+  reader_pool().start(nbr_threads());
+  pass();
+  qint64 ms_pool = pass();
+  reader_pool().stop();
+
+  double total = nbr_slices * slice_sz / mb;
+  out << "in process: " << ms_process << " ms, " << total * 1000.0 / std::max(ms_process, (qint64)1) << " MB/s\n";
+  out << "reader processes: " << ms_pool << " ms, " << total * 1000.0 / std::max(ms_pool, (qint64)1) << " MB/s ("
+    << (double)ms_process / std::max(ms_pool, (qint64)1) << "x)\n";
+  out << "chunk cache (in process): " << chunk_cache_t::nbr_inflated() << " chunks inflated, "
+    << chunk_cache_t::nbr_avoided() << " inflations avoided\n";
+  out.flush();
+  delete item_data;
+  return (ms_process < 0 || ms_pool < 0) ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//subset_batch
+//--subset: save a hyperslab of a variable to a new netCDF-4 file (write_subset), with the coordinate
+//variables of its dimensions; start defaults to the origin, count to the rest of each dimension and
+//the chunk shape to one 2D slice per chunk
+///////////////////////////////////////////////////////////////////////////////////////
+
+int subset_batch(const QString &file_name, const QString &var_nm_fll, const QString &output, const QString &text_start,
+  const QString &text_count, const QString &text_chunks, int level, bool shuffle)
+{
+  QTextStream out(stdout);
+  ItemData *item_data = batch_variable(file_name, var_nm_fll, out);
+  if(item_data == NULL)
+  {
+    return 1;
+  }
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  size_t nbr_dmn = ncdim.size();
+  std::vector<size_t> start(nbr_dmn, 0);
+  std::vector<size_t> count;
+  std::vector<size_t> chunks;
+  if((!text_start.isEmpty() && (!parse_shape(text_start, start) || start.size() != nbr_dmn)) ||
+    !parse_shape(text_count, count) || (!text_count.isEmpty() && count.size() != nbr_dmn) ||
+    !parse_shape(text_chunks, chunks) || (!text_chunks.isEmpty() && chunks.size() != nbr_dmn))
+  {
+    out << "start, count and chunks need one size per dimension (" << nbr_dmn << ")\n";
+    delete item_data;
+    return 1;
+  }
+  if(text_count.isEmpty())
+  {
+    count.resize(nbr_dmn);
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      count[idx_dmn] = ncdim[idx_dmn].m_size - std::min(start[idx_dmn], ncdim[idx_dmn].m_size);
+    }
+  }
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(start[idx_dmn] + count[idx_dmn] > ncdim[idx_dmn].m_size)
+    {
+      out << "the subset is outside dimension " << QString::fromStdString(ncdim[idx_dmn].m_name) << "\n";
+      delete item_data;
+      return 1;
+    }
+  }
+  if(text_chunks.isEmpty())
+  {
+    chunks = default_chunks(count);
+  }
+
+  //coordinate variables: 1D numeric variables of the group named after the dimensions, loaded whole
+  std::vector<ncvar_t*> ncvar_crd(nbr_dmn, (ncvar_t*)NULL);
+  {
+    ncfile_t file;
+    if(file.open(item_data->m_file_name, item_data->m_grp_nm_fll) == NC_NOERR)
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+      {
+        const std::string &dmn_nm = ncdim[idx_dmn].m_name;
+        int var_id;
+        int nbr_crd_dmn;
+        nc_type crd_type;
+        if(dmn_nm == item_data->m_item_nm || nc_inq_varid(file.m_grp_id, dmn_nm.c_str(), &var_id) != NC_NOERR ||
+          nc_inq_var(file.m_grp_id, var_id, NULL, &crd_type, &nbr_crd_dmn, NULL, NULL) != NC_NOERR ||
+          nbr_crd_dmn != 1 || !is_numeric(crd_type))
+        {
+          continue;
+        }
+        ncvar_t *ncvar = new ncvar_t(dmn_nm.c_str(), crd_type, std::vector<ncdim_t>(1, ncdim[idx_dmn]));
+        ncvar->m_buf = malloc(ncdim[idx_dmn].m_size * nc_type_size(crd_type));
+        if(ncvar->m_buf == NULL || nc_get_var(file.m_grp_id, var_id, ncvar->m_buf) != NC_NOERR)
+        {
+          delete ncvar;
+          continue;
+        }
+        ncvar_crd[idx_dmn] = ncvar;
+      }
+    }
+  }
+  item_data->m_ncvar_crd = ncvar_crd;
+
+  QElapsedTimer timer;
+  std::string error;
+  timer.start();
+  bool ok = write_subset(item_data, start, count, chunks, level, shuffle, output.toStdString(), error, NULL);
+  qint64 ms = timer.elapsed();
+  if(ok)
+  {
+    out << "wrote " << output << " in " << ms << " ms\n";
+  }
+  else
+  {
+    out << QString::fromStdString(error) << "\n";
+  }
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    delete ncvar_crd[idx_dmn];
+  }
+  delete item_data;
+  return ok ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::read_files
+//open files together: each is walked by a worker process, so that the walks run in parallel
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::read_files(const QStringList &file_names)
+{
+  for(int idx = 0; idx < file_names.size(); idx++)
+  {
+    read_file(file_names.at(idx), file_names.size() > 1);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::read_file
+//add the root item of a file and queue the walk of its metadata; the tree is filled as the
+//walk goes on (insert_walked), so that the window stays responsive for large or remote files
+///////////////////////////////////////////////////////////////////////////////////////
+
+int MainWindow::read_file(QString file_name, bool use_worker)
+{
+  QString name;
+  int index;
+  int len;
+
+#ifdef HAVE_ZARR
+  //a Zarr store is a directory; its root metadata files open it too
+  QFileInfo info(file_name);
+  if(info.fileName() == ".zgroup" || info.fileName() == ".zmetadata")
+  {
+    file_name = info.absolutePath();
+  }
+  else if(info.isDir())
+  {
+    file_name = QDir::cleanPath(file_name);
+  }
+#endif
+
+  //convert to std::string
+  std::string str_file_name = file_name.toLatin1().data();
+
+  //group item
+  ItemData *item_data_grp = new ItemData(ItemData::Group,
+    str_file_name,
+    "/",
+    "/",
+    (ItemData*)NULL,
+    (ncvar_t*)NULL,
+    (grid_policy_t*)NULL);
+
+  //add root
+  QTreeWidgetItem *root_item = new QTreeWidgetItem(m_tree);
+  index = file_name.lastIndexOf(QChar('/'));
+  len = file_name.length();
+  name = file_name.right(len - index - 1);
+  root_item->setText(0, name);
+  root_item->setIcon(0, m_icon_group);
+  root_item->setToolTip(0, tr("Opening..."));
+  QVariant data;
+  data.setValue(item_data_grp);
+  root_item->setData(0, Qt::UserRole, data);
+  item_data_grp->m_inserted = false;
+
+  m_walks.push_back(new walk_t(str_file_name, root_item, use_worker));
+  if(!m_walk_timer->isActive())
+  {
+    m_walk_timer->start();
+  }
+  return NC_NOERR;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::insert_walked
+//start queued walks (worker processes up to the number of threads), then add the tree items of
+//the nodes walked so far, for a time slice per timer tick; finished walks become recent files,
+//failed ones remove their root item; failures are reported once the walks are updated (the
+//message box runs an event loop, in which the timer calls this again)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::insert_walked()
+{
+  const qint64 max_ms = 20; // time slice
+  const size_t max_nodes = 256; // nodes per batch
+  std::vector<walk_node_t> nodes;
+  QStringList failed;
+  QElapsedTimer timer;
+  bool done;
+  int status;
+  int nbr_running = 0;
+
+  for(size_t idx_wlk = 0; idx_wlk < m_walks.size(); idx_wlk++)
+  {
+    walk_t *walk = m_walks[idx_wlk];
+    if(walk->running())
+    {
+      nbr_running++;
+    }
+    else if(!walk->started() && (!walk->m_use_worker || nbr_running < nbr_threads()))
+    {
+      walk->start();
+      nbr_running += walk->running() ? 1 : 0;
+    }
+  }
+
+  load_icons();
+  timer.start();
+  m_tree->setUpdatesEnabled(false);
+  for(size_t idx_wlk = 0; idx_wlk < m_walks.size();)
+  {
+    walk_t *walk = m_walks[idx_wlk];
+    if(!walk->started())
+    {
+      idx_wlk++;
+      continue;
+    }
+    do
+    {
+      walk->take(nodes, max_nodes, done, status);
+      for(size_t idx_nod = 0; idx_nod < nodes.size(); idx_nod++)
+      {
+        insert_node(walk, nodes[idx_nod]);
+      }
+    } while(nodes.size() == max_nodes && timer.elapsed() < max_ms);
+
+    if(!done)
+    {
+      idx_wlk++;
+      continue;
+    }
+
+    QString file_name = QString::fromStdString(walk->m_file_name);
+    if(status == NC_NOERR)
+    {
+      get_item_data(walk->m_root)->m_inserted = true;
+      walk->m_root->setToolTip(0, file_name);
+      set_current_file(file_name);
+    }
+    else
+    {
+      delete get_item_data(walk->m_root);
+      delete walk->m_root;
+      failed << (walk->crashed() ? tr("%1 (the library crashed reading it)").arg(file_name) : file_name);
+    }
+    m_walks.erase(m_walks.begin() + idx_wlk);
+    delete walk;
+  }
+  m_tree->setUpdatesEnabled(true);
+
+  if(m_walks.empty())
+  {
+    m_walk_timer->stop();
+  }
+
+  //the startup benchmark runs unattended: failures go to the standard error
+  if(!failed.isEmpty() && m_startup_clock != NULL)
+  {
+    QTextStream err(stderr);
+    err << "cannot open " << failed.join(", ") << "\n";
+  }
+  if(m_walks.empty() && m_startup_clock != NULL)
+  {
+    startup_report(StartupTree);
+  }
+  else if(!failed.isEmpty() && m_startup_clock == NULL)
+  {
+    QMessageBox::warning(this, tr("Data Explorer"), tr("Cannot open %1").arg(failed.join(", ")));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::insert_node
+//tree item, item data and name index entries of a walked node (the root group node fills
+//the root item of the walk)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::insert_node(walk_t *walk, const walk_node_t &node)
+{
+  const std::string &file_name = walk->m_file_name;
+  std::string path = last_component(QString::fromStdString(file_name)).toStdString() + ":" + node.m_grp_nm_fll;
+  std::string path_grp = (path[path.size() - 1] == '/') ? path : path + "/";
+  QTreeWidgetItem *item;
+
+  if(node.m_parent == -1)
+  {
+    item = walk->m_root;
+    get_item_data(item)->m_source = walk->source();
+    m_name_index->add(item->text(0).toStdString(), file_name, name_index_t::Group, item);
+  }
+  else if(node.m_kind == ItemData::Group)
+  {
+    QTreeWidgetItem *item_prn = walk->m_items[node.m_parent];
+
+    //group item
+    ItemData *item_data_grp = new ItemData(ItemData::Group,
+      file_name,
+      node.m_grp_nm_fll,
+      node.m_name,
+      get_item_data(item_prn),
+      (ncvar_t*)NULL,
+      (grid_policy_t*)NULL);
+    item_data_grp->m_source = get_item_data(item_prn)->m_source;
+
+    item = new QTreeWidgetItem(item_prn);
+    item->setText(0, QString::fromStdString(node.m_name));
+    item->setIcon(0, m_icon_group);
+    QVariant data;
+    data.setValue(item_data_grp);
+    item->setData(0, Qt::UserRole, data);
+    m_name_index->add(node.m_name, path, name_index_t::Group, item);
+  }
+  else
+  {
+    QTreeWidgetItem *item_prn = walk->m_items[node.m_parent];
+    ItemData *item_data_prn = get_item_data(item_prn);
+
+    //store a ncvar_t
+    ncvar_t *ncvar = new ncvar_t(node.m_name.c_str(), node.m_nc_type, node.m_ncdim);
+
+    //define a grid dimensions policy
+    grid_policy_t *grid_policy = new grid_policy_t(node.m_ncdim);
+
+    //append item
+    ItemData *item_data_var = new ItemData(ItemData::Variable,
+      file_name,
+      node.m_grp_nm_fll,
+      node.m_name,
+      item_data_prn,
+      ncvar,
+      grid_policy);
+    item_data_var->m_source = item_data_prn->m_source;
+    item_data_var->m_has_fill = node.m_has_fill;
+    item_data_var->m_fill_value = node.m_fill_value;
+    if(item_data_var->m_source == ItemData::SourceSQLite)
+    {
+      item_data_var->m_columns = node.m_att_nm;
+      item_data_var->m_rowid_first = node.m_rowid_first;
+    }
+#ifdef HAVE_ZARR
+    if(item_data_var->m_source == ItemData::SourceZarr)
+    {
+      std::string dir = file_name + (node.m_grp_nm_fll == "/" ? std::string() : node.m_grp_nm_fll) + "/" + node.m_name;
+      item_data_var->m_zarr = new zarr_array_t(dir, node.m_meta);
+    }
+#endif
+
+    //store variable in parent group item (for coordinate variables detection)
+    item_data_prn->m_vars[node.m_name] = item_data_var;
+
+    //append item
+    item = new QTreeWidgetItem(item_prn);
+    item->setText(0, QString::fromStdString(node.m_name));
+    item->setIcon(0, m_icon_dataset);
+    QVariant data;
+    data.setValue(item_data_var);
+    item->setData(0, Qt::UserRole, data);
+
+    //index variable and attribute names
+    m_name_index->add(node.m_name, path_grp + node.m_name, name_index_t::Variable, item);
+    for(size_t idx_att = 0; idx_att < node.m_att_nm.size(); idx_att++)
+    {
+      m_name_index->add(node.m_att_nm[idx_att], path_grp + node.m_name + "@" + node.m_att_nm[idx_att], name_index_t::Attribute, item);
+    }
+    walk->m_items.push_back(item);
+    return;
+  }
+
+  //index names of group attributes and dimensions (they select the group item)
+  for(size_t idx_att = 0; idx_att < node.m_att_nm.size(); idx_att++)
+  {
+    m_name_index->add(node.m_att_nm[idx_att], path + "@" + node.m_att_nm[idx_att], name_index_t::Attribute, item);
+  }
+  for(size_t idx_dmn = 0; idx_dmn < node.m_dmn_nm.size(); idx_dmn++)
+  {
+    m_name_index->add(node.m_dmn_nm[idx_dmn], path_grp + node.m_dmn_nm[idx_dmn], name_index_t::Dimension, item);
+  }
+  walk->m_items.push_back(item);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::load_icons
+//tree and window icons, loaded after the window is first shown
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::load_icons()
+{
+  if(!m_icon_main.isNull())
+  {
+    return;
+  }
+  m_icon_main = QIcon(":/images/sample.png");
+  m_icon_group = QIcon(":/images/folder.png");
+  m_icon_dataset = QIcon(":/images/document.png");
+  setWindowIcon(m_icon_main);
+
+  //root items added before
+  for(int idx = 0; idx < m_tree->topLevelItemCount(); idx++)
+  {
+    m_tree->topLevelItem(idx)->setIcon(0, m_icon_group);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::start_benchmark
+//report startup times (from 'clock', started at process start) to standard output and quit once
+//the files given on the command line are in the tree
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::start_benchmark(QElapsedTimer *clock)
+{
+  m_startup_clock = clock;
+  m_startup_ms[StartupWindow] = clock->elapsed();
+  m_tree->viewport()->installEventFilter(this);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::eventFilter
+//first paint of the tree, for the startup benchmark
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool MainWindow::eventFilter(QObject *obj, QEvent *eve)
+{
+  if(eve->type() == QEvent::Paint && obj == m_tree->viewport() && m_startup_clock != NULL)
+  {
+    m_tree->viewport()->removeEventFilter(this);
+    startup_report(StartupPaint);
+  }
+  return QMainWindow::eventFilter(obj, eve);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::startup_report
+//record a startup milestone; when both the first paint and the tree are done, print and quit
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::startup_report(int milestone)
+{
+  static const char* milestone_name[] = { "window", "first paint", "tree" };
+  m_startup_ms[milestone] = m_startup_clock->elapsed();
+  if(m_startup_ms[StartupPaint] < 0 || (m_startup_ms[StartupTree] < 0 && !m_walks.empty()))
+  {
+    return;
+  }
+  if(m_startup_ms[StartupTree] < 0)
+  {
+    m_startup_ms[StartupTree] = m_startup_ms[StartupPaint];
+  }
+  QTextStream out(stdout);
+  for(int idx = 0; idx < NbrStartup; idx++)
+  {
+    out << milestone_name[idx] << ": " << m_startup_ms[idx] << " ms\n";
+  }
+  size_t nbr_items = 0;
+  for(QTreeWidgetItemIterator it(m_tree); *it; ++it)
+  {
+    nbr_items++;
+  }
+  out << "items: " << nbr_items << "\n";
+  out.flush();
+  m_startup_clock = NULL;
+  QTimer::singleShot(0, qApp, SLOT(quit()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::search_names
+//incremental search, called on each keystroke; uses only the name index
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::search_names(const QString &text)
+{
+  const size_t max_results = 200;
+  static const char* kind_name[] = { "var", "dim", "att", "grp" };
+  std::vector<uint32_t> results;
+
+  if(text.isEmpty())
+  {
+    m_list_search->clear();
+    m_list_search->hide();
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  m_name_index->search(text.toStdString(), max_results, results);
+  qint64 elapsed = timer.nsecsElapsed();
+
+  m_list_search->setUpdatesEnabled(false);
+  m_list_search->clear();
+  for(size_t idx = 0; idx < results.size(); idx++)
+  {
+    const name_index_t::entry_t &entry = m_name_index->entry(results[idx]);
+    QListWidgetItem *item = new QListWidgetItem(QString("[%1] %2").arg(kind_name[entry.m_kind]).arg(QString::fromStdString(entry.m_path)));
+    item->setData(Qt::UserRole, (uint)results[idx]);
+    m_list_search->addItem(item);
+  }
+  m_list_search->setUpdatesEnabled(true);
+  m_list_search->show();
+  statusBar()->showMessage(tr("%1 matches in %2 names (%3 ms)")
+    .arg(results.size()).arg(m_name_index->size()).arg(elapsed / 1.0e6, 0, 'f', 3));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::select_search_result
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::select_search_result(QListWidgetItem *item)
+{
+  const name_index_t::entry_t &entry = m_name_index->entry(item->data(Qt::UserRole).toUInt());
+  m_tree->setCurrentItem(entry.m_item);
+  m_tree->scrollToItem(entry.m_item);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget
+///////////////////////////////////////////////////////////////////////////////////////
+
+class TableWidget : public QTableWidget
+{
+public:
+  TableWidget(QWidget *parent, ItemData *item_data);
+  ~TableWidget();
+
+protected:
+  void paintEvent(QPaintEvent *eve)
+  {
+    {
+      perf_timer_t timer(perf_t::Paint);
+      QTableWidget::paintEvent(eve);
+    }
+    show_grid();
+  }
+
+private:
+  void show_grid();
+  void show_user_grid(const void *data, size_t idx_buf);
+  void clear_slice();
+public:
+  void show_text(const std::vector<QString> &text, const std::vector<int> &layer);
+  const void* slice(size_t &nbr);
+private:
+  ItemData *m_item_data; // the tree item that generated this grid 
+  ncvar_t *m_ncvar; // netCDF variable to display (convenience pointer to data in ItemData) 
+  int m_nbr_rows;   // number of rows
+  int m_nbr_cols;   // number of columns
+  int m_nbr_fields; // grid columns per column (members of a compound type, otherwise 1)
+  int m_dim_rows;   // choose rows (convenience duplicate to data in ItemData)
+  int m_dim_cols;   // choose columns (convenience duplicate to data in ItemData)
+  std::vector<ncvar_t *> m_ncvar_crd; // optional coordinate variables for variable (convenience duplicate to data in ItemData)
+  std::vector<char> m_slice; // displayed slice of a variable that is not loaded
+  const void *m_slice_data; // displayed slice (NULL if not read)
+  size_t m_slice_nbr; // number of elements in the slice
+  std::vector<int> m_slice_layer; // layer of the slice
+  std::vector<int> m_shown_layer; // layer shown in the grid items
+  bool m_shown; // grid items are filled (for m_shown_layer)
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowTable
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChildWindowTable : public ChildWindow
+{
+public:
+  ChildWindowTable(QWidget *parent, ItemData *item_data) :
+    ChildWindow(parent, item_data)
+  {
+    m_table = new TableWidget(parent, item_data);
+    setCentralWidget(m_table);
+  }
+  TableWidget *table() const
+  {
+    return m_table;
+  }
+protected:
+  void show_cell(int row, int col)
+  {
+    m_table->setCurrentCell(row, col);
+    m_table->scrollTo(m_table->model()->index(row, col), QAbstractItemView::PositionAtCenter);
+  }
+  bool frame_text() const
+  {
+    return true;
+  }
+  void show_frame(frame_t *frame)
+  {
+    m_table->show_text(frame->m_text, m_layer);
+  }
+  bool selected_range(int &row, int &nbr_rows, int &col, int &nbr_cols) const
+  {
+    QList<QTableWidgetSelectionRange> ranges = m_table->selectedRanges();
+    if(ranges.isEmpty())
+    {
+      return false;
+    }
+    row = ranges.first().topRow();
+    nbr_rows = ranges.first().rowCount();
+    col = ranges.first().leftColumn();
+    nbr_cols = ranges.first().columnCount();
+    return true;
+  }
+private:
+  TableWidget *m_table;
+};
+
+#ifdef HAVE_SQLITE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//SqlTableModel
+//rows of an SQLite table for a table view, read in pages when the view asks for them
+//rowid tables: a page is one range query on the rowid (keyset paging, never OFFSET), so any page
+//costs the same wherever it is; recently used pages are cached
+//views and tables without rowid: rows are fetched forward with one statement as the view is
+//scrolled to the end (fetchMore), and kept
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class SqlTableModel : public QAbstractTableModel
+{
+public:
+  SqlTableModel(QObject *parent, ItemData *item_data) :
+    QAbstractTableModel(parent),
+    m_item_data(item_data),
+    m_stmt_page(NULL),
+    m_stmt_cursor(NULL),
+    m_nbr_fetched(0),
+    m_cursor_done(false),
+    m_clock(0)
+  {
+    std::string columns = sql_columns(item_data, 0, item_data->m_columns.size());
+    std::string table = sql_quote(item_data->m_item_nm);
+    m_file.open_sqlite(item_data->m_file_name);
+    if(m_file.m_db == NULL || columns.empty())
+    {
+      m_cursor_done = true;
+      return;
+    }
+    if(keyed())
+    {
+      std::string sql = "SELECT rowid, " + columns + " FROM " + table + " WHERE rowid >= ?1 AND rowid < ?2 ORDER BY rowid";
+      sqlite3_prepare_v2(m_file.m_db, sql.c_str(), -1, &m_stmt_page, NULL);
+    }
+    else
+    {
+      std::string sql = "SELECT " + columns + " FROM " + table;
+      if(sqlite3_prepare_v2(m_file.m_db, sql.c_str(), -1, &m_stmt_cursor, NULL) != SQLITE_OK)
+      {
+        m_cursor_done = true;
+      }
+    }
+  }
+  ~SqlTableModel()
+  {
+    sqlite3_finalize(m_stmt_page);
+    sqlite3_finalize(m_stmt_cursor);
+  }
+  int rowCount(const QModelIndex &parent = QModelIndex()) const
+  {
+    if(parent.isValid())
+    {
+      return 0;
+    }
+    if(keyed())
+    {
+      return (int)std::min(m_item_data->m_ncvar->m_ncdim[0].m_size, (size_t)INT_MAX);
+    }
+    return (int)m_nbr_fetched;
+  }
+  int columnCount(const QModelIndex &parent = QModelIndex()) const
+  {
+    return parent.isValid() ? 0 : (int)m_item_data->m_columns.size();
+  }
+  QVariant data(const QModelIndex &index, int role) const
+  {
+    if(!index.isValid() || role != Qt::DisplayRole)
+    {
+      return QVariant();
+    }
+    size_t nbr_cols = m_item_data->m_columns.size();
+    if(!keyed())
+    {
+      return m_fetched[index.row() * nbr_cols + index.column()];
+    }
+    const page_t &page = get_page(index.row() / page_rows);
+    return page.m_cells[(index.row() % page_rows) * nbr_cols + index.column()];
+  }
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const
+  {
+    if(role != Qt::DisplayRole)
+    {
+      return QVariant();
+    }
+    if(orientation == Qt::Horizontal)
+    {
+      return QString::fromStdString(m_item_data->m_columns[section]);
+    }
+    //rowid of the row
+    if(keyed())
+    {
+      return QString::number(m_item_data->m_rowid_first + section);
+    }
+    return section + 1;
+  }
+  bool canFetchMore(const QModelIndex &parent) const
+  {
+    return !parent.isValid() && !keyed() && !m_cursor_done;
+  }
+  void fetchMore(const QModelIndex &parent)
+  {
+    if(parent.isValid() || m_cursor_done)
+    {
+      return;
+    }
+    perf_timer_t timer(perf_t::Read, m_item_data->m_item_nm);
+    size_t nbr_cols = m_item_data->m_columns.size();
+    std::vector<QString> cells;
+    size_t nbr_rows = 0;
+    while(nbr_rows < page_rows)
+    {
+      if(sqlite3_step(m_stmt_cursor) != SQLITE_ROW)
+      {
+        m_cursor_done = true;
+        break;
+      }
+      for(size_t idx_col = 0; idx_col < nbr_cols; idx_col++)
+      {
+        cells.push_back(QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(m_stmt_cursor, (int)idx_col))));
+      }
+      nbr_rows++;
+    }
+    if(nbr_rows == 0)
+    {
+      return;
+    }
+    beginInsertRows(QModelIndex(), (int)m_nbr_fetched, (int)(m_nbr_fetched + nbr_rows - 1));
+    m_fetched.insert(m_fetched.end(), cells.begin(), cells.end());
+    m_nbr_fetched += nbr_rows;
+    endInsertRows();
+  }
+  bool keyed() const
+  {
+    return m_item_data->m_rowid_first >= 0;
+  }
+  sqlite3 *db() const
+  {
+    return m_file.m_db;
+  }
+
+private:
+  enum { page_rows = 256 }; // rows per page
+  enum { max_pages = 64 }; // cached pages
+  class page_t
+  {
+  public:
+    std::vector<QString> m_cells;
+    qint64 m_used; // last use (model clock)
+  };
+
+  //page of rows (rowids [first + idx_page * page_rows, + page_rows)), read on first use
+  const page_t& get_page(size_t idx_page) const
+  {
+    std::map<size_t, page_t>::iterator it = m_pages.find(idx_page);
+    if(it != m_pages.end())
+    {
+      it->second.m_used = ++m_clock;
+      return it->second;
+    }
+    if(m_pages.size() >= max_pages)
+    {
+      std::map<size_t, page_t>::iterator it_old = m_pages.begin();
+      for(it = m_pages.begin(); it != m_pages.end(); ++it)
+      {
+        if(it->second.m_used < it_old->second.m_used)
+        {
+          it_old = it;
+        }
+      }
+      m_pages.erase(it_old);
+    }
+
+    perf_timer_t timer(perf_t::Read, m_item_data->m_item_nm);
+    size_t nbr_cols = m_item_data->m_columns.size();
+    page_t &page = m_pages[idx_page];
+    page.m_used = ++m_clock;
+    page.m_cells.resize(page_rows * nbr_cols);
+    long long first = m_item_data->m_rowid_first + (long long)(idx_page * page_rows);
+    if(m_stmt_page != NULL)
+    {
+      sqlite3_reset(m_stmt_page);
+      sqlite3_bind_int64(m_stmt_page, 1, first);
+      sqlite3_bind_int64(m_stmt_page, 2, first + page_rows);
+      while(sqlite3_step(m_stmt_page) == SQLITE_ROW)
+      {
+        size_t row = (size_t)(sqlite3_column_int64(m_stmt_page, 0) - first);
+        for(size_t idx_col = 0; idx_col < nbr_cols; idx_col++)
+        {
+          page.m_cells[row * nbr_cols + idx_col] =
+            QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(m_stmt_page, (int)idx_col + 1)));
+        }
+      }
+    }
+    return page;
+  }
+
+  ItemData *m_item_data;
+  ncfile_t m_file; // connection of the model
+  sqlite3_stmt *m_stmt_page; // (rowid table) rows of a rowid range
+  sqlite3_stmt *m_stmt_cursor; // (view) all rows, stepped forward
+  std::vector<QString> m_fetched; // (view) cells of the rows fetched so far
+  size_t m_nbr_fetched;
+  bool m_cursor_done;
+  mutable std::map<size_t, page_t> m_pages; // (rowid table) cached pages by index
+  mutable qint64 m_clock;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowSql::ChildWindowSql
+///////////////////////////////////////////////////////////////////////////////////////
+
+ChildWindowSql::ChildWindowSql(QWidget *parent, ItemData *item_data) :
+  ChildWindow(parent, item_data)
+{
+  m_model = new SqlTableModel(this, item_data);
+  m_view = new QTableView;
+  m_view->setModel(m_model);
+  //fixed row heights, so that the view never measures the rows of a large table
+  m_view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_view->verticalHeader()->setDefaultSectionSize(m_view->fontMetrics().height() + 6);
+  setCentralWidget(m_view);
+
+  //a table of text has no netCDF subset and no values to find
+  m_action_subset->setVisible(false);
+  m_action_find->setVisible(false);
+
+  QToolBar *tool_bar = addToolBar(tr("Table"));
+  QAction *action_stats = new QAction(tr("&Statistics..."), this);
+  action_stats->setStatusTip(tr("Count, minimum, maximum and mean of every column"));
+  connect(action_stats, SIGNAL(triggered()), this, SLOT(statistics()));
+  tool_bar->addAction(action_stats);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowSql::show_cell
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindowSql::show_cell(int row, int col)
+{
+  QModelIndex index = m_model->index(row, col);
+  m_view->setCurrentIndex(index);
+  m_view->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowSql::selected_range
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool ChildWindowSql::selected_range(int &row, int &nbr_rows, int &col, int &nbr_cols) const
+{
+  QItemSelection selection = m_view->selectionModel()->selection();
+  if(selection.isEmpty())
+  {
+    return false;
+  }
+  row = selection.first().top();
+  nbr_rows = selection.first().height();
+  col = selection.first().left();
+  nbr_cols = selection.first().width();
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//sql_progress
+//progress handler of a long query: keep the UI alive, and interrupt the query on cancel
+///////////////////////////////////////////////////////////////////////////////////////
+
+int sql_progress(void *data)
+{
+  QProgressDialog *progress = static_cast<QProgressDialog*>(data);
+  QApplication::processEvents();
+  return progress->wasCanceled() ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowSql::statistics
+//count, minimum, maximum and mean of all columns from one aggregate query (one scan of the table)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindowSql::statistics()
+{
+  const std::vector<std::string> &columns = m_item_data->m_columns;
+  const char* stat_name[] = { "count", "minimum", "maximum", "mean" };
+  const int nbr_stats = 4;
+  sqlite3 *db = m_model->db();
+  sqlite3_stmt *stmt;
+
+  if(db == NULL || columns.empty())
+  {
+    return;
+  }
+  std::string sql = "SELECT count(*)";
+  for(size_t idx_col = 0; idx_col < columns.size(); idx_col++)
+  {
+    std::string col = sql_quote(columns[idx_col]);
+    sql += ", count(" + col + "), min(" + col + "), max(" + col + "), avg(" + col + ")";
+  }
+  sql += " FROM " + sql_quote(m_item_data->m_item_nm);
+  if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK)
+  {
+    QMessageBox::warning(this, tr("Data Explorer"), QString::fromUtf8(sqlite3_errmsg(db)));
+    return;
+  }
+
+  QProgressDialog progress(tr("Computing column statistics..."), tr("Cancel"), 0, 0, this);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(500);
+  QElapsedTimer timer;
+  timer.start();
+  sqlite3_progress_handler(db, 100000, sql_progress, &progress);
+  int status = sqlite3_step(stmt);
+  sqlite3_progress_handler(db, 0, NULL, NULL);
+  progress.close();
+  if(status != SQLITE_ROW)
+  {
+    if(status != SQLITE_INTERRUPT)
+    {
+      QMessageBox::warning(this, tr("Data Explorer"), QString::fromUtf8(sqlite3_errmsg(db)));
+    }
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  QDialog dlg(this);
+  dlg.setWindowTitle(tr("Statistics : %1").arg(QString::fromStdString(m_item_data->m_item_nm)));
+  QVBoxLayout *layout = new QVBoxLayout(&dlg);
+  layout->addWidget(new QLabel(tr("%1 rows (%2 ms)").arg(sqlite3_column_int64(stmt, 0)).arg(timer.elapsed())));
+  QTableWidget *table = new QTableWidget((int)columns.size(), nbr_stats, &dlg);
+  for(int idx_stat = 0; idx_stat < nbr_stats; idx_stat++)
+  {
+    table->setHorizontalHeaderItem(idx_stat, new QTableWidgetItem(tr(stat_name[idx_stat])));
+  }
+  for(size_t idx_col = 0; idx_col < columns.size(); idx_col++)
+  {
+    table->setVerticalHeaderItem((int)idx_col, new QTableWidgetItem(QString::fromStdString(columns[idx_col])));
+    for(int idx_stat = 0; idx_stat < nbr_stats; idx_stat++)
+    {
+      const char *text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1 + (int)idx_col * nbr_stats + idx_stat));
+      table->setItem((int)idx_col, idx_stat, new QTableWidgetItem(QString::fromUtf8(text ? text : "")));
+    }
+  }
+  sqlite3_finalize(stmt);
+  layout->addWidget(table);
+  dlg.resize(520, 360);
+  dlg.exec();
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//RenderWidget
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class RenderWidget : public QWidget
+{
+public:
+  RenderWidget(QWidget *parent, ItemData *item_data) :
+    QWidget(parent),
+    m_item_data(item_data)
+  {
+
+  }
+  QSize sizeHint() const;
+
+protected:
+  void paintEvent(QPaintEvent *);
+
+private:
+  ItemData *m_item_data; // the tree item that generated this image 
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowImage
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChildWindowImage : public ChildWindow
+{
+public:
+  ChildWindowImage(QWidget *parent, ItemData *item_data) :
+    ChildWindow(parent, item_data)
+  {
+    m_render_area = new RenderWidget(parent, item_data);
+    setCentralWidget(m_render_area);
+  }
+
+private:
+  RenderWidget *m_render_area;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PlotWidget
+//line plot of the displayed 1D slice; the slice is reduced to the minimum and maximum of the
+//elements of each pixel column, so drawing cost depends on the widget width, not on the slice size
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class PlotWidget : public QWidget
+{
+public:
+  PlotWidget(QWidget *parent, ItemData *item_data);
+  QSize sizeHint() const;
+
+protected:
+  void paintEvent(QPaintEvent *);
+
+private:
+  void decimate(int width);
+  ItemData *m_item_data; // the tree item that generated this plot
+  ncvar_t *m_ncvar; // netCDF variable to display (convenience pointer to data in ItemData)
+  double m_fill; // fill value, not drawn
+  std::vector<int> m_layer; // layer of the slice that was reduced
+  int m_width; // width the slice was reduced to
+  size_t m_nbr; // number of elements in the slice
+  std::vector<float> m_min; // minimum of each pixel column (NaN if the column has no valid values)
+  std::vector<float> m_max; // maximum of each pixel column
+  double m_lo; // range of the slice
+  double m_hi;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowPlot
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChildWindowPlot : public ChildWindow
+{
+public:
+  ChildWindowPlot(QWidget *parent, ItemData *item_data) :
+    ChildWindow(parent, item_data, 1)
+  {
+    m_plot = new PlotWidget(this, item_data);
+    setCentralWidget(m_plot);
+  }
+
+private:
+  PlotWidget *m_plot;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//HistogramWidget
+//histogram of the values of the displayed 2D slice, binned on all cores
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class HistogramWidget : public QWidget
+{
+public:
+  HistogramWidget(QWidget *parent, ItemData *item_data);
+  QSize sizeHint() const;
+
+protected:
+  void paintEvent(QPaintEvent *);
+
+private:
+  void bin();
+  ItemData *m_item_data; // the tree item that generated this histogram
+  ncvar_t *m_ncvar; // netCDF variable to display (convenience pointer to data in ItemData)
+  double m_fill; // fill value, not counted
+  std::vector<int> m_layer; // layer of the slice that was binned
+  bool m_binned; // bins are computed for m_layer
+  std::vector<size_t> m_bins; // count of values in each bin
+  double m_lo; // range of the slice
+  double m_hi;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowHistogram
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChildWindowHistogram : public ChildWindow
+{
+public:
+  ChildWindowHistogram(QWidget *parent, ItemData *item_data) :
+    ChildWindow(parent, item_data)
+  {
+    m_histogram = new HistogramWidget(this, item_data);
+    setCentralWidget(m_histogram);
+  }
+
+private:
+  HistogramWidget *m_histogram;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_child
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_child(ChildWindow *window)
+{
+  connect(window, SIGNAL(layer_changed()), this, SLOT(sync_layers()));
+  m_mdi_area->addSubWindow(window);
+  window->show();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::sync_layers
+//with linked layers, a layer change in a window moves all windows with a layer dimension of the same
+//name to that layer; the slices of all affected windows that are not loaded are read first as one
+//batch, then the windows are updated; the windows are read one after the other, since each read
+//already spreads its chunks over the I/O threads (nested threads would multiply them)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::sync_layers()
+{
+  ChildWindow *source = qobject_cast<ChildWindow*>(sender());
+  if(!m_action_link_layers->isChecked() || m_syncing || source == NULL)
+    return;
+
+  std::vector<std::string> dims;
+  ncvar_t *ncvar_src = source->item_data()->m_ncvar;
+  for(size_t idx_dmn = 0; idx_dmn < source->m_layer.size(); idx_dmn++)
+  {
+    dims.push_back(ncvar_src->m_ncdim[idx_dmn].m_name);
+  }
+
+  std::vector<ChildWindow*> windows(1, source);
+  std::vector<std::vector<int> > layers(1, source->m_layer);
+  QList<QMdiSubWindow*> list = m_mdi_area->subWindowList();
+  for(int idx_win = 0; idx_win < list.size(); idx_win++)
+  {
+    ChildWindow *window = qobject_cast<ChildWindow*>(list.at(idx_win)->widget());
+    std::vector<int> layer;
+    if(window != NULL && window != source && window->linked_layer(dims, source->m_layer, layer))
+    {
+      windows.push_back(window);
+      layers.push_back(layer);
+    }
+  }
+
+  {
+    perf_timer_t timer(perf_t::Read, "linked layers");
+    for(size_t idx_win = 0; idx_win < windows.size(); idx_win++)
+    {
+      windows[idx_win]->prefetch(layers[idx_win]);
+    }
+  }
+
+  m_syncing = true;
+  for(size_t idx_win = 1; idx_win < windows.size(); idx_win++)
+  {
+    windows[idx_win]->set_layer(layers[idx_win]);
+  }
+  m_syncing = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_table
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_table(ItemData *item_data, bool owned)
+{
+  perf_timer_t timer(perf_t::Layout, item_data->m_item_nm);
+#ifdef HAVE_SQLITE
+  if(item_data->m_source == ItemData::SourceSQLite)
+  {
+    add_child(new ChildWindowSql(this, item_data));
+    return;
+  }
+#endif
+  ChildWindowTable *window = new ChildWindowTable(this, item_data);
+  window->m_item_data_owned = owned;
+  add_child(window);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_image
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_image(ItemData *item_data)
+{
+  perf_timer_t timer(perf_t::Layout, item_data->m_item_nm);
+  ChildWindowImage *window = new ChildWindowImage(this, item_data);
+  add_child(window);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_plot
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_plot(ItemData *item_data)
+{
+  perf_timer_t timer(perf_t::Layout, item_data->m_item_nm);
+  ChildWindowPlot *window = new ChildWindowPlot(this, item_data);
+  add_child(window);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_histogram
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_histogram(ItemData *item_data)
+{
+  perf_timer_t timer(perf_t::Layout, item_data->m_item_nm);
+  ChildWindowHistogram *window = new ChildWindowHistogram(this, item_data);
+  add_child(window);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//MainWindow::add_diff
+//grid of a difference variable with its summary panel; the window owns the difference variable
+///////////////////////////////////////////////////////////////////////////////////////
+
+void MainWindow::add_diff(ItemData *item_data)
+{
+  perf_timer_t timer(perf_t::Layout, item_data->m_item_nm);
+  ChildWindowTable *window = new ChildWindowTable(this, item_data);
+  window->m_item_data_owned = true;
+  window->addDockWidget(Qt::RightDockWidgetArea, new DiffPanel(window, window->table(), item_data));
+  add_child(window);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//nearest_index
+//index of the element of a one-dimensional numeric variable nearest to a value; the monotonic
+//direction is detected once per variable, monotonic variables are searched by bisection
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t nearest_index(ncvar_t *ncvar, double value)
+{
+  const void *buf = ncvar->m_buf;
+  nc_type typ = ncvar->m_nc_type;
+  size_t size = ncvar->m_ncdim[0].m_size;
+  size_t lo = 0;
+  size_t hi = size;
+
+  if(size == 0)
+  {
+    return 0;
+  }
+
+  if(ncvar->m_monotonic == ncvar_t::MonotonicUnknown)
+  {
+    bool increasing = true;
+    bool decreasing = true;
+    for(size_t idx = 1; idx < size && (increasing || decreasing); idx++)
+    {
+      double prev = value_at(buf, typ, idx - 1);
+      double next = value_at(buf, typ, idx);
+      increasing = increasing && prev <= next;
+      decreasing = decreasing && prev >= next;
+    }
+    ncvar->m_monotonic = increasing ? ncvar_t::Increasing : (decreasing ? ncvar_t::Decreasing : ncvar_t::NotMonotonic);
+  }
+
+  if(ncvar->m_monotonic == ncvar_t::NotMonotonic)
+  {
+    size_t idx_min = 0;
+    for(size_t idx = 1; idx < size; idx++)
+    {
+      if(fabs(value_at(buf, typ, idx) - value) < fabs(value_at(buf, typ, idx_min) - value))
+      {
+        idx_min = idx;
+      }
+    }
+    return idx_min;
+  }
+
+  //first element that is not before the value, in the direction of the variable
+  bool increasing = (ncvar->m_monotonic == ncvar_t::Increasing);
+  while(lo < hi)
+  {
+    size_t mid = lo + (hi - lo) / 2;
+    double val = value_at(buf, typ, mid);
+    if(increasing ? val < value : val > value)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  if(lo == size)
+  {
+    return size - 1;
+  }
+  if(lo == 0)
+  {
+    return 0;
+  }
+  return fabs(value_at(buf, typ, lo) - value) < fabs(value_at(buf, typ, lo - 1) - value) ? lo : lo - 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//LayerModel
+//list model of the layers of a dimension for the layer combo boxes; labels are formatted on request,
+//so only the rows the combo displays are formatted, regardless of the dimension size
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class LayerModel : public QAbstractListModel
+{
+public:
+  LayerModel(QObject *parent, ncvar_t *ncvar_crd, size_t size) :
+    QAbstractListModel(parent),
+    m_ncvar_crd(ncvar_crd),
+    m_size(size)
+  {
+  }
+  int rowCount(const QModelIndex &parent = QModelIndex()) const
+  {
+    return parent.isValid() ? 0 : (int)m_size;
+  }
+  QVariant data(const QModelIndex &index, int role) const
+  {
+    char str[NC_MAX_NAME + 1];
+    str[0] = '\0'; // format_value writes nothing for the types it does not handle
+    if(role != Qt::DisplayRole || !index.isValid())
+    {
+      return QVariant();
+    }
+    //coordinate variable exists
+    if(m_ncvar_crd != NULL && m_ncvar_crd->m_buf != NULL)
+    {
+      format_value(str, sizeof(str), m_ncvar_crd->m_buf, m_ncvar_crd->m_nc_type, index.row());
+    }
+    else
+    {
+      snprintf(str, sizeof(str), "%d", index.row() + 1);
+    }
+    return QString(str);
+  }
+private:
+  ncvar_t *m_ncvar_crd; // coordinate variable (optional)
+  size_t m_size; // number of layers
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_t
+//a playback frame: the slice at one index of the played dimension, read and optionally formatted
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class frame_t
+{
+public:
+  frame_t(size_t index) :
+    m_index(index),
+    m_ok(false)
+  {
+  }
+  size_t m_index; // index in the played dimension
+  bool m_ok; // read without errors
+  std::vector<char> m_slice; // slice in the variable type (empty for NC_STRING)
+  std::vector<QString> m_text; // formatted elements of the slice (if requested)
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t
+//worker threads that keep the frames of the next 'nbr_ahead' indices of a dimension ready (wrapping at
+//the end); moving the target drops the frames before it, so workers never prepare frames too late
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class frame_pipeline_t
+{
+public:
+  frame_pipeline_t(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+    size_t dim, size_t nbr_ahead, bool format);
+  ~frame_pipeline_t();
+  void set_target(size_t index);
+  frame_t* take(size_t index);
+
+private:
+  void run();
+  bool ahead(size_t index) const;
+  ItemData *m_item_data;
+  std::vector<size_t> m_start; // slice of the first frame
+  std::vector<size_t> m_count;
+  size_t m_dim; // played dimension
+  size_t m_size; // size of the played dimension
+  size_t m_nbr_ahead;
+  bool m_format; // format frames as text
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop;
+  size_t m_target; // next index to show
+  std::map<size_t, frame_t*> m_frames; // ready frames by index
+  std::set<size_t> m_busy; // indices being prepared
+  std::vector<std::thread> m_threads;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::ChildWindow
+///////////////////////////////////////////////////////////////////////////////////////
+
+ChildWindow::ChildWindow(QWidget *parent, ItemData *item_data, size_t nbr_dmn_view) :
+QMainWindow(parent),
+m_item_data_owned(false),
+m_file(new ncfile_t),
+m_item_data(item_data),
+m_ncvar(item_data->m_ncvar)
+{
+  QString str;
+
+  item_data->m_nbr_windows++;
+
+  str.sprintf(" : %s", item_data->m_item_nm.c_str());
+  this->setWindowTitle(last_component(item_data->m_file_name.c_str()) + str);
+
+  //currently selected layers for dimensions before the displayed ones (the last two for grids) are the first layer
+  if(m_ncvar->m_ncdim.size() > nbr_dmn_view)
+  {
+    for(size_t idx_dmn = 0; idx_dmn < m_ncvar->m_ncdim.size() - nbr_dmn_view; idx_dmn++)
+    {
+      m_layer.push_back(0);
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //export
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_tool_bar_data = addToolBar(tr("Data"));
+  QAction *action_export = new QAction(tr("&Export..."), this);
+  action_export->setStatusTip(tr("Export the current slice, the selection or the whole variable"));
+  connect(action_export, SIGNAL(triggered()), this, SLOT(export_data()));
+  m_tool_bar_data->addAction(action_export);
+  m_action_subset = new QAction(tr("Save &Subset..."), this);
+  m_action_subset->setStatusTip(tr("Save a part of the variable to a new netCDF-4 file, rechunked and compressed"));
+  m_action_subset->setEnabled(m_ncvar->m_user == NULL);
+  connect(m_action_subset, SIGNAL(triggered()), this, SLOT(save_subset()));
+  m_tool_bar_data->addAction(m_action_subset);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //series at the current cell along a layer dimension
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  QAction *action_series = new QAction(tr("&Series..."), this);
+  action_series->setStatusTip(tr("Show the values along a layer dimension at the current cell"));
+  action_series->setEnabled(m_ncvar->m_ncdim.size() > 2 && nbr_dmn_view == 2 && m_ncvar->m_user == NULL);
+  connect(action_series, SIGNAL(triggered()), this, SLOT(extract_series()));
+  m_tool_bar_data->addAction(action_series);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //find panel (hidden)
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_find_panel = new FindPanel(this, item_data);
+  addDockWidget(Qt::BottomDockWidgetArea, m_find_panel);
+  m_find_panel->hide();
+  m_action_find = m_find_panel->toggleViewAction();
+  m_action_find->setText(tr("&Find..."));
+  m_action_find->setShortcut(QKeySequence::Find);
+  m_action_find->setStatusTip(tr("Find values in the variable"));
+  m_tool_bar_data->addAction(m_action_find);
+
+  QSignalMapper *signal_mapper_next = NULL;
+  QSignalMapper *signal_mapper_previous = NULL;
+  QSignalMapper *signal_mapper_combo = NULL;
+  QSignalMapper *signal_mapper_value = NULL;
+  //data has layers
+  if(!m_layer.empty())
+  {
+    m_tool_bar = addToolBar(tr("Layers"));
+    signal_mapper_next = new QSignalMapper(this);
+    signal_mapper_previous = new QSignalMapper(this);
+    signal_mapper_combo = new QSignalMapper(this);
+    signal_mapper_value = new QSignalMapper(this);
+    connect(signal_mapper_next, SIGNAL(mapped(int)), this, SLOT(next_layer(int)));
+    connect(signal_mapper_previous, SIGNAL(mapped(int)), this, SLOT(previous_layer(int)));
+    connect(signal_mapper_combo, SIGNAL(mapped(int)), this, SLOT(combo_layer(int)));
+    connect(signal_mapper_value, SIGNAL(mapped(int)), this, SLOT(go_to_value(int)));
+  }
+
+  //number of dimensions above a two-dimensional dataset
+  for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+  {
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //next layer
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    QAction *action_next  = new QAction(tr("&Next layer..."), this);
+    action_next->setIcon(QIcon(":/images/right.png"));
+    action_next->setStatusTip(tr("Next layer"));
+    connect(action_next, SIGNAL(triggered()), signal_mapper_next, SLOT(map()));
+    signal_mapper_next->setMapping(action_next, idx_dmn);
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //previous layer
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    QAction *action_previous = new QAction(tr("&Previous layer..."), this);
+    action_previous->setIcon(QIcon(":/images/left.png"));
+    action_previous->setStatusTip(tr("Previous layer"));
+    connect(action_previous, SIGNAL(triggered()), signal_mapper_previous, SLOT(map()));
+    signal_mapper_previous->setMapping(action_previous, idx_dmn);
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //add to toolbar
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    m_tool_bar->addAction(action_next);
+    m_tool_bar->addAction(action_previous);
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //add combo box with layers and store combo in vector; labels are coordinate values (or layer
+    //numbers) formatted by the model only when the combo displays them
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    QComboBox *combo = new QComboBox;
+    QFont font = combo->font();
+    font.setPointSize(9);
+    combo->setFont(font);
+    combo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    combo->setMinimumContentsLength(12);
+    combo->setMaxVisibleItems(20);
+    QListView *view = qobject_cast<QListView *>(combo->view());
+    if(view)
+    {
+      view->setUniformItemSizes(true);
+    }
+    combo->setModel(new LayerModel(combo, item_data->m_ncvar_crd[idx_dmn], item_data->m_ncvar->m_ncdim[idx_dmn].m_size));
+    connect(combo, SIGNAL(currentIndexChanged(int)), signal_mapper_combo, SLOT(map()));
+    signal_mapper_combo->setMapping(combo, idx_dmn);
+    m_tool_bar->addWidget(combo);
+    m_vec_combo.push_back(combo);
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //go to a coordinate value (nearest layer), or to a layer number if there is no coordinate variable
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    QLineEdit *edit = new QLineEdit;
+    edit->setFont(font);
+    edit->setMaximumWidth(100);
+    edit->setPlaceholderText(tr("go to %1").arg(item_data->m_ncvar->m_ncdim[idx_dmn].m_name.c_str()));
+    edit->setStatusTip(tr("Go to the layer nearest to a coordinate value"));
+    connect(edit, SIGNAL(returnPressed()), signal_mapper_value, SLOT(map()));
+    signal_mapper_value->setMapping(edit, idx_dmn);
+    m_tool_bar->addWidget(edit);
+    m_vec_edit.push_back(edit);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //playback of a layer dimension
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_pipeline = NULL;
+  m_play_timer = NULL;
+  if(!m_layer.empty() && m_ncvar->m_user == NULL)
+  {
+    m_tool_bar_play = addToolBar(tr("Playback"));
+    m_action_play = new QAction(tr("&Play"), this);
+    m_action_play->setStatusTip(tr("Step a layer dimension at a fixed frame rate"));
+    m_action_play->setCheckable(true);
+    connect(m_action_play, SIGNAL(toggled(bool)), this, SLOT(play(bool)));
+    m_tool_bar_play->addAction(m_action_play);
+
+    m_combo_play = new QComboBox;
+    for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+    {
+      m_combo_play->addItem(QString::fromStdString(m_ncvar->m_ncdim[idx_dmn].m_name));
+    }
+    m_combo_play->setStatusTip(tr("Dimension to play"));
+    m_tool_bar_play->addWidget(m_combo_play);
+
+    m_spin_fps = new QSpinBox;
+    m_spin_fps->setRange(1, 60);
+    m_spin_fps->setValue(10);
+    m_spin_fps->setSuffix(tr(" fps"));
+    m_spin_fps->setStatusTip(tr("Target frame rate"));
+    m_tool_bar_play->addWidget(m_spin_fps);
+
+    m_label_fps = new QLabel;
+    m_label_fps->setMinimumWidth(140);
+    m_tool_bar_play->addWidget(m_label_fps);
+
+    m_play_timer = new QTimer(this);
+    connect(m_play_timer, SIGNAL(timeout()), this, SLOT(play_tick()));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::~ChildWindow
+///////////////////////////////////////////////////////////////////////////////////////
+
+ChildWindow::~ChildWindow()
+{
+  delete m_pipeline;
+  delete m_file;
+  //the inflated chunks serve the other windows on the variable until the last one closes
+  if(--m_item_data->m_nbr_windows == 0 && m_item_data->m_chunk_cache != NULL)
+  {
+    m_item_data->m_chunk_cache->clear();
+  }
+  if(m_item_data_owned)
+  {
+    //views and panels use the variable until they are destroyed: destroy them before it, not after
+    //this destructor as QWidget would
+    delete centralWidget();
+    QList<QDockWidget*> docks = findChildren<QDockWidget*>(QString(), Qt::FindDirectChildrenOnly);
+    for(int idx = 0; idx < docks.size(); idx++)
+    {
+      delete docks.at(idx);
+    }
+    delete m_item_data;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::previous_layer
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::previous_layer(int idx_layer)
+{
+  m_layer[idx_layer]--;
+  if(m_layer[idx_layer] < 0)
+  {
+    m_layer[idx_layer] = 0;
+    return;
+  }
+  QComboBox *combo = m_vec_combo.at(idx_layer);
+  combo->setCurrentIndex(m_layer[idx_layer]);
+  update();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::next_layer
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::next_layer(int idx_layer)
+{
+  m_layer[idx_layer]++;
+  if((size_t)m_layer[idx_layer] >= m_ncvar->m_ncdim[idx_layer].m_size)
+  {
+    m_layer[idx_layer] = m_ncvar->m_ncdim[idx_layer].m_size - 1;
+    return;
+  }
+  QComboBox *combo = m_vec_combo.at(idx_layer);
+  combo->setCurrentIndex(m_layer[idx_layer]);
+  update();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::combo_layer
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::combo_layer(int idx_layer)
+{
+  QComboBox *combo = m_vec_combo.at(idx_layer);
+  m_layer[idx_layer] = combo->currentIndex();;
+  m_item_data->m_dim_step = idx_layer;
+  update();
+  emit layer_changed();
+
+  //playback continues from the selected layers
+  if(m_pipeline != NULL)
+  {
+    play(true);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::linked_layer
+//layer of this window after the layer dimensions 'dims' moved to 'layers' in a linked window;
+//returns false if no dimension is shared or the layer does not change
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool ChildWindow::linked_layer(const std::vector<std::string> &dims, const std::vector<int> &layers,
+  std::vector<int> &layer) const
+{
+  layer = m_layer;
+  for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+  {
+    const ncdim_t &ncdim = m_ncvar->m_ncdim[idx_dmn];
+    for(size_t idx_lnk = 0; idx_lnk < dims.size(); idx_lnk++)
+    {
+      if(dims[idx_lnk] == ncdim.m_name && (size_t)layers[idx_lnk] < ncdim.m_size)
+      {
+        layer[idx_dmn] = layers[idx_lnk];
+      }
+    }
+  }
+  return layer != m_layer;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::prefetch
+//read the slice of a layer of a variable that is not loaded, to be used by read_slice once the window
+//shows that layer; the read itself spreads the chunks of the slice over the I/O threads
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::prefetch(const std::vector<int> &layer)
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+  ncfile_t file;
+  size_t nbr = 1;
+
+  if(m_ncvar->m_buf != NULL || !is_numeric(m_ncvar->m_nc_type) ||
+    (layer == m_prefetch_layer && !m_prefetch.empty()))
+  {
+    return;
+  }
+
+  slice_hyperslab(start, count);
+  for(size_t idx_dmn = 0; idx_dmn < layer.size(); idx_dmn++)
+  {
+    start[idx_dmn] = layer[idx_dmn];
+  }
+  for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
+  {
+    nbr *= count[idx_dmn];
+  }
+  m_prefetch.resize(nbr * nc_type_size(m_ncvar->m_nc_type));
+  m_prefetch_layer = layer;
+  if(read_hyperslab(m_item_data, file, start, count, m_prefetch.data()) != NC_NOERR)
+  {
+    m_prefetch.clear();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::set_layer
+//show a layer, as if it were selected in the combo boxes
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::set_layer(const std::vector<int> &layer)
+{
+  m_layer = layer;
+  for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+  {
+    m_vec_combo[idx_dmn]->blockSignals(true);
+    m_vec_combo[idx_dmn]->setCurrentIndex(m_layer[idx_dmn]);
+    m_vec_combo[idx_dmn]->blockSignals(false);
+  }
+  update();
+  emit layer_changed();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::play
+//start (or restart from the current layers) or stop playback; frames are prepared ahead by a
+//pipeline of worker threads, the timer only shows frames that are ready
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::play(bool on)
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+
+  delete m_pipeline;
+  m_pipeline = NULL;
+  m_play_timer->stop();
+  m_combo_play->setEnabled(!on);
+  if(!on)
+  {
+    m_label_fps->clear();
+    return;
+  }
+
+  m_play_dim = m_combo_play->currentIndex();
+  m_item_data->m_dim_step = (int)m_play_dim;
+  m_play_start = m_layer[m_play_dim];
+  m_play_shown = m_play_start;
+  m_play_frames = 0;
+  m_play_dropped = 0;
+  m_play_times.clear();
+  slice_hyperslab(start, count);
+  m_pipeline = new frame_pipeline_t(m_item_data, start, count, m_play_dim, 8, frame_text());
+  m_pipeline->set_target((m_play_start + 1) % m_ncvar->m_ncdim[m_play_dim].m_size);
+  m_play_clock.start();
+  m_play_timer->start(std::max(1, 500 / m_spin_fps->value()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::play_tick
+//show the frame due at the elapsed time, if it is ready; frames that are late are dropped, so that
+//slow frames never hold back playback
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::play_tick()
+{
+  size_t size = m_ncvar->m_ncdim[m_play_dim].m_size;
+  qint64 elapsed = m_play_clock.elapsed();
+  size_t target = (m_play_start + (size_t)(elapsed * m_spin_fps->value() / 1000)) % size;
+  if(target == m_play_shown)
+    return;
+
+  frame_t *frame = m_pipeline->take(target);
+  if(frame == NULL)
+  {
+    m_pipeline->set_target(target);
+    return;
+  }
+
+  m_play_dropped += (target + size - m_play_shown) % size - 1;
+  m_play_shown = target;
+  m_play_frames++;
+  m_layer[m_play_dim] = (int)target;
+  m_vec_combo[m_play_dim]->blockSignals(true);
+  m_vec_combo[m_play_dim]->setCurrentIndex((int)target);
+  m_vec_combo[m_play_dim]->blockSignals(false);
+  show_frame(frame);
+  delete frame;
+  m_pipeline->set_target((target + 1) % size);
+  emit layer_changed();
+
+  //frame rate over the last second
+  m_play_times.push_back(elapsed);
+  while(m_play_times.front() < elapsed - 1000)
+  {
+    m_play_times.pop_front();
+  }
+  QString str;
+  str.sprintf("%.1f fps, %u dropped", m_play_times.size() * 1000.0 / std::max((qint64)1, std::min(elapsed, (qint64)1000)),
+    (unsigned)m_play_dropped);
+  m_label_fps->setText(str);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::frame_text
+//whether playback frames include the slice formatted as text (views that show text)
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool ChildWindow::frame_text() const
+{
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::show_frame
+//show a playback frame (m_layer is already set); the slice read ahead is used by read_slice
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::show_frame(frame_t *frame)
+{
+  if(m_ncvar->m_buf == NULL && frame->m_ok && !frame->m_slice.empty())
+  {
+    m_prefetch.swap(frame->m_slice);
+    m_prefetch_layer = m_layer;
+  }
+  update();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::go_to_value
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::go_to_value(int idx_layer)
+{
+  bool ok;
+  double value = m_vec_edit.at(idx_layer)->text().toDouble(&ok);
+  ncvar_t *ncvar_crd = m_item_data->m_ncvar_crd[idx_layer];
+  size_t size = m_ncvar->m_ncdim[idx_layer].m_size;
+  size_t idx;
+  if(!ok || size == 0)
+  {
+    statusBar()->showMessage(tr("Invalid value"), 2000);
+    return;
+  }
+  if(ncvar_crd != NULL && ncvar_crd->m_buf != NULL && is_numeric(ncvar_crd->m_nc_type))
+  {
+    idx = nearest_index(ncvar_crd, value);
+  }
+  else
+  {
+    //layer numbers are 1-based
+    idx = (size_t)std::max(0.0, std::min((double)size - 1, value - 1));
+  }
+  m_vec_combo.at(idx_layer)->setCurrentIndex((int)idx);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::slice_hyperslab
+//hyperslab of the displayed 2D slice: the current layer of each layer dimension, all rows and columns
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::slice_hyperslab(std::vector<size_t> &start, std::vector<size_t> &count) const
+{
+  size_t nbr_dmn = m_ncvar->m_ncdim.size();
+  start.assign(nbr_dmn, 0);
+  count.resize(nbr_dmn);
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(idx_dmn < m_layer.size())
+    {
+      start[idx_dmn] = m_layer[idx_dmn];
+      count[idx_dmn] = 1;
+    }
+    else
+    {
+      count[idx_dmn] = m_ncvar->m_ncdim[idx_dmn].m_size;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::read_slice
+//the displayed slice as a contiguous buffer: a pointer into the loaded buffer when there is one (the
+//slice covers whole trailing dimensions, so it is contiguous) or to the prefetched slice, otherwise
+//read from the file into 'buf' (the file stays open between slices, for the chunk cache)
+///////////////////////////////////////////////////////////////////////////////////////
+
+const void* ChildWindow::read_slice(std::vector<char> &buf, size_t &nbr) const
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+  size_t elem_sz = nc_type_size(m_ncvar->m_nc_type);
+  size_t off = 0;
+
+  slice_hyperslab(start, count);
+  nbr = 1;
+  for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
+  {
+    nbr *= count[idx_dmn];
+    off = off * m_ncvar->m_ncdim[idx_dmn].m_size + start[idx_dmn];
+  }
+
+  if(m_ncvar->m_buf != NULL)
+  {
+    return static_cast<const char*>(m_ncvar->m_buf) + off * elem_sz;
+  }
+
+  //read in a batch of linked windows
+  if(!m_prefetch.empty() && m_prefetch_layer == m_layer)
+  {
+    return m_prefetch.data();
+  }
+
+  buf.resize(nbr * elem_sz);
+  if(read_hyperslab(m_item_data, *m_file, start, count, buf.data()) != NC_NOERR)
+  {
+    nbr = 0;
+    return NULL;
+  }
+  return buf.data();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::go_to
+//show the slice that contains an element (index in all dimensions) and make the element visible
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::go_to(const std::vector<size_t> &index)
+{
+  grid_policy_t *grid_policy = m_item_data->m_grid_policy;
+  for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+  {
+    m_layer[idx_dmn] = (int)index[idx_dmn];
+    m_vec_combo[idx_dmn]->setCurrentIndex(m_layer[idx_dmn]);
+  }
+  int row = grid_policy->m_dim_rows == -1 ? 0 : (int)index[grid_policy->m_dim_rows];
+  int col = grid_policy->m_dim_cols == -1 ? 0 : (int)index[grid_policy->m_dim_cols];
+  show_cell(row, col);
+  update();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::show_cell
+//make a row and column of the displayed slice visible (views without cells do nothing)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::show_cell(int, int)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::selected_range
+//selected rows and columns of the displayed slice, if any (views without a selection return false)
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool ChildWindow::selected_range(int &, int &, int &, int &) const
+{
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::choose_hyperslab
+//ask for the part of the variable to export or save: the current slice, the selected range or the
+//whole variable; false if canceled
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool ChildWindow::choose_hyperslab(const QString &title, std::vector<size_t> &start, std::vector<size_t> &count)
+{
+  int row;
+  int nbr_rows;
+  int col;
+  int nbr_cols;
+  QStringList scopes;
+  bool ok;
+
+  scopes << tr("Current slice");
+  if(selected_range(row, nbr_rows, col, nbr_cols))
+  {
+    scopes << tr("Selected range");
+  }
+  scopes << tr("Whole variable");
+
+  QString scope = QInputDialog::getItem(this, title, title, scopes, 0, false, &ok);
+  if(!ok)
+    return false;
+
+  slice_hyperslab(start, count);
+  if(scope == tr("Whole variable"))
+  {
+    for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+    {
+      start[idx_dmn] = 0;
+      count[idx_dmn] = m_ncvar->m_ncdim[idx_dmn].m_size;
+    }
+  }
+  else if(scope == tr("Selected range"))
+  {
+    grid_policy_t *grid_policy = m_item_data->m_grid_policy;
+    if(grid_policy->m_dim_rows != -1)
+    {
+      start[grid_policy->m_dim_rows] = row;
+      count[grid_policy->m_dim_rows] = nbr_rows;
+    }
+    if(grid_policy->m_dim_cols != -1)
+    {
+      start[grid_policy->m_dim_cols] = col;
+      count[grid_policy->m_dim_cols] = nbr_cols;
+    }
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::export_data
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::export_data()
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+
+  if(!choose_hyperslab(tr("Export"), start, count))
+    return;
+
+  QString filter_csv = tr("CSV (*.csv)");
+  QString filter_bin = tr("Raw little-endian binary (*.bin)");
+  QString filter_npy = tr("NumPy array (*.npy)");
+  QString filter;
+  QString file_name = QFileDialog::getSaveFileName(this,
+    tr("Export"), QString::fromStdString(m_ncvar->m_name),
+    filter_csv + ";;" + filter_bin + ";;" + filter_npy, &filter);
+
+  if(file_name.isEmpty())
+    return;
+
+  int format = ExportCSV;
+  if(filter == filter_bin)
+  {
+    format = ExportBinary;
+  }
+  else if(filter == filter_npy)
+  {
+    format = ExportNumpy;
+  }
+
+  export_hyperslab(m_item_data, start, count, format, file_name, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::save_subset
+//save a part of the variable to a new netCDF-4 file, with the chunk shape and compression chosen
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::save_subset()
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+  std::vector<size_t> chunks;
+  std::string error;
+
+  if(!choose_hyperslab(tr("Save Subset"), start, count))
+    return;
+
+  //chunk shape and compression
+  QDialog dialog(this);
+  QFormLayout *layout = new QFormLayout(&dialog);
+  QLineEdit *edit_chunks = new QLineEdit(&dialog);
+  QSpinBox *spin_level = new QSpinBox(&dialog);
+  QCheckBox *check_shuffle = new QCheckBox(tr("Shuffle bytes before deflating"), &dialog);
+  QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  QStringList sizes;
+  chunks = default_chunks(count);
+  for(size_t idx_dmn = 0; idx_dmn < chunks.size(); idx_dmn++)
+  {
+    sizes << QString::number(chunks[idx_dmn]);
+  }
+  dialog.setWindowTitle(tr("Save Subset"));
+  edit_chunks->setText(sizes.join(","));
+  edit_chunks->setEnabled(!chunks.empty());
+  spin_level->setRange(0, 9);
+  spin_level->setValue(4);
+  spin_level->setSpecialValueText(tr("None"));
+  check_shuffle->setChecked(true);
+  layout->addRow(tr("Chunk shape"), edit_chunks);
+  layout->addRow(tr("Deflate level"), spin_level);
+  layout->addRow(QString(), check_shuffle);
+  layout->addRow(buttons);
+  connect(buttons, SIGNAL(accepted()), &dialog, SLOT(accept()));
+  connect(buttons, SIGNAL(rejected()), &dialog, SLOT(reject()));
+  if(dialog.exec() != QDialog::Accepted)
+    return;
+  if(!parse_shape(edit_chunks->text(), chunks) || chunks.size() != count.size())
+  {
+    QMessageBox::warning(this, tr("Save Subset"), tr("The chunk shape needs one size per dimension."));
+    return;
+  }
+
+  QString file_name = QFileDialog::getSaveFileName(this,
+    tr("Save Subset"), QString::fromStdString(m_ncvar->m_name) + ".nc", tr("netCDF (*.nc)"));
+  if(file_name.isEmpty())
+    return;
+
+  QProgressDialog progress(tr("Saving %1...").arg(QString::fromStdString(m_ncvar->m_name)), tr("Cancel"), 0, 1000, this);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(500);
+  if(!write_subset(m_item_data, start, count, chunks, spin_level->value(), check_shuffle->isChecked(),
+    file_name.toStdString(), error, &progress) && !error.empty())
+  {
+    QMessageBox::warning(this, tr("Save Subset"), QString::fromStdString(error));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//ChildWindow::extract_series
+//values along a layer dimension at the current cell, shown in a new window; the series is read with
+//one strided read and is not part of the tree, so the new window owns it
+///////////////////////////////////////////////////////////////////////////////////////
+
+void ChildWindow::extract_series()
+{
+  std::vector<size_t> start;
+  std::vector<size_t> count;
+  grid_policy_t *grid_policy = m_item_data->m_grid_policy;
+  MainWindow *main_window = qobject_cast<MainWindow*>(window());
+  int row = 0;
+  int nbr_rows;
+  int col = 0;
+  int nbr_cols;
+  size_t dim = 0;
+  ncfile_t file;
+  QString str;
+
+  if(m_layer.empty() || main_window == NULL)
+    return;
+
+  if(!selected_range(row, nbr_rows, col, nbr_cols))
+  {
+    statusBar()->showMessage(tr("Select a cell"), 2000);
+    return;
+  }
+
+  //choose the dimension if there is more than one layer dimension
+  if(m_layer.size() > 1)
+  {
+    QStringList dims;
+    bool ok;
+    for(size_t idx_dmn = 0; idx_dmn < m_layer.size(); idx_dmn++)
+    {
+      dims << QString::fromStdString(m_ncvar->m_ncdim[idx_dmn].m_name);
+    }
+    QString name = QInputDialog::getItem(this, tr("Series"), tr("Dimension"), dims, 0, false, &ok);
+    if(!ok)
+      return;
+    dim = dims.indexOf(name);
+  }
+
+  slice_hyperslab(start, count);
+  if(grid_policy->m_dim_rows != -1)
+  {
+    start[grid_policy->m_dim_rows] = row;
+  }
+  if(grid_policy->m_dim_cols != -1)
+  {
+    start[grid_policy->m_dim_cols] = col;
+  }
+
+  const ncdim_t &ncdim = m_ncvar->m_ncdim[dim];
+  void *buf = malloc(ncdim.m_size * nc_type_size(m_ncvar->m_nc_type));
+  if(buf == NULL)
+    return;
+  if(read_series(m_item_data, file, start, dim, buf) != NC_NOERR)
+  {
+    free(buf);
+    statusBar()->showMessage(tr("Cannot read the series"), 2000);
+    return;
+  }
+
+  //name the series by the variable and the index of the other dimensions
+  std::string name = m_ncvar->m_name + "(";
+  for(size_t idx_dmn = 0; idx_dmn < start.size(); idx_dmn++)
+  {
+    if(idx_dmn == dim)
+    {
+      str.sprintf("%s%s=:", idx_dmn ? "," : "", m_ncvar->m_ncdim[idx_dmn].m_name.c_str());
+    }
+    else
+    {
+      str.sprintf("%s%s=%u", idx_dmn ? "," : "", m_ncvar->m_ncdim[idx_dmn].m_name.c_str(), (unsigned)start[idx_dmn]);
+    }
+    name += str.toStdString();
+  }
+  name += ")";
+
+  std::vector<ncdim_t> ncdim_series(1, ncdim);
+  ncvar_t *ncvar = new ncvar_t(name.c_str(), m_ncvar->m_nc_type, ncdim_series);
+  if(m_ncvar->m_nc_type == NC_STRING)
+  {
+    buf = string_arena(static_cast<char**>(buf), ncdim.m_size);
+  }
+  ncvar->store(buf);
+  ItemData *item_data = new ItemData(ItemData::Variable, m_item_data->m_file_name, m_item_data->m_grp_nm_fll,
+    name, m_item_data->m_item_data_prn, ncvar, new grid_policy_t(ncdim_series));
+  item_data->m_ncvar_crd.push_back(m_item_data->m_ncvar_crd[dim]);
+  main_window->add_table(item_data, true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::TableWidget
+///////////////////////////////////////////////////////////////////////////////////////
+
+TableWidget::TableWidget(QWidget *parent, ItemData *item_data) :
+QTableWidget(parent),
+m_item_data(item_data),
+m_ncvar(item_data->m_ncvar),
+m_dim_rows(item_data->m_grid_policy->m_dim_rows),
+m_dim_cols(item_data->m_grid_policy->m_dim_cols),
+m_ncvar_crd(item_data->m_ncvar_crd),
+m_slice_data(NULL),
+m_slice_nbr(0),
+m_shown(false)
+{
+  setWindowTitle(QString::fromStdString(item_data->m_item_nm));
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  //define grid
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if(m_ncvar->m_ncdim.size() == 0)
+  {
+    m_nbr_rows = 1;
+    m_nbr_cols = 1;
+  }
+  else if(m_ncvar->m_ncdim.size() == 1)
+  {
+    assert(m_dim_rows == 0);
+    m_nbr_rows = m_ncvar->m_ncdim[m_dim_rows].m_size;
+    m_nbr_cols = 1;
+  }
+  else
+  {
+    m_nbr_rows = m_ncvar->m_ncdim[m_dim_rows].m_size;
+    m_nbr_cols = m_ncvar->m_ncdim[m_dim_cols].m_size;
+  }
+
+  //compound variables have a column for each member
+  m_nbr_fields = 1;
+  if(m_ncvar->m_user != NULL && m_ncvar->m_user->m_class == NC_COMPOUND && !m_ncvar->m_user->m_fields.empty())
+  {
+    m_nbr_fields = (int)m_ncvar->m_user->m_fields.size();
+  }
+  setRowCount(m_nbr_rows);
+  setColumnCount(m_nbr_cols * m_nbr_fields);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//get_format
+//Provide sprintf() format string for specified netCDF type
+//Based on NCO utilities
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const char* get_format(const nc_type typ)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    return "%g";
+  case NC_DOUBLE:
+    return "%.12g";
+  case NC_INT:
+    return "%i";
+  case NC_SHORT:
+    return "%hi";
+  case NC_CHAR:
+    return "%c";
+  case NC_BYTE:
+    return "%hhi";
+  case NC_UBYTE:
+    return "%hhu";
+  case NC_USHORT:
+    return "%hu";
+  case NC_UINT:
+    return "%u";
+  case NC_INT64:
+    return "%lli";
+  case NC_UINT64:
+    return "%llu";
+  case NC_STRING:
+    return "%s";
+  }
+  return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//format_value
+//sprintf() element 'idx' of a buffer of netCDF type 'typ' into 'str' (with at most 'len' characters);
+//returns the number of characters written
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int format_value(char *str, size_t len, const void *buf, const nc_type typ, size_t idx)
+{
+  int nbr = 0;
+  switch(typ)
+  {
+  case NC_FLOAT:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const float*>(buf)[idx]);
+    break;
+  case NC_DOUBLE:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const double*>(buf)[idx]);
+    break;
+  case NC_INT:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const int*>(buf)[idx]);
+    break;
+  case NC_SHORT:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const short*>(buf)[idx]);
+    break;
+  case NC_CHAR:
+    if(static_cast<const char*>(buf)[idx] != '\0')
+    {
+      nbr = snprintf(str, len, get_format(typ), static_cast<const char*>(buf)[idx]);
+    }
+    break;
+  case NC_BYTE:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const signed char*>(buf)[idx]);
+    break;
+  case NC_UBYTE:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const unsigned char*>(buf)[idx]);
+    break;
+  case NC_USHORT:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const unsigned short*>(buf)[idx]);
+    break;
+  case NC_UINT:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const unsigned int*>(buf)[idx]);
+    break;
+  case NC_INT64:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const long long*>(buf)[idx]);
+    break;
+  case NC_UINT64:
+    nbr = snprintf(str, len, get_format(typ), static_cast<const unsigned long long*>(buf)[idx]);
+    break;
+  case NC_STRING:
+    nbr = snprintf(str, len, get_format(typ), static_cast<char* const*>(buf)[idx]);
+    break;
+  }
+  //snprintf returns the length that would have been written
+  return std::max(0, std::min(nbr, (int)len - 1));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//npy_descr
+//NumPy dtype description of a netCDF type (little-endian)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const char* npy_descr(const nc_type typ)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    return "<f4";
+  case NC_DOUBLE:
+    return "<f8";
+  case NC_INT:
+    return "<i4";
+  case NC_SHORT:
+    return "<i2";
+  case NC_CHAR:
+    return "|S1";
+  case NC_BYTE:
+    return "|i1";
+  case NC_UBYTE:
+    return "|u1";
+  case NC_USHORT:
+    return "<u2";
+  case NC_UINT:
+    return "<u4";
+  case NC_INT64:
+    return "<i8";
+  case NC_UINT64:
+    return "<u8";
+  }
+  return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//npy_header
+//NumPy .npy version 1.0 header: magic, header length and a dictionary padded to 64 bytes
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+QByteArray npy_header(const nc_type typ, const std::vector<size_t> &shape)
+{
+  QByteArray dict("{'descr': '");
+  dict += npy_descr(typ);
+  dict += "', 'fortran_order': False, 'shape': (";
+  for(size_t idx_dmn = 0; idx_dmn < shape.size(); idx_dmn++)
+  {
+    dict += QByteArray::number((qulonglong)shape[idx_dmn]);
+    dict += (shape.size() == 1 ? ",)" : (idx_dmn + 1 < shape.size() ? ", " : ")"));
+  }
+  if(shape.size() == 0)
+  {
+    dict += ")";
+  }
+  dict += ", }";
+  //magic (6) + version (2) + header length (2) + dictionary + newline, multiple of 64
+  int pad = 64 - (10 + dict.size() + 1) % 64;
+  if(pad == 64)
+  {
+    pad = 0;
+  }
+  dict += QByteArray(pad, ' ');
+  dict += '\n';
+  QByteArray header("\x93NUMPY\x01\x00", 8);
+  header += (char)(dict.size() & 0xff);
+  header += (char)((dict.size() >> 8) & 0xff);
+  header += dict;
+  return header;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//swap_bytes
+//reverse the byte order of 'nbr' elements of size 'elem_sz'
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void swap_bytes(void *buf, size_t nbr, size_t elem_sz)
+{
+  unsigned char *ptr = static_cast<unsigned char*>(buf);
+  for(size_t idx = 0; idx < nbr; idx++, ptr += elem_sz)
+  {
+    std::reverse(ptr, ptr + elem_sz);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//export_hyperslab
+//write a hyperslab of a variable to CSV, raw little-endian binary or NumPy .npy
+//the hyperslab is streamed in blocks of at most max_elem elements, using one data buffer and
+//one text buffer, so memory use does not depend on the variable size
+//CSV: one line per element of the next to last dimension, an empty line between 2D slices
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool export_hyperslab(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  int format, const QString &file_name, QWidget *parent)
+{
+  const size_t max_elem = 1 << 20;
+  const size_t max_text = 1 << 22;
+  ncvar_t *ncvar = item_data->m_ncvar;
+  nc_type typ = ncvar->m_nc_type;
+  size_t elem_sz = nc_type_size(typ);
+  size_t nbr_dmn = count.size();
+  std::vector<size_t> blk_start;
+  std::vector<size_t> blk_count;
+  ncfile_t nc_file;
+
+  if(elem_sz == 0 || (format != ChildWindow::ExportCSV && typ == NC_STRING))
+  {
+    QMessageBox::warning(parent, QObject::tr("Export"), QObject::tr("This format does not support the variable type"));
+    return false;
+  }
+
+  QFile file(file_name);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    QMessageBox::warning(parent, QObject::tr("Export"), QObject::tr("Cannot write %1").arg(file_name));
+    return false;
+  }
+
+  if(format == ChildWindow::ExportNumpy)
+  {
+    QByteArray header = npy_header(typ, count);
+    if(file.write(header) != header.size())
+    {
+      QMessageBox::warning(parent, QObject::tr("Export"), QObject::tr("Cannot write %1").arg(file_name));
+      file.close();
+      file.remove();
+      return false;
+    }
+  }
+
+  size_t nbr_total = 1;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    nbr_total *= count[idx_dmn];
+  }
+  size_t nbr_col = nbr_dmn ? count[nbr_dmn - 1] : 1; //elements per CSV line
+  size_t nbr_slice = nbr_dmn >= 2 ? count[nbr_dmn - 1] * count[nbr_dmn - 2] : 0; //elements per 2D slice
+
+  QProgressDialog progress(QObject::tr("Exporting %1...").arg(QString::fromStdString(ncvar->m_name)),
+    QObject::tr("Cancel"), 0, 1000, parent);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(500);
+
+  std::vector<char> buf(std::min(max_elem, nbr_total) * elem_sz);
+  std::vector<char> text(format == ChildWindow::ExportCSV ? max_text : 0);
+  size_t len = 0;
+  size_t nbr_done = 0;
+  slab_iterator_t iter(start, count, max_elem);
+  bool ok = true;
+  bool written = true;
+  while(ok && iter.next(blk_start, blk_count))
+  {
+    size_t nbr = 1;
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      nbr *= blk_count[idx_dmn];
+    }
+
+    if(read_hyperslab(item_data, nc_file, blk_start, blk_count, &buf[0]) != NC_NOERR)
+    {
+      QMessageBox::warning(parent, QObject::tr("Export"), QObject::tr("Cannot read %1").arg(QString::fromStdString(ncvar->m_name)));
+      ok = false;
+      break;
+    }
+
+    if(format == ChildWindow::ExportCSV)
+    {
+      perf_timer_t timer(perf_t::Format, ncvar->m_name);
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        size_t idx_out = nbr_done + idx + 1;
+        size_t need = 64;
+        if(typ == NC_STRING)
+        {
+          need = 2 * strlen(reinterpret_cast<char**>(&buf[0])[idx]) + 8;
+        }
+        if(len + need > text.size())
+        {
+          if(file.write(&text[0], len) != (qint64)len)
+          {
+            ok = written = false;
+            break;
+          }
+          len = 0;
+          if(need > text.size())
+          {
+            text.resize(need);
+          }
+        }
+        if(typ == NC_STRING)
+        {
+          //quote, doubling embedded quotes
+          const char *ptr = reinterpret_cast<char**>(&buf[0])[idx];
+          text[len++] = '"';
+          for(; *ptr; ptr++)
+          {
+            if(*ptr == '"')
+            {
+              text[len++] = '"';
+            }
+            text[len++] = *ptr;
+          }
+          text[len++] = '"';
+        }
+        else
+        {
+          len += format_value(&text[len], text.size() - len, &buf[0], typ, idx);
+        }
+        if(idx_out % nbr_col == 0)
+        {
+          text[len++] = '\n';
+          if(nbr_slice && idx_out % nbr_slice == 0 && idx_out < nbr_total)
+          {
+            text[len++] = '\n';
+          }
+        }
+        else
+        {
+          text[len++] = ',';
+        }
+      }
+      if(typ == NC_STRING)
+      {
+        nc_free_string(nbr, reinterpret_cast<char**>(&buf[0]));
+      }
+    }
+    else
+    {
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+      swap_bytes(&buf[0], nbr, elem_sz);
+#endif
+      if(file.write(&buf[0], nbr * elem_sz) != (qint64)(nbr * elem_sz))
+      {
+        ok = written = false;
+      }
+    }
+
+    nbr_done += nbr;
+    progress.setValue((int)(1000.0 * nbr_done / nbr_total));
+    if(progress.wasCanceled())
+    {
+      ok = false;
+    }
+  }
+
+  if(ok && len && file.write(&text[0], len) != (qint64)len)
+  {
+    ok = written = false;
+  }
+  file.close();
+  if(!written)
+  {
+    QMessageBox::warning(parent, QObject::tr("Export"), QObject::tr("Cannot write %1").arg(file_name));
+  }
+  if(!ok)
+  {
+    file.remove();
+  }
+  return ok;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//parse_shape
+//comma separated sizes or indices, e.g. "1,180,360"
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool parse_shape(const QString &text, std::vector<size_t> &shape)
+{
+  QStringList items = text.split(',', QString::SkipEmptyParts);
+  shape.clear();
+  for(int idx = 0; idx < items.size(); idx++)
+  {
+    bool ok;
+    shape.push_back((size_t)items.at(idx).trimmed().toULongLong(&ok));
+    if(!ok)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//default_chunks
+//chunk shape proposed for a subset: one 2D slice (the last two dimensions) per chunk
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t> default_chunks(const std::vector<size_t> &count)
+{
+  std::vector<size_t> chunks(count.size(), 1);
+  for(size_t idx_dmn = count.size() >= 2 ? count.size() - 2 : 0; idx_dmn < count.size(); idx_dmn++)
+  {
+    chunks[idx_dmn] = count[idx_dmn];
+  }
+  return chunks;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//write_subset
+//save a hyperslab of a variable to a new netCDF-4 file, with the attributes of the variable and the
+//loaded coordinate variables of its dimensions, chunked by 'chunks' and deflated at 'level' (0 for
+//none; bytes shuffled first if 'shuffle')
+//with the HDF5 library, the chunks of a numeric variable are read, shuffled and deflated on all
+//threads and written as they are (H5Dwrite_chunk), so that reads and compression overlap and only
+//the raw writes are serialized; otherwise the hyperslab is streamed in blocks through nc_put_vara,
+//which compresses one chunk at a time
+//'progress' (NULL for none) is updated from the calling thread; on failure the file is removed and
+//'error' says why (empty if canceled)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool write_subset(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  const std::vector<size_t> &chunks, int level, bool shuffle, const std::string &file_name, std::string &error,
+  QProgressDialog *progress)
+{
+  const size_t max_elem = 1 << 20;
+  ncvar_t *ncvar = item_data->m_ncvar;
+  nc_type typ = ncvar->m_nc_type;
+  size_t elem_sz = nc_type_size(typ);
+  size_t nbr_dmn = count.size();
+  std::vector<int> dim_ids(nbr_dmn);
+  std::vector<int> crd_ids(nbr_dmn, -1); // coordinate variables written (-1 for none)
+  std::vector<size_t> shape(nbr_dmn);
+  ncfile_t src;
+  int src_var_id = -1;
+  int nc_id;
+  int var_id = -1;
+  bool ok = true;
+
+  error.clear();
+  if(elem_sz == 0)
+  {
+    error = "the type of " + ncvar->m_name + " cannot be saved";
+    return false;
+  }
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(count[idx_dmn] == 0)
+    {
+      error = "the subset is empty";
+      return false;
+    }
+    shape[idx_dmn] = idx_dmn < chunks.size() ? chunks[idx_dmn] : count[idx_dmn];
+    shape[idx_dmn] = std::max((size_t)1, std::min(shape[idx_dmn], count[idx_dmn]));
+  }
+
+  //attributes are copied from the source file, for its variables
+  if(item_data->m_source == ItemData::SourceNetCDF && item_data->m_expr == NULL &&
+    src.open(item_data->m_file_name, item_data->m_grp_nm_fll) == NC_NOERR)
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_inq_varid(src.m_grp_id, item_data->m_item_nm.c_str(), &src_var_id) != NC_NOERR)
+    {
+      src_var_id = -1;
+    }
+  }
+  auto copy_attributes = [&](int src_id, int dst_id)
+  {
+    int nbr_att = 0;
+    char att_nm[NC_MAX_NAME + 1];
+    if(src_id == -1 || nc_inq_varnatts(src.m_grp_id, src_id, &nbr_att) != NC_NOERR)
+    {
+      return;
+    }
+    for(int idx_att = 0; idx_att < nbr_att; idx_att++)
+    {
+      if(nc_inq_attname(src.m_grp_id, src_id, idx_att, att_nm) == NC_NOERR)
+      {
+        nc_copy_att(src.m_grp_id, src_id, att_nm, nc_id, dst_id);
+      }
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //define dimensions, coordinate variables (written from their loaded buffers) and the variable
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_create(file_name.c_str(), NC_NETCDF4 | NC_CLOBBER, &nc_id) != NC_NOERR)
+    {
+      error = "cannot create " + file_name;
+      return false;
+    }
+    for(size_t idx_dmn = 0; ok && idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      std::string dmn_nm = ncvar->m_ncdim[idx_dmn].m_name;
+      if(dmn_nm.empty())
+      {
+        dmn_nm = "dim" + std::to_string(idx_dmn);
+      }
+      ok = nc_def_dim(nc_id, dmn_nm.c_str(), count[idx_dmn], &dim_ids[idx_dmn]) == NC_NOERR;
+      ncvar_t *ncvar_crd = idx_dmn < item_data->m_ncvar_crd.size() ? item_data->m_ncvar_crd[idx_dmn] : NULL;
+      if(ok && ncvar_crd != NULL && ncvar_crd != ncvar && ncvar_crd->m_buf != NULL &&
+        ncvar_crd->m_ncdim.size() == 1 && is_numeric(ncvar_crd->m_nc_type) && dmn_nm != ncvar->m_name)
+      {
+        if(nc_def_var(nc_id, dmn_nm.c_str(), ncvar_crd->m_nc_type, 1, &dim_ids[idx_dmn], &crd_ids[idx_dmn]) != NC_NOERR)
+        {
+          crd_ids[idx_dmn] = -1;
+        }
+        else if(src_var_id != -1)
+        {
+          int src_crd_id;
+          if(nc_inq_varid(src.m_grp_id, ncvar_crd->m_name.c_str(), &src_crd_id) == NC_NOERR)
+          {
+            copy_attributes(src_crd_id, crd_ids[idx_dmn]);
+          }
+        }
+      }
+    }
+    if(ok)
+    {
+      ok = nc_def_var(nc_id, ncvar->m_name.c_str(), typ, (int)nbr_dmn, dim_ids.data(), &var_id) == NC_NOERR;
+    }
+    if(ok && nbr_dmn)
+    {
+      ok = nc_def_var_chunking(nc_id, var_id, NC_CHUNKED, shape.data()) == NC_NOERR;
+      if(ok && level > 0)
+      {
+        ok = nc_def_var_deflate(nc_id, var_id, shuffle ? 1 : 0, 1, level) == NC_NOERR;
+      }
+    }
+    if(ok)
+    {
+      copy_attributes(src_var_id, var_id);
+      ok = nc_enddef(nc_id) == NC_NOERR;
+    }
+    for(size_t idx_dmn = 0; ok && idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      if(crd_ids[idx_dmn] != -1)
+      {
+        ncvar_t *ncvar_crd = item_data->m_ncvar_crd[idx_dmn];
+        size_t crd_start = 0;
+        const char *crd_buf = static_cast<const char*>(ncvar_crd->m_buf) + start[idx_dmn] * nc_type_size(ncvar_crd->m_nc_type);
+        ok = nc_put_vara(nc_id, crd_ids[idx_dmn], &crd_start, &count[idx_dmn], crd_buf) == NC_NOERR;
+      }
+    }
+    if(!ok)
+    {
+      error = "cannot define " + ncvar->m_name + " in " + file_name;
+    }
+  }
+  src.close();
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //data
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  bool direct = false;
+#ifdef HAVE_HDF5
+  //numeric variables: the chunks are written by the HDF5 library, once netCDF has closed the file
+  direct = ok && nbr_dmn > 0 && is_numeric(typ);
+  if(direct)
+  {
+    std::vector<int> filters; // filter pipeline, in the order applied
+    hid_t fid = -1;
+    hid_t did = -1;
+    {
+      std::lock_guard<std::mutex> lock(nc_mutex());
+      ok = nc_close(nc_id) == NC_NOERR;
+      H5E_BEGIN_TRY
+      {
+        fid = ok ? H5Fopen(file_name.c_str(), H5F_ACC_RDWR, H5P_DEFAULT) : -1;
+        if(fid >= 0)
+        {
+          did = H5Dopen2(fid, ("/" + ncvar->m_name).c_str(), H5P_DEFAULT);
+        }
+        //a variable that has the name of a dimension it is not the coordinate of
+        if(fid >= 0 && did < 0)
+        {
+          did = H5Dopen2(fid, ("/_nc4_non_coord_" + ncvar->m_name).c_str(), H5P_DEFAULT);
+        }
+      }
+      H5E_END_TRY;
+      ok = did >= 0;
+      if(ok)
+      {
+        hid_t dcpl = H5Dget_create_plist(did);
+        hid_t tid = H5Dget_type(did);
+        hid_t mem_tid = hdf5_mem_type(typ);
+        ok = H5Tequal(tid, mem_tid) > 0;
+        int nbr_flt = H5Pget_nfilters(dcpl);
+        for(int idx_flt = 0; idx_flt < nbr_flt; idx_flt++)
+        {
+          unsigned int flags;
+          size_t nbr_cd = 0;
+          filters.push_back(H5Pget_filter2(dcpl, (unsigned)idx_flt, &flags, &nbr_cd, NULL, 0, NULL, NULL));
+        }
+        H5Tclose(mem_tid);
+        H5Tclose(tid);
+        H5Pclose(dcpl);
+      }
+      if(!ok)
+      {
+        error = "cannot write " + ncvar->m_name + " in " + file_name;
+      }
+    }
+
+    //chunks of the subset, taken in order by the threads as they are free
+    std::vector<size_t> nbr_chunks(nbr_dmn);
+    std::vector<size_t> stride_chunk(nbr_dmn, 1);
+    size_t nbr = 1;
+    size_t chunk_nbr = 1;
+    for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+    {
+      nbr_chunks[idx_dmn - 1] = (count[idx_dmn - 1] + shape[idx_dmn - 1] - 1) / shape[idx_dmn - 1];
+      nbr *= nbr_chunks[idx_dmn - 1];
+      stride_chunk[idx_dmn - 1] = chunk_nbr;
+      chunk_nbr *= shape[idx_dmn - 1];
+    }
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> nbr_done(0);
+    std::atomic<bool> failed(!ok);
+    std::atomic<bool> canceled(false);
+    std::mutex error_mutex;
+    auto fail = [&](const std::string &msg)
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if(!failed)
+      {
+        error = msg;
+      }
+      failed = true;
+    };
+    //one range per worker; the ranges are not used, chunks are taken from 'next'
+    parallel_for(ok ? std::min((size_t)nbr_threads(), nbr) : 0, 1, [&](size_t, size_t, int idx_thr)
+    {
+      ncfile_t file;
+      std::vector<char> data;
+      std::vector<char> blk;
+      std::vector<char> tmp;
+      std::vector<size_t> blk_start(nbr_dmn);
+      std::vector<size_t> blk_count(nbr_dmn);
+      std::vector<hsize_t> offset(nbr_dmn);
+      for(size_t idx = next++; idx < nbr && !failed; idx = next++)
+      {
+        size_t rem = idx;
+        size_t blk_nbr = 1;
+        for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+        {
+          size_t org = (rem % nbr_chunks[idx_dmn - 1]) * shape[idx_dmn - 1];
+          rem /= nbr_chunks[idx_dmn - 1];
+          offset[idx_dmn - 1] = org;
+          blk_start[idx_dmn - 1] = start[idx_dmn - 1] + org;
+          blk_count[idx_dmn - 1] = std::min(shape[idx_dmn - 1], count[idx_dmn - 1] - org);
+          blk_nbr *= blk_count[idx_dmn - 1];
+        }
+
+        //edge chunks are read apart and padded to the chunk shape
+        data.assign(chunk_nbr * elem_sz, 0);
+        std::vector<char> &in = blk_nbr == chunk_nbr ? data : blk;
+        in.resize(blk_nbr * elem_sz);
+        if(read_hyperslab(item_data, file, blk_start, blk_count, in.data()) != NC_NOERR)
+        {
+          fail("cannot read " + ncvar->m_name);
+          break;
+        }
+        if(blk_nbr != chunk_nbr)
+        {
+          size_t row_sz = blk_count[nbr_dmn - 1] * elem_sz;
+          size_t nbr_rows = blk_nbr / blk_count[nbr_dmn - 1];
+          for(size_t idx_row = 0; idx_row < nbr_rows; idx_row++)
+          {
+            size_t off = 0;
+            size_t row = idx_row;
+            for(size_t idx_dmn = nbr_dmn - 1; idx_dmn > 0; idx_dmn--)
+            {
+              off += (row % blk_count[idx_dmn - 1]) * stride_chunk[idx_dmn - 1];
+              row /= blk_count[idx_dmn - 1];
+            }
+            memcpy(&data[off * elem_sz], &blk[idx_row * row_sz], row_sz);
+          }
+        }
+
+        if(!filter_chunk(data, filters, level, elem_sz, tmp))
+        {
+          fail("cannot compress " + ncvar->m_name);
+          break;
+        }
+        herr_t res;
+        {
+          std::lock_guard<std::mutex> lock(nc_mutex());
+          res = H5Dwrite_chunk(did, H5P_DEFAULT, 0, offset.data(), data.size(), data.data());
+        }
+        if(res < 0)
+        {
+          fail("cannot write " + ncvar->m_name + " in " + file_name);
+          break;
+        }
+        nbr_done++;
+        if(idx_thr == 0 && progress != NULL)
+        {
+          progress->setValue((int)(1000.0 * nbr_done / nbr));
+          if(progress->wasCanceled())
+          {
+            canceled = true;
+            fail("");
+          }
+        }
+      }
+    });
+
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(did >= 0)
+    {
+      H5Dclose(did);
+    }
+    if(fid >= 0 && H5Fclose(fid) < 0)
+    {
+      failed = true;
+    }
+    ok = !failed;
+    if(canceled)
+    {
+      error.clear();
+    }
+  }
+#endif
+
+  //other variables (and without the HDF5 library): streamed in blocks through the netCDF library
+  if(!direct)
+  {
+    std::vector<size_t> blk_start;
+    std::vector<size_t> blk_count;
+    std::vector<size_t> out_start(nbr_dmn);
+    std::vector<char> buf;
+    slab_iterator_t iter(start, count, max_elem);
+    ncfile_t file;
+    size_t nbr_total = 1;
+    size_t nbr_done = 0;
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      nbr_total *= count[idx_dmn];
+    }
+    while(ok && iter.next(blk_start, blk_count))
+    {
+      size_t nbr = 1;
+      for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+      {
+        nbr *= blk_count[idx_dmn];
+        out_start[idx_dmn] = blk_start[idx_dmn] - start[idx_dmn];
+      }
+      buf.resize(nbr * elem_sz);
+      if(read_hyperslab(item_data, file, blk_start, blk_count, buf.data()) != NC_NOERR)
+      {
+        error = "cannot read " + ncvar->m_name;
+        ok = false;
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(nc_mutex());
+        if(nc_put_vara(nc_id, var_id, out_start.data(), blk_count.data(), buf.data()) != NC_NOERR)
+        {
+          error = "cannot write " + ncvar->m_name + " in " + file_name;
+          ok = false;
+        }
+      }
+      if(typ == NC_STRING)
+      {
+        nc_free_string(nbr, reinterpret_cast<char**>(buf.data()));
+      }
+      nbr_done += nbr;
+      if(progress != NULL)
+      {
+        progress->setValue((int)(1000.0 * nbr_done / nbr_total));
+        if(progress->wasCanceled())
+        {
+          error.clear();
+          ok = false;
+        }
+      }
+    }
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_close(nc_id) != NC_NOERR && ok)
+    {
+      error = "cannot write " + file_name;
+      ok = false;
+    }
+  }
+
+  if(!ok)
+  {
+    QFile::remove(QString::fromStdString(file_name));
+  }
+  return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::show_text
+//fill the grid with a slice formatted ahead (playback), reusing the items
+///////////////////////////////////////////////////////////////////////////////////////
+
+void TableWidget::show_text(const std::vector<QString> &text, const std::vector<int> &layer)
+{
+  if(text.size() != (size_t)m_nbr_rows * m_nbr_cols)
+  {
+    update();
+    return;
+  }
+  perf_timer_t timer(perf_t::Format, m_ncvar->m_name);
+  size_t idx_buf = 0;
+  for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+  {
+    for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+    {
+      QTableWidgetItem *cell = item(idx_row, idx_col);
+      if(cell != NULL)
+      {
+        cell->setText(text[idx_buf]);
+      }
+      else
+      {
+        setItem(idx_row, idx_col, new QTableWidgetItem(text[idx_buf]));
+      }
+      idx_buf++;
+    }
+  }
+  m_shown = true;
+  m_shown_layer = layer;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::~TableWidget
+///////////////////////////////////////////////////////////////////////////////////////
+
+TableWidget::~TableWidget()
+{
+  clear_slice();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::clear_slice
+//release the slice read for a variable that is not loaded (strings are allocated per element)
+///////////////////////////////////////////////////////////////////////////////////////
+
+void TableWidget::clear_slice()
+{
+  if(m_slice_data != NULL && m_ncvar->m_nc_type == NC_STRING)
+  {
+    nc_free_string(m_slice_nbr, static_cast<char**>(const_cast<void*>(m_slice_data)));
+  }
+  m_slice_data = NULL;
+  m_slice_nbr = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::slice
+//the displayed slice; for a variable that is not loaded it is read once per layer, and shared by the
+//grid and the panels of the window
+///////////////////////////////////////////////////////////////////////////////////////
+
+const void* TableWidget::slice(size_t &nbr)
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  if(m_ncvar->m_buf != NULL)
+  {
+    std::vector<char> buf;
+    return parent->read_slice(buf, nbr);
+  }
+  if(m_slice_layer != parent->m_layer || m_slice_data == NULL)
+  {
+    clear_slice();
+    m_slice_layer = parent->m_layer;
+    m_slice_data = parent->read_slice(m_slice, m_slice_nbr);
+  }
+  nbr = m_slice_nbr;
+  return m_slice_data;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::show_grid
+///////////////////////////////////////////////////////////////////////////////////////
+
+void TableWidget::show_grid()
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  size_t idx_buf = 0;
+
+  //items are filled once per layer, not on every paint (a layer is marked shown once filled, so that a
+  //failed read is retried)
+  if(m_shown && m_shown_layer == parent->m_layer)
+  {
+    return;
+  }
+
+  //3D
+  if(parent->m_layer.size() == 1)
+  {
+    idx_buf = parent->m_layer[0] * m_nbr_rows * m_nbr_cols;
+  }
+  //4D
+  else if(parent->m_layer.size() == 2)
+  {
+    idx_buf = parent->m_layer[0] * m_ncvar->m_ncdim[1].m_size + parent->m_layer[1];
+    idx_buf *= m_nbr_rows * m_nbr_cols;
+  }
+  //5D
+  else if(parent->m_layer.size() == 3)
+  {
+    idx_buf = parent->m_layer[0] * m_ncvar->m_ncdim[1].m_size * m_ncvar->m_ncdim[2].m_size
+      + parent->m_layer[1] * m_ncvar->m_ncdim[2].m_size
+      + parent->m_layer[2];
+    idx_buf *= m_nbr_rows * m_nbr_cols;
+  }
+  float *buf_float = NULL;
+  double *buf_double = NULL;
+  int *buf_int = NULL;
+  short *buf_short = NULL;
+  char *buf_char = NULL;
+  signed char *buf_byte = NULL;
+  unsigned char *buf_ubyte = NULL;
+  unsigned short *buf_ushort = NULL;
+  unsigned int *buf_uint = NULL;
+  long long *buf_int64 = NULL;
+  unsigned long long *buf_uint64 = NULL;
+  char* *buf_string = NULL;
+  void *data = m_ncvar->m_buf;
+  QString str;
+
+  //variables that are not loaded (derived variables) are read one slice at a time
+  if(data == NULL)
+  {
+    size_t nbr;
+    data = const_cast<void*>(slice(nbr));
+    if(data == NULL)
+    {
+      return;
+    }
+    idx_buf = 0;
+  }
+
+  perf_timer_t timer(perf_t::Decode, m_ncvar->m_name);
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  //labels for columns
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  //columns not defined
+  if(m_dim_cols == -1)
+  {
+    assert(m_nbr_cols == 1);
+    str.sprintf("%d", 1);
+    this->setHorizontalHeaderItem(0, new QTableWidgetItem(str));
+  }
+  else
+  {
+    //coordinate variable exists
+    if(m_ncvar_crd[m_dim_cols] != NULL)
+    {
+      switch(m_ncvar_crd[m_dim_cols]->m_nc_type)
+      {
+      case NC_FLOAT:
+        buf_float = static_cast<float*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_FLOAT), buf_float[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_DOUBLE:
+        buf_double = static_cast<double*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_DOUBLE), buf_double[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_INT:
+        buf_int = static_cast<int*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_INT), buf_int[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_SHORT:
+        buf_short = static_cast<short*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_SHORT), buf_short[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_BYTE:
+        buf_byte = static_cast<signed char*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_BYTE), buf_byte[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UBYTE:
+        buf_ubyte = static_cast<unsigned char*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_USHORT:
+        buf_ushort = static_cast<unsigned short*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_USHORT), buf_ushort[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UINT:
+        buf_uint = static_cast<unsigned int*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_UINT), buf_uint[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_INT64:
+        buf_int64 = static_cast<long long*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_INT64), buf_int64[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UINT64:
+        buf_uint64 = static_cast<unsigned long long*> (m_ncvar_crd[m_dim_cols]->m_buf);
+        for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+        {
+          str.sprintf(get_format(NC_UINT64), buf_uint64[idx_col]);
+          this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+        }
+        break;
+      }//switch  
+    }
+    //coordinate variable does not exist
+    else
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf("%d", idx_col + 1);
+        this->setHorizontalHeaderItem(idx_col, new QTableWidgetItem(str));
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  //labels for rows
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  //rows not defined
+  if(m_dim_rows == -1)
+  {
+    str.sprintf("%d", 1);
+    this->setVerticalHeaderItem(0, new QTableWidgetItem(str));
+  }
+  else
+  {
+    //coordinate variable exists
+    if(m_ncvar_crd[m_dim_rows] != NULL)
+    {
+      switch(m_ncvar_crd[m_dim_rows]->m_nc_type)
+      {
+      case NC_FLOAT:
+        buf_float = static_cast<float*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_FLOAT), buf_float[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_DOUBLE:
+        buf_double = static_cast<double*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_DOUBLE), buf_double[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_INT:
+        buf_int = static_cast<int*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_INT), buf_int[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_SHORT:
+        buf_short = static_cast<short*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_SHORT), buf_short[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_BYTE:
+        buf_byte = static_cast<signed char*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_BYTE), buf_byte[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UBYTE:
+        buf_ubyte = static_cast<unsigned char*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_USHORT:
+        buf_ushort = static_cast<unsigned short*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_USHORT), buf_ushort[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UINT:
+        buf_uint = static_cast<unsigned int*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_UINT), buf_uint[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_INT64:
+        buf_int64 = static_cast<long long*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_INT64), buf_int64[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      case NC_UINT64:
+        buf_uint64 = static_cast<unsigned long long*> (m_ncvar_crd[m_dim_rows]->m_buf);
+        for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+        {
+          str.sprintf(get_format(NC_UINT64), buf_uint64[idx_row]);
+          this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+        }
+        break;
+      }//switch
+    }
+    //coordinate variable does not exist
+    else
+    {
+      for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+      {
+        str.sprintf("%d", idx_row + 1);
+        this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+  //grid
+  /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  timer.next(perf_t::Format);
+
+  if(m_ncvar->m_user != NULL)
+  {
+    show_user_grid(data, idx_buf);
+    m_shown = true;
+    m_shown_layer = parent->m_layer;
+    return;
+  }
+
+  switch(m_ncvar->m_nc_type)
+  {
+  case NC_FLOAT:
+    buf_float = static_cast<float*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_FLOAT), buf_float[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_DOUBLE:
+    buf_double = static_cast<double*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_DOUBLE), buf_double[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_INT:
+    buf_int = static_cast<int*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_INT), buf_int[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_SHORT:
+    buf_short = static_cast<short*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_SHORT), buf_short[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_CHAR:
+    buf_char = static_cast<char*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_CHAR), buf_char[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_BYTE:
+    buf_byte = static_cast<signed char*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_BYTE), buf_byte[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_UBYTE:
+    buf_ubyte = static_cast<unsigned char*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_USHORT:
+    buf_ushort = static_cast<unsigned short*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_USHORT), buf_ushort[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_UINT:
+    buf_uint = static_cast<unsigned int*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_UINT), buf_uint[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_INT64:
+    buf_int64 = static_cast<long long*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_INT64), buf_int64[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_UINT64:
+    buf_uint64 = static_cast<unsigned long long*> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_UINT64), buf_uint64[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  case NC_STRING:
+    buf_string = static_cast<char**> (data);
+    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    {
+      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      {
+        str.sprintf(get_format(NC_STRING), buf_string[idx_buf]);
+        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
+        idx_buf++;
+      }
+    }
+    break;
+  }//switch
+  m_shown = true;
+  m_shown_layer = parent->m_layer;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//TableWidget::show_user_grid
+//fill the grid with elements of a user-defined type, formatted where they are in the buffer; each
+//member of a compound is read at its offset, in a column of its own labeled with the member name
+///////////////////////////////////////////////////////////////////////////////////////
+
+void TableWidget::show_user_grid(const void *data, size_t idx_buf)
+{
+  const nctype_t *type = m_ncvar->m_user;
+  const char *elem = static_cast<const char*>(data) + idx_buf * type->m_size;
+  bool members = type->m_class == NC_COMPOUND && !type->m_fields.empty();
+  std::string text;
+
+  //labels of the columns, last first, since a column moves right by its number of members
+  if(members)
+  {
+    for(int idx_col = m_nbr_cols - 1; idx_col >= 0; idx_col--)
+    {
+      QTableWidgetItem *header = horizontalHeaderItem(idx_col);
+      QString label = (header != NULL && m_nbr_cols > 1) ? header->text() + "\n" : QString();
+      for(int idx_fld = 0; idx_fld < m_nbr_fields; idx_fld++)
+      {
+        setHorizontalHeaderItem(idx_col * m_nbr_fields + idx_fld,
+          new QTableWidgetItem(label + QString::fromStdString(type->m_fields[idx_fld].m_name)));
+      }
+    }
+  }
+
+  for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+  {
+    for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+    {
+      for(int idx_fld = 0; idx_fld < m_nbr_fields; idx_fld++)
+      {
+        text.clear();
+        if(members)
+        {
+          type->format_field(text, elem, idx_fld);
+        }
+        else
+        {
+          type->format(text, elem);
+        }
+        setItem(idx_row, idx_col * m_nbr_fields + idx_fld, new QTableWidgetItem(QString::fromUtf8(text.c_str())));
+      }
+      elem += type->m_size;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::FileTreeWidget 
+///////////////////////////////////////////////////////////////////////////////////////
+
+FileTreeWidget::FileTreeWidget(QWidget *parent) : QTreeWidget(parent)
+{
+  setContextMenuPolicy(Qt::CustomContextMenu);
+
+  //right click menu
+  connect(this, SIGNAL(customContextMenuRequested(const QPoint &)), SLOT(show_context_menu(const QPoint &)));
+
+  //double click
+  connect(this, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)), this, SLOT(add_grid()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::~FileTreeWidget
+///////////////////////////////////////////////////////////////////////////////////////
+
+FileTreeWidget::~FileTreeWidget()
+{
+  QTreeWidgetItemIterator it(this);
+  while(*it)
+  {
+    ItemData *item_data = get_item_data(*it);
+    delete item_data;
+    ++it;
+  }
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::show_context_menu
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::show_context_menu(const QPoint &p)
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (itemAt(p));
+  ItemData *item_data = get_item_data(item);
+  if(item_data->m_kind == ItemData::Root || item_data->m_kind == ItemData::Group)
+  {
+    QMenu menu;
+    QAction *action_derived = new QAction("Derived variable...", this);
+    connect(action_derived, SIGNAL(triggered()), this, SLOT(add_derived()));
+    menu.addAction(action_derived);
+    menu.exec(QCursor::pos());
+    return;
+  }
+  if(item_data->m_kind != ItemData::Variable)
+    return;
+  QMenu menu;
+  QAction *action_grid = new QAction("Grid...", this);;
+  connect(action_grid, SIGNAL(triggered()), this, SLOT(add_grid()));
+  menu.addAction(action_grid);
+  QAction *action_image = new QAction("Map...", this);;
+  connect(action_image, SIGNAL(triggered()), this, SLOT(add_image()));
+  action_image->setEnabled(false);
+  menu.addAction(action_image);
+  QAction *action_plot = new QAction("Plot...", this);
+  connect(action_plot, SIGNAL(triggered()), this, SLOT(add_plot()));
+  action_plot->setEnabled(is_numeric(item_data->m_ncvar->m_nc_type));
+  menu.addAction(action_plot);
+  QAction *action_histogram = new QAction("Histogram...", this);
+  connect(action_histogram, SIGNAL(triggered()), this, SLOT(add_histogram()));
+  action_histogram->setEnabled(is_numeric(item_data->m_ncvar->m_nc_type));
+  menu.addAction(action_histogram);
+  menu.addSeparator();
+  QAction *action_reduce = new QAction("Reduce...", this);
+  connect(action_reduce, SIGNAL(triggered()), this, SLOT(add_reduction()));
+  action_reduce->setEnabled(is_numeric(item_data->m_ncvar->m_nc_type) && item_data->m_ncvar->m_ncdim.size() > 0);
+  menu.addAction(action_reduce);
+  QAction *action_diff = new QAction("Compare with...", this);
+  connect(action_diff, SIGNAL(triggered()), this, SLOT(add_diff()));
+  action_diff->setEnabled(is_numeric(item_data->m_ncvar->m_nc_type));
+  menu.addAction(action_diff);
+  menu.exec(QCursor::pos());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_grid
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_grid()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  this->load_item(item);
+  ItemData *item_data = get_item_data(item);
+  assert(item_data->m_kind == ItemData::Variable);
+  m_main_window->add_table(item_data);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_image
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_image()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  this->load_item(item);
+  ItemData *item_data = get_item_data(item);
+  assert(item_data->m_kind == ItemData::Variable);
+  m_main_window->add_image(item_data);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_plot
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_plot()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  this->load_item(item, false);
+  ItemData *item_data = get_item_data(item);
+  assert(item_data->m_kind == ItemData::Variable);
+  m_main_window->add_plot(item_data);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_histogram
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_histogram()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  this->load_item(item, false);
+  ItemData *item_data = get_item_data(item);
+  assert(item_data->m_kind == ItemData::Variable);
+  m_main_window->add_histogram(item_data);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_derived
+//define a variable of a group as an expression of other variables ("name = expression"); it is added
+//to the tree and to the group variables, and evaluated only for the hyperslabs that are displayed
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_derived()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  ItemData *item_data_grp = get_item_data(item);
+  bool ok;
+
+  QString text = QInputDialog::getText(this, tr("Derived variable"),
+    tr("name = expression (+ - * / ^, sqrt abs exp log log10 sin cos tan min max pow atan2)"),
+    QLineEdit::Normal, "", &ok);
+  if(!ok || text.isEmpty())
+    return;
+
+  int idx_eq = text.indexOf('=');
+  std::string name = text.left(idx_eq).trimmed().toStdString();
+  if(idx_eq <= 0 || name.empty())
+  {
+    QMessageBox::warning(this, tr("Derived variable"), tr("Expected name = expression"));
+    return;
+  }
+  if(item_data_grp->m_vars.count(name))
+  {
+    QMessageBox::warning(this, tr("Derived variable"), tr("Variable %1 exists").arg(name.c_str()));
+    return;
+  }
+
+  expr_t *expr = new expr_t;
+  if(!expr->compile(text.mid(idx_eq + 1).toStdString(), item_data_grp))
+  {
+    QMessageBox::warning(this, tr("Derived variable"), QString::fromStdString(expr->m_error));
+    delete expr;
+    return;
+  }
+
+  ncvar_t *ncvar = new ncvar_t(name.c_str(), NC_DOUBLE, expr->m_ncdim);
+  ItemData *item_data = new ItemData(ItemData::Variable, item_data_grp->m_file_name, item_data_grp->m_grp_nm_fll,
+    name, item_data_grp, ncvar, new grid_policy_t(expr->m_ncdim));
+  item_data->m_expr = expr;
+  add_virtual(item, item_data, name + " =" + expr->m_text);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_virtual
+//add a variable that is not in the file (derived or computed) to a group item and to the group variables
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_virtual(QTreeWidgetItem *item_grp, ItemData *item_data, const std::string &tool_tip)
+{
+  get_item_data(item_grp)->m_vars[item_data->m_item_nm] = item_data;
+
+  QTreeWidgetItem *item_var = new QTreeWidgetItem(item_grp);
+  item_var->setText(0, QString::fromStdString(item_data->m_item_nm));
+  item_var->setIcon(0, m_main_window->icon_dataset());
+  item_var->setToolTip(0, QString::fromStdString(tool_tip));
+  QFont font = item_var->font(0);
+  font.setItalic(true);
+  item_var->setFont(0, font);
+  QVariant data;
+  data.setValue(item_data);
+  item_var->setData(0, Qt::UserRole, data);
+  setCurrentItem(item_var);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_reduction
+//collapse a dimension of a variable (mean, minimum, maximum or sum over it) into a new variable of the
+//same group; the result is computed once, streaming the variable, and is then a loaded variable
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_reduction()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  ItemData *item_data = get_item_data(item);
+  ncvar_t *ncvar = item_data->m_ncvar;
+  QStringList dims;
+  QStringList ops;
+  bool ok;
+
+  if(ncvar->m_ncdim.empty() || !is_numeric(ncvar->m_nc_type) || item->parent() == NULL)
+    return;
+
+  for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+  {
+    dims << QString::fromStdString(ncvar->m_ncdim[idx_dmn].m_name);
+  }
+  QString dim_nm = QInputDialog::getItem(this, tr("Reduce"), tr("Dimension"), dims, 0, false, &ok);
+  if(!ok)
+    return;
+  ops << "mean" << "min" << "max" << "sum";
+  QString op_nm = QInputDialog::getItem(this, tr("Reduce"), tr("Operation"), ops, 0, false, &ok);
+  if(!ok)
+    return;
+  size_t dim = dims.indexOf(dim_nm);
+  int op = ops.indexOf(op_nm);
+
+  std::string name = ncvar->m_name + "_" + op_nm.toStdString() + "_" + dim_nm.toStdString();
+  ItemData *item_data_grp = item_data->m_item_data_prn;
+  if(item_data_grp->m_vars.count(name))
+  {
+    QMessageBox::warning(this, tr("Reduce"), tr("Variable %1 exists").arg(name.c_str()));
+    return;
+  }
+
+  std::vector<ncdim_t> ncdim(ncvar->m_ncdim);
+  ncdim.erase(ncdim.begin() + dim);
+  size_t nbr = 1;
+  for(size_t idx_dmn = 0; idx_dmn < ncdim.size(); idx_dmn++)
+  {
+    nbr *= ncdim[idx_dmn].m_size;
+  }
+  double *buf = static_cast<double*>(malloc(nbr * sizeof(double)));
+  if(buf == NULL)
+  {
+    QMessageBox::warning(this, tr("Reduce"), tr("Not enough memory"));
+    return;
+  }
+  if(!reduce_variable(item_data, dim, op, buf, this))
+  {
+    free(buf);
+    return;
+  }
+
+  ncvar_t *ncvar_red = new ncvar_t(name.c_str(), NC_DOUBLE, ncdim);
+  ncvar_red->store(buf);
+  ItemData *item_data_red = new ItemData(ItemData::Variable, item_data->m_file_name, item_data->m_grp_nm_fll,
+    name, item_data_grp, ncvar_red, new grid_policy_t(ncdim));
+  load_coordinates(item_data_red, -1, -1);
+  add_virtual(item->parent(), item_data_red, op_nm.toStdString() + " of " + ncvar->m_name + " over " + dim_nm.toStdString());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::add_diff
+//difference of a variable and a variable with the same shape in another open file (variables with
+//the same name are listed first); shown in a window that owns it, evaluated per displayed slice
+///////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::add_diff()
+{
+  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
+  ItemData *item_data = get_item_data(item);
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  QTreeWidgetItem *root = item;
+  std::vector<ItemData*> candidates;
+  QStringList names;
+  bool ok;
+
+  while(root->parent() != NULL)
+  {
+    root = root->parent();
+  }
+
+  //numeric variables of the other roots with the same dimension sizes
+  for(int pass = 0; pass < 2; pass++)
+  {
+    for(int idx_root = 0; idx_root < topLevelItemCount(); idx_root++)
+    {
+      if(topLevelItem(idx_root) == root)
+      {
+        continue;
+      }
+      QTreeWidgetItemIterator it(topLevelItem(idx_root));
+      while(*it && (*it == topLevelItem(idx_root) || (*it)->parent() != NULL))
+      {
+        ItemData *item_data_b = get_item_data(*it);
+        ++it;
+        if(item_data_b->m_kind != ItemData::Variable || !is_numeric(item_data_b->m_ncvar->m_nc_type) ||
+          (item_data_b->m_item_nm == item_data->m_item_nm) != (pass == 0))
+        {
+          continue;
+        }
+        const std::vector<ncdim_t> &ncdim_b = item_data_b->m_ncvar->m_ncdim;
+        bool same = ncdim.size() == ncdim_b.size();
+        for(size_t idx_dmn = 0; same && idx_dmn < ncdim.size(); idx_dmn++)
+        {
+          same = ncdim[idx_dmn].m_size == ncdim_b[idx_dmn].m_size;
+        }
+        if(same)
+        {
+          candidates.push_back(item_data_b);
+          names << last_component(item_data_b->m_file_name.c_str()) + " : " +
+            QString::fromStdString(item_data_b->m_grp_nm_fll + (item_data_b->m_grp_nm_fll == "/" ? "" : "/") + item_data_b->m_item_nm);
+        }
+      }
+    }
+  }
+  if(candidates.empty())
+  {
+    QMessageBox::information(this, tr("Compare"), tr("No variable with the same shape in the other open files"));
+    return;
+  }
+
+  QString name = QInputDialog::getItem(this, tr("Compare"), tr("Subtract"), names, 0, false, &ok);
+  if(!ok)
+    return;
+  ItemData *item_data_b = candidates[names.indexOf(name)];
+
+  expr_t *expr = new expr_t;
+  expr->difference(item_data, item_data_b);
+  std::string name_diff = item_data->m_item_nm + " - " + last_component(item_data_b->m_file_name.c_str()).toStdString() +
+    ":" + item_data_b->m_item_nm;
+  ncvar_t *ncvar = new ncvar_t(name_diff.c_str(), NC_DOUBLE, ncdim);
+  ItemData *item_data_diff = new ItemData(ItemData::Variable, item_data->m_file_name, item_data->m_grp_nm_fll,
+    name_diff, item_data->m_item_data_prn, ncvar, new grid_policy_t(ncdim));
+  item_data_diff->m_expr = expr;
+  load_coordinates(item_data_diff, -1, -1);
+  m_main_window->add_diff(item_data_diff);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_variable
+//look up a variable by name in a group and, following netCDF scope rules, in its parent groups
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ItemData* find_variable(ItemData *item_data_grp, const std::string &var_nm)
+{
+  for(ItemData *item_data = item_data_grp; item_data != NULL; item_data = item_data->m_item_data_prn)
+  {
+    std::unordered_map<std::string, ItemData*>::const_iterator it = item_data->m_vars.find(var_nm);
+    if(it != item_data->m_vars.end())
+    {
+      return it->second;
+    }
+  }
+  return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//file_inserted
+//all the items of the file of an item are in the tree (its walk is over)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool file_inserted(const ItemData *item_data)
+{
+  while(item_data->m_item_data_prn != NULL)
+  {
+    item_data = item_data->m_item_data_prn;
+  }
+  return item_data->m_inserted;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_coordinate
+//coordinate variable of a dimension seen from a group: a one-dimensional variable with the name and
+//size of the dimension, in the group or a parent group; resolved once per group and dimension name,
+//once the whole file is in the tree (before, the coordinate variable may not be inserted yet)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ItemData* find_coordinate(ItemData *item_data_grp, const ncdim_t &ncdim)
+{
+  std::unordered_map<std::string, ItemData*>::const_iterator it = item_data_grp->m_crd_cache.find(ncdim.m_name);
+  if(it != item_data_grp->m_crd_cache.end())
+  {
+    return it->second;
+  }
+  ItemData *item_data_crd = find_variable(item_data_grp, ncdim.m_name);
+  if(item_data_crd != NULL)
+  {
+    const std::vector<ncdim_t> &ncdim_crd = item_data_crd->m_ncvar->m_ncdim;
+    if(ncdim_crd.size() != 1 || ncdim_crd[0].m_name != ncdim.m_name || ncdim_crd[0].m_size != ncdim.m_size)
+    {
+      item_data_crd = NULL;
+    }
+  }
+  if(file_inserted(item_data_grp))
+  {
+    item_data_grp->m_crd_cache[ncdim.m_name] = item_data_crd;
+  }
+  return item_data_crd;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//get_cf_coordinates
+//names listed in the CF "coordinates" attribute of a variable
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> get_cf_coordinates(const int grp_id, const int var_id)
+{
+  std::vector<std::string> names;
+  size_t len;
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  if(nc_inq_attlen(grp_id, var_id, "coordinates", &len) != NC_NOERR)
+  {
+    return names;
+  }
+  std::vector<char> buf(len + 1, '\0');
+  if(nc_get_att_text(grp_id, var_id, "coordinates", &buf[0]) != NC_NOERR)
+  {
+    return names;
+  }
+  std::istringstream stream(std::string(&buf[0]));
+  std::string name;
+  while(stream >> name)
+  {
+    names.push_back(name);
+  }
+  return names;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::load_item
+//load a variable and the coordinate variables of its dimensions; coordinate variables are the
+//variables of their own tree items, so each is read once and shared by all variables and windows;
+//without data only the coordinates are loaded, for windows that read one slice at a time
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::load_item(QTreeWidgetItem  *item, bool data)
+{
+  ncfile_t file;
+  int var_id;
+
+  ItemData *item_data = get_item_data(item);
+  assert(item_data->m_kind == ItemData::Variable);
+
+  //if not loaded, read buffer from file 
+  if(item_data->m_ncvar->m_buf != NULL || item_data->m_ncvar->m_store != NULL)
+  {
+    return;
+  }
+
+  //SQLite tables are read one page of rows at a time and have no coordinates
+  if(item_data->m_source == ItemData::SourceSQLite)
+  {
+    item_data->m_ncvar_crd.assign(item_data->m_ncvar->m_ncdim.size(), (ncvar_t*)NULL);
+    return;
+  }
+
+  //derived variables are evaluated per slice, only their coordinate variables are loaded; HDF5
+  //datasets and Zarr arrays are read per slice as well
+  if(item_data->m_expr != NULL || item_data->m_source != ItemData::SourceNetCDF)
+  {
+    load_coordinates(item_data, -1, -1);
+    return;
+  }
+
+  if(file.open(item_data->m_file_name, item_data->m_grp_nm_fll) != NC_NOERR)
+  {
+    return;
+  }
+
+  // get variable ID
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_inq_varid(file.m_grp_id, item_data->m_item_nm.c_str(), &var_id) != NC_NOERR)
+    {
+      return;
+    }
+  }
+
+  load_coordinates(item_data, file.m_grp_id, var_id);
+  if(!data)
+  {
+    return;
+  }
+
+  //allocate buffer and store in item data 
+  load_data(item_data, file.m_grp_id, var_id);
+
+  if(m_main_window->compress_loaded())
+  {
+    compress_data(item, item_data);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::compress_data
+//replace the buffer of a large loaded variable by its compressed store, and report the ratio;
+//one-dimensional variables stay raw, since coordinate lookups use their buffer directly
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::compress_data(QTreeWidgetItem *item, ItemData *item_data)
+{
+  ncvar_t *ncvar = item_data->m_ncvar;
+  size_t nbr = 1;
+  QString str;
+
+  if(ncvar->m_buf == NULL || ncvar->m_ncdim.size() < 2 || !is_numeric(ncvar->m_nc_type))
+  {
+    return;
+  }
+  for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+  {
+    nbr *= ncvar->m_ncdim[idx_dmn].m_size;
+  }
+  if(nbr < 4 * tile_store_t::tile_nbr)
+  {
+    return;
+  }
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  ncvar->m_store = new tile_store_t(ncvar->m_buf, nbr, nc_type_size(ncvar->m_nc_type));
+  free(ncvar->m_buf);
+  ncvar->m_buf = NULL;
+  QApplication::restoreOverrideCursor();
+
+  const double mb = 1024.0 * 1024.0;
+  size_t stored = std::max((size_t)1, ncvar->m_store->stored_size());
+  size_t total_stored = std::max((size_t)1, tile_store_t::total_stored_size());
+  str.sprintf("compressed %.1f MB to %.1f MB (%.1fx)", ncvar->m_store->raw_size() / mb, stored / mb,
+    (double)ncvar->m_store->raw_size() / stored);
+  item->setToolTip(0, item->toolTip(0) + "\n" + str);
+  str.sprintf("%s: %s; all compressed variables %.1f MB in %.1f MB (%.1fx)", ncvar->m_name.c_str(), str.toLatin1().constData(),
+    tile_store_t::total_raw_size() / mb, total_stored / mb, (double)tile_store_t::total_raw_size() / total_stored);
+  m_main_window->statusBar()->showMessage(str);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::load_coordinates
+//resolve coordinate variables: dimension name lookup through the group hash maps, then
+//one-dimensional auxiliary coordinates listed in the CF "coordinates" attribute (of a file variable,
+//var_id -1 for derived variables); resolved again on the next use while the file is being inserted
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::load_coordinates(ItemData *item_data, int grp_id, int var_id)
+{
+  if(!item_data->m_ncvar_crd.empty() && file_inserted(item_data))
+  {
+    return;
+  }
+
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  std::vector<ncvar_t*> ncvar_crd;
+  std::vector<std::string> cf_names;
+  if(var_id != -1)
+  {
+    cf_names = get_cf_coordinates(grp_id, var_id);
+  }
+  for(size_t idx_dmn = 0; idx_dmn < ncdim.size(); idx_dmn++)
+  {
+    ItemData *item_data_crd = find_coordinate(item_data->m_item_data_prn, ncdim[idx_dmn]);
+    for(size_t idx_nm = 0; item_data_crd == NULL && idx_nm < cf_names.size(); idx_nm++)
+    {
+      ItemData *item_data_aux = find_variable(item_data->m_item_data_prn, cf_names[idx_nm]);
+      if(item_data_aux != NULL && item_data_aux->m_ncvar->m_ncdim.size() == 1 &&
+        item_data_aux->m_ncvar->m_ncdim[0].m_name == ncdim[idx_dmn].m_name &&
+        item_data_aux->m_ncvar->m_ncdim[0].m_size == ncdim[idx_dmn].m_size)
+      {
+        item_data_crd = item_data_aux;
+      }
+    }
+    if(item_data_crd != NULL && item_data_crd != item_data)
+    {
+      load_data(item_data_crd);
+    }
+    ncvar_crd.push_back(item_data_crd ? item_data_crd->m_ncvar : NULL);
+  }
+  item_data->m_ncvar_crd = ncvar_crd;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::load_data
+//read the whole buffer of a variable, if not loaded (opening its file when no group ID is given)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FileTreeWidget::load_data(ItemData *item_data, int grp_id, int var_id)
+{
+  ncfile_t file;
+  ncvar_t *ncvar = item_data->m_ncvar;
+  size_t buf_sz = 1; // variable size
+
+  if(ncvar->m_buf != NULL || ncvar->m_store != NULL || item_data->m_source == ItemData::SourceSQLite)
+  {
+    return;
+  }
+
+  //a loaded variable is read from its buffer: the chunks kept for its windows are released
+  if(item_data->m_chunk_cache != NULL)
+  {
+    item_data->m_chunk_cache->clear();
+  }
+
+  //define buffer size
+  for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+  {
+    buf_sz *= ncvar->m_ncdim[idx_dmn].m_size;
+  }
+
+  //variables read by other libraries (coordinates of HDF5 datasets and Zarr arrays) are read as one hyperslab
+  if(item_data->m_source != ItemData::SourceNetCDF)
+  {
+    std::vector<size_t> start(ncvar->m_ncdim.size(), 0);
+    std::vector<size_t> count;
+    for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+    {
+      count.push_back(ncvar->m_ncdim[idx_dmn].m_size);
+    }
+    void *buf = malloc(std::max(buf_sz, (size_t)1) * nc_type_size(ncvar->m_nc_type));
+    if(read_hyperslab(item_data, file, start, count, buf) != NC_NOERR)
+    {
+      free(buf);
+      return;
+    }
+    if(ncvar->m_nc_type == NC_STRING)
+    {
+      buf = string_arena(static_cast<char**>(buf), buf_sz);
+    }
+    ncvar->store(buf);
+    return;
+  }
+
+  if(grp_id == -1)
+  {
+    if(file.open(item_data->m_file_name, item_data->m_grp_nm_fll) != NC_NOERR)
+    {
+      return;
+    }
+    grp_id = file.m_grp_id;
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    if(nc_inq_varid(grp_id, item_data->m_item_nm.c_str(), &var_id) != NC_NOERR)
+    {
+      return;
+    }
+  }
+
+  //user-defined types are described while the file is open
+  if(ncvar->m_nc_type >= NC_FIRSTUSERTYPEID && ncvar->m_user == NULL)
+  {
+    std::lock_guard<std::mutex> lock(nc_mutex());
+    ncvar->m_user = nctype_t::inquire(grp_id, ncvar->m_nc_type);
+    if(ncvar->m_user == NULL)
+    {
+      return;
+    }
+  }
+
+#ifdef HAVE_HDF5
+  //deflated netCDF-4 variables: all chunks inflated on all threads (the file is open, here or by the caller)
+  if(buf_sz > 0 && ncvar->m_user == NULL)
+  {
+    std::vector<size_t> start(ncvar->m_ncdim.size(), 0);
+    std::vector<size_t> count;
+    for(size_t idx_dmn = 0; idx_dmn < ncvar->m_ncdim.size(); idx_dmn++)
+    {
+      count.push_back(ncvar->m_ncdim[idx_dmn].m_size);
+    }
+    void *buf = malloc(buf_sz * nc_type_size(ncvar->m_nc_type));
+    if(buf != NULL && read_chunked_hyperslab(item_data, start, count, buf) == NC_NOERR)
+    {
+      ncvar->store(buf);
+      return;
+    }
+    free(buf);
+  }
+#endif
+
+  ncvar->store(load_variable(grp_id, var_id, ncvar->m_nc_type, buf_sz));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FileTreeWidget::load_variable
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void* FileTreeWidget::load_variable(const int nc_id, const int var_id, const nc_type var_type, size_t buf_sz)
+{
+  void *buf = NULL;
+  char var_nm[NC_MAX_NAME + 1];
+  std::lock_guard<std::mutex> lock(nc_mutex());
+  if(nc_inq_varname(nc_id, var_id, var_nm) != NC_NOERR)
+  {
+    var_nm[0] = '\0';
+  }
+  perf_timer_t timer(perf_t::Read, var_nm);
+  switch(var_type)
+  {
+  case NC_FLOAT:
+    buf = malloc(buf_sz * sizeof(float));
+    if(nc_get_var_float(nc_id, var_id, static_cast<float *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_DOUBLE:
+    buf = malloc(buf_sz * sizeof(double));
+    if(nc_get_var_double(nc_id, var_id, static_cast<double *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_INT:
+    buf = malloc(buf_sz * sizeof(int));
+    if(nc_get_var_int(nc_id, var_id, static_cast<int *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_SHORT:
+    buf = malloc(buf_sz * sizeof(short));
+    if(nc_get_var_short(nc_id, var_id, static_cast<short *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_CHAR:
+    buf = malloc(buf_sz * sizeof(char));
+    if(nc_get_var_text(nc_id, var_id, static_cast<char *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_BYTE:
+    buf = malloc(buf_sz * sizeof(signed char));
+    if(nc_get_var_schar(nc_id, var_id, static_cast<signed char *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_UBYTE:
+    buf = malloc(buf_sz * sizeof(unsigned char));
+    if(nc_get_var_uchar(nc_id, var_id, static_cast<unsigned char *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_USHORT:
+    buf = malloc(buf_sz * sizeof(unsigned short));
+    if(nc_get_var_ushort(nc_id, var_id, static_cast<unsigned short *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_UINT:
+    buf = malloc(buf_sz * sizeof(unsigned int));
+    if(nc_get_var_uint(nc_id, var_id, static_cast<unsigned int *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_INT64:
+    buf = malloc(buf_sz * sizeof(long long));
+    if(nc_get_var_longlong(nc_id, var_id, static_cast<long long *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_UINT64:
+    buf = malloc(buf_sz * sizeof(unsigned long long));
+    if(nc_get_var_ulonglong(nc_id, var_id, static_cast<unsigned long long *>(buf)) != NC_NOERR)
+    {
+    }
+    break;
+  case NC_STRING:
+    //strings are moved to one arena, where the library allocates each
+    buf = malloc(std::max(buf_sz, (size_t)1) * sizeof(char*));
+    if(buf != NULL && nc_get_var_string(nc_id, var_id, static_cast<char* *>(buf)) != NC_NOERR)
+    {
+      free(buf);
+      buf = NULL;
+    }
+    if(buf != NULL)
+    {
+      buf = string_arena(static_cast<char**>(buf), buf_sz);
+    }
+    break;
+  default:
+    //user-defined types: one buffer of elements as stored; the library allocates the data of VLEN
+    //elements, which must not be released when the read fails
+    {
+      size_t elem_sz;
+      if(nc_inq_type(nc_id, var_type, NULL, &elem_sz) == NC_NOERR)
+      {
+        buf = calloc(std::max(buf_sz, (size_t)1), elem_sz);
+        if(buf != NULL && nc_get_var(nc_id, var_id, buf) != NC_NOERR)
+        {
+          free(buf);
+          buf = NULL;
+        }
+      }
+    }
+  }
+  return buf;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//RenderWidget::sizeHint
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+QSize RenderWidget::sizeHint() const
+{
+  return QSize(400, 200);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//RenderWidget::paintEvent
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RenderWidget::paintEvent(QPaintEvent *)
+{
+  QPainter painter(this);
+
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock::PerfDock
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PerfDock::PerfDock(QWidget *parent) :
+QDockWidget(tr("Performance"), parent)
+{
+  QWidget *widget = new QWidget(this);
+  QVBoxLayout *layout = new QVBoxLayout(widget);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //one row per stage
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  QStringList header;
+  header << tr("Count") << tr("Total ms") << tr("Mean ms") << tr("p50 ms") << tr("p95 ms")
+    << tr("Max ms") << tr("Last ms") << tr("Histogram (log2 us)");
+  m_table = new QTableWidget(perf_t::NbrStages, header.size(), widget);
+  m_table->setHorizontalHeaderLabels(header);
+  m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  for(int idx = 0; idx < perf_t::NbrStages; idx++)
+  {
+    m_table->setVerticalHeaderItem(idx, new QTableWidgetItem(perf_t::stage_name(idx)));
+  }
+  layout->addWidget(m_table);
+  m_label_cache = new QLabel(widget);
+  m_label_cache->setToolTip(tr("Chunks of compressed variables inflated, and inflations avoided by the chunk caches"));
+  layout->addWidget(m_label_cache);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //buttons
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  QHBoxLayout *layout_buttons = new QHBoxLayout;
+  QCheckBox *check_record = new QCheckBox(tr("Record"), widget);
+  check_record->setChecked(true);
+  connect(check_record, SIGNAL(toggled(bool)), this, SLOT(set_recording(bool)));
+  QPushButton *button_reset = new QPushButton(tr("Reset"), widget);
+  connect(button_reset, SIGNAL(clicked()), this, SLOT(reset()));
+  QPushButton *button_export = new QPushButton(tr("Export trace..."), widget);
+  connect(button_export, SIGNAL(clicked()), this, SLOT(export_trace()));
+  layout_buttons->addWidget(check_record);
+  layout_buttons->addStretch();
+  layout_buttons->addWidget(button_reset);
+  layout_buttons->addWidget(button_export);
+  layout->addLayout(layout_buttons);
+  setWidget(widget);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //refresh periodically, only while visible
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_timer = new QTimer(this);
+  m_timer->setInterval(500);
+  connect(m_timer, SIGNAL(timeout()), this, SLOT(refresh()));
+  connect(this, SIGNAL(visibilityChanged(bool)), this, SLOT(refresh()));
+  m_timer->start();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//percentile_bucket
+//upper bound (microseconds) of the histogram bucket that contains the percentile
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double percentile_bucket(const perf_t::stat_t &stat, double percentile)
+{
+  unsigned long long nbr = 0;
+  unsigned long long target = (unsigned long long)(percentile * stat.m_count);
+  for(int idx = 0; idx < perf_t::nbr_buckets; idx++)
+  {
+    nbr += stat.m_bucket[idx];
+    if(nbr > target)
+    {
+      return std::min((double)(1LL << (idx + 1)), (double)stat.m_max);
+    }
+  }
+  return (double)stat.m_max;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock::refresh
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PerfDock::refresh()
+{
+  if(!isVisible())
+  {
+    return;
+  }
+  std::vector<perf_t::stat_t> stats = perf_t::instance().stats();
+  for(int idx = 0; idx < perf_t::NbrStages; idx++)
+  {
+    const perf_t::stat_t &stat = stats[idx];
+    QStringList row;
+    row << QString::number(stat.m_count);
+    row << QString::number(stat.m_total / 1000.0, 'f', 1);
+    row << QString::number(stat.m_count ? stat.m_total / 1000.0 / stat.m_count : 0, 'f', 3);
+    row << QString::number(percentile_bucket(stat, 0.50) / 1000.0, 'f', 3);
+    row << QString::number(percentile_bucket(stat, 0.95) / 1000.0, 'f', 3);
+    row << QString::number(stat.m_max / 1000.0, 'f', 3);
+    row << QString::number(stat.m_last / 1000.0, 'f', 3);
+
+    //histogram as a sparkline over the range of non empty buckets
+    int first = perf_t::nbr_buckets;
+    int last = -1;
+    unsigned long long peak = 0;
+    for(int idx_bkt = 0; idx_bkt < perf_t::nbr_buckets; idx_bkt++)
+    {
+      if(stat.m_bucket[idx_bkt])
+      {
+        first = std::min(first, idx_bkt);
+        last = idx_bkt;
+        peak = std::max(peak, stat.m_bucket[idx_bkt]);
+      }
+    }
+    QString spark;
+    for(int idx_bkt = first; idx_bkt <= last; idx_bkt++)
+    {
+      int level = (int)((stat.m_bucket[idx_bkt] * 8 + peak - 1) / peak);
+      spark.append(level ? QChar(0x2580 + level) : QChar(' '));
+    }
+    if(last >= 0)
+    {
+      spark = QString("2^%1 %2 2^%3").arg(first).arg(spark).arg(last + 1);
+    }
+    row << spark;
+
+    for(int idx_col = 0; idx_col < row.size(); idx_col++)
+    {
+      QTableWidgetItem *item = m_table->item(idx, idx_col);
+      if(item == NULL)
+      {
+        item = new QTableWidgetItem;
+        m_table->setItem(idx, idx_col, item);
+      }
+      item->setText(row[idx_col]);
+    }
+  }
+
+  size_t inflated = chunk_cache_t::nbr_inflated();
+  size_t avoided = chunk_cache_t::nbr_avoided();
+  m_label_cache->setText(tr("Chunk cache: %1 chunks inflated, %2 inflations avoided (%3%)").arg(inflated).arg(avoided)
+    .arg(100.0 * avoided / std::max(inflated + avoided, (size_t)1), 0, 'f', 1));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock::reset
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PerfDock::reset()
+{
+  perf_t::instance().reset();
+  chunk_cache_t::reset_counts();
+  refresh();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock::set_recording
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PerfDock::set_recording(bool recording)
+{
+  perf_t::instance().set_recording(recording);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock::export_trace
+//write the recorded events in Chrome trace event format (complete events, "ph":"X")
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PerfDock::export_trace()
+{
+  QString file_name = QFileDialog::getSaveFileName(this,
+    tr("Export Trace"), "trace.json",
+    tr("Chrome trace (*.json);;All files (*.*)"));
+
+  if(file_name.isEmpty())
+    return;
+
+  QFile file(file_name);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    QMessageBox::warning(this, tr("Export Trace"), tr("Cannot write %1").arg(file_name));
+    return;
+  }
+
+  std::vector<perf_t::event_t> events = perf_t::instance().events();
+  QTextStream out(&file);
+  out << "{\"traceEvents\":[\n";
+  for(size_t idx = 0; idx < events.size(); idx++)
+  {
+    const perf_t::event_t &eve = events[idx];
+    QString name = QString::fromStdString(eve.m_name);
+    name.replace('\\', "\\\\");
+    name.replace('"', "\\\"");
+    out << "{\"name\":\"" << perf_t::stage_name(eve.m_stage);
+    if(!name.isEmpty())
+    {
+      out << " " << name;
+    }
+    out << "\",\"cat\":\"" << perf_t::stage_name(eve.m_stage)
+      << "\",\"ph\":\"X\",\"ts\":" << eve.m_ts
+      << ",\"dur\":" << eve.m_dur
+      << ",\"pid\":1,\"tid\":" << eve.m_tid << "}";
+    out << (idx + 1 < events.size() ? ",\n" : "\n");
+  }
+  out << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find predicates
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum FindOp
+{
+  FindGreater,
+  FindGreaterEqual,
+  FindLess,
+  FindLessEqual,
+  FindEqual,
+  FindBetween,
+  FindNaN,
+  FindFill
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_pred_t
+//predicate on one element; OP is a template parameter so that the switch is resolved at compile time
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, int OP>
+class find_pred_t
+{
+public:
+  find_pred_t(double val1, double val2) :
+    m_val1(val1),
+    m_val2(val2)
+  {
+  }
+  unsigned char operator()(T x) const
+  {
+    double val = (double)x;
+    switch(OP)
+    {
+    case FindGreater:
+      return val > m_val1;
+    case FindGreaterEqual:
+      return val >= m_val1;
+    case FindLess:
+      return val < m_val1;
+    case FindLessEqual:
+      return val <= m_val1;
+    case FindEqual:
+    case FindFill:
+      return val == m_val1;
+    case FindBetween:
+      return (val >= m_val1) & (val <= m_val2);
+    case FindNaN:
+      return val != val;
+    }
+    return 0;
+  }
+private:
+  double m_val1;
+  double m_val2;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_range
+//scan [begin, end) of a buffer in blocks: the predicate is first evaluated branch free into a mask
+//for the whole block (vectorized by the compiler), and only blocks with matches are compacted
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename P>
+void find_range(const T *buf, size_t begin, size_t end, P pred, size_t max_hits, std::vector<size_t> &hits, size_t &nbr_hits)
+{
+  const size_t blk_sz = 256;
+  unsigned char mask[blk_sz];
+  for(size_t idx_blk = begin; idx_blk < end; idx_blk += blk_sz)
+  {
+    size_t nbr = std::min(blk_sz, end - idx_blk);
+    const T *ptr = buf + idx_blk;
+    unsigned int nbr_set = 0;
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      mask[idx] = pred(ptr[idx]);
+    }
+    for(size_t idx = 0; idx < nbr; idx++)
+    {
+      nbr_set += mask[idx];
+    }
+    if(nbr_set == 0)
+    {
+      continue;
+    }
+    nbr_hits += nbr_set;
+    for(size_t idx = 0; idx < nbr && hits.size() < max_hits; idx++)
+    {
+      if(mask[idx])
+      {
+        hits.push_back(idx_blk + idx);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_typed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+void find_typed(const T *buf, size_t begin, size_t end, int op, double val1, double val2,
+  size_t max_hits, std::vector<size_t> &hits, size_t &nbr_hits)
+{
+  if((op == FindEqual || op == FindFill) && !in_range<T>(val1))
+  {
+    //value outside the range of the type, no element can be equal
+    return;
+  }
+  if(op == FindEqual && (double)(T)val1 != val1)
+  {
+    //value not representable in the type, no element can be equal
+    return;
+  }
+  if(op == FindEqual || op == FindFill)
+  {
+    val1 = (double)(T)val1;
+  }
+  switch(op)
+  {
+  case FindGreater:
+    find_range(buf, begin, end, find_pred_t<T, FindGreater>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindGreaterEqual:
+    find_range(buf, begin, end, find_pred_t<T, FindGreaterEqual>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindLess:
+    find_range(buf, begin, end, find_pred_t<T, FindLess>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindLessEqual:
+    find_range(buf, begin, end, find_pred_t<T, FindLessEqual>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindEqual:
+    find_range(buf, begin, end, find_pred_t<T, FindEqual>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindBetween:
+    find_range(buf, begin, end, find_pred_t<T, FindBetween>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindNaN:
+    find_range(buf, begin, end, find_pred_t<T, FindNaN>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  case FindFill:
+    find_range(buf, begin, end, find_pred_t<T, FindFill>(val1, val2), max_hits, hits, nbr_hits);
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_values
+//type dispatch of find_typed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void find_values(const void *buf, const nc_type typ, size_t begin, size_t end, int op, double val1, double val2,
+  size_t max_hits, std::vector<size_t> &hits, size_t &nbr_hits)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    find_typed(static_cast<const float*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_DOUBLE:
+    find_typed(static_cast<const double*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_INT:
+    find_typed(static_cast<const int*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_SHORT:
+    find_typed(static_cast<const short*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_BYTE:
+    find_typed(static_cast<const signed char*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_UBYTE:
+    find_typed(static_cast<const unsigned char*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_USHORT:
+    find_typed(static_cast<const unsigned short*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_UINT:
+    find_typed(static_cast<const unsigned int*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_INT64:
+    find_typed(static_cast<const long long*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  case NC_UINT64:
+    find_typed(static_cast<const unsigned long long*>(buf), begin, end, op, val1, val2, max_hits, hits, nbr_hits);
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//find_parallel
+//scan a buffer of 'nbr' elements on all cores; hits are appended in index order (shifted by 'offset')
+//together with their values, up to 'max_hits'; 'nbr_hits' counts all matches
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void find_parallel(const void *buf, const nc_type typ, size_t nbr, size_t offset, int op, double val1, double val2,
+  size_t max_hits, std::vector<size_t> &hits, std::vector<double> &values, size_t &nbr_hits)
+{
+  int nbr_thr = nbr_threads();
+  std::vector<std::vector<size_t> > thr_hits(nbr_thr);
+  std::vector<size_t> thr_nbr_hits(nbr_thr, 0);
+  size_t max_thr_hits = max_hits - std::min(max_hits, hits.size());
+  parallel_for(nbr, 1 << 16, [&](size_t begin, size_t end, int idx_thr)
+  {
+    find_values(buf, typ, begin, end, op, val1, val2, max_thr_hits, thr_hits[idx_thr], thr_nbr_hits[idx_thr]);
+  });
+
+  for(int idx_thr = 0; idx_thr < nbr_thr; idx_thr++)
+  {
+    for(size_t idx = 0; idx < thr_hits[idx_thr].size() && hits.size() < max_hits; idx++)
+    {
+      hits.push_back(offset + thr_hits[idx_thr][idx]);
+      values.push_back(value_at(buf, typ, thr_hits[idx_thr][idx]));
+    }
+    nbr_hits += thr_nbr_hits[idx_thr];
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FindPanel::FindPanel
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FindPanel::FindPanel(ChildWindow *window, ItemData *item_data) :
+QDockWidget(tr("Find"), window),
+m_window(window),
+m_item_data(item_data)
+{
+  QWidget *widget = new QWidget(this);
+  QVBoxLayout *layout = new QVBoxLayout(widget);
+  QHBoxLayout *layout_find = new QHBoxLayout;
+
+  m_combo_op = new QComboBox(widget);
+  m_combo_op->addItem(tr("> value"), FindGreater);
+  m_combo_op->addItem(tr(">= value"), FindGreaterEqual);
+  m_combo_op->addItem(tr("< value"), FindLess);
+  m_combo_op->addItem(tr("<= value"), FindLessEqual);
+  m_combo_op->addItem(tr("== value"), FindEqual);
+  m_combo_op->addItem(tr("in range"), FindBetween);
+  m_combo_op->addItem(tr("is NaN"), FindNaN);
+  m_combo_op->addItem(tr("is fill value"), FindFill);
+  connect(m_combo_op, SIGNAL(currentIndexChanged(int)), this, SLOT(op_changed(int)));
+
+  m_edit_value = new QLineEdit(widget);
+  m_edit_value->setPlaceholderText(tr("value"));
+  connect(m_edit_value, SIGNAL(returnPressed()), this, SLOT(find()));
+  m_edit_value2 = new QLineEdit(widget);
+  m_edit_value2->setPlaceholderText(tr("to"));
+  m_edit_value2->setVisible(false);
+  connect(m_edit_value2, SIGNAL(returnPressed()), this, SLOT(find()));
+
+  QPushButton *button_find = new QPushButton(tr("Find"), widget);
+  connect(button_find, SIGNAL(clicked()), this, SLOT(find()));
+
+  m_label = new QLabel(widget);
+
+  layout_find->addWidget(m_combo_op);
+  layout_find->addWidget(m_edit_value);
+  layout_find->addWidget(m_edit_value2);
+  layout_find->addWidget(button_find);
+  layout_find->addWidget(m_label, 1);
+  layout->addLayout(layout_find);
+
+  m_list = new QListWidget(widget);
+  m_list->setUniformItemSizes(true);
+  connect(m_list, SIGNAL(currentRowChanged(int)), this, SLOT(go_to_hit(int)));
+  layout->addWidget(m_list);
+  setWidget(widget);
+
+  if(!is_numeric(item_data->m_ncvar->m_nc_type))
+  {
+    button_find->setEnabled(false);
+    m_label->setText(tr("Search is not available for this type"));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FindPanel::op_changed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FindPanel::op_changed(int)
+{
+  int op = m_combo_op->currentData().toInt();
+  m_edit_value->setVisible(op != FindNaN && op != FindFill);
+  m_edit_value2->setVisible(op == FindBetween);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FindPanel::find
+//scan the loaded buffer, or stream the variable in hyperslabs if it is not loaded
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FindPanel::find()
+{
+  const size_t max_hits = 10000;
+  const size_t max_elem = 1 << 22;
+  ncvar_t *ncvar = m_item_data->m_ncvar;
+  nc_type typ = ncvar->m_nc_type;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  int op = m_combo_op->currentData().toInt();
+  double val1 = 0;
+  double val2 = 0;
+  bool ok1 = true;
+  bool ok2 = true;
+  size_t nbr_hits = 0;
+  size_t nbr_scanned = 0;
+  bool read_failed = false;
+  std::vector<double> values;
+  QString str;
+
+  if(!is_numeric(typ))
+    return;
+
+  if(op == FindFill)
+  {
+    get_fill_value(m_item_data, &val1);
+  }
+  else if(op != FindNaN)
+  {
+    val1 = m_edit_value->text().toDouble(&ok1);
+    if(op == FindBetween)
+    {
+      val2 = m_edit_value2->text().toDouble(&ok2);
+    }
+  }
+  if(!ok1 || !ok2)
+  {
+    m_label->setText(tr("Invalid value"));
+    return;
+  }
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  QElapsedTimer timer;
+  timer.start();
+  m_hits.clear();
+
+  std::vector<size_t> start(nbr_dmn, 0);
+  std::vector<size_t> count(nbr_dmn);
+  size_t nbr_total = 1;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    count[idx_dmn] = ncvar->m_ncdim[idx_dmn].m_size;
+    nbr_total *= count[idx_dmn];
+  }
+
+  if(ncvar->m_buf != NULL)
+  {
+    find_parallel(ncvar->m_buf, typ, nbr_total, 0, op, val1, val2, max_hits, m_hits, values, nbr_hits);
+  }
+  else
+  {
+    //blocks of the whole variable are consecutive in index order
+    std::vector<size_t> blk_start;
+    std::vector<size_t> blk_count;
+    std::vector<char> buf(std::min(max_elem, nbr_total) * nc_type_size(typ));
+    slab_iterator_t iter(start, count, max_elem);
+    ncfile_t file;
+    size_t offset = 0;
+    while(iter.next(blk_start, blk_count))
+    {
+      size_t nbr = 1;
+      for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+      {
+        nbr *= blk_count[idx_dmn];
+      }
+      if(read_hyperslab(m_item_data, file, blk_start, blk_count, &buf[0]) != NC_NOERR)
+      {
+        read_failed = true;
+        break;
+      }
+      find_parallel(&buf[0], typ, nbr, offset, op, val1, val2, max_hits, m_hits, values, nbr_hits);
+      offset += nbr;
+    }
+    nbr_scanned = offset;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //list hits with their index in all dimensions
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  m_list->blockSignals(true);
+  m_list->clear();
+  QStringList list;
+  std::vector<size_t> index(nbr_dmn);
+  for(size_t idx_hit = 0; idx_hit < m_hits.size(); idx_hit++)
+  {
+    size_t idx_flat = m_hits[idx_hit];
+    for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+    {
+      index[idx_dmn - 1] = idx_flat % count[idx_dmn - 1];
+      idx_flat /= count[idx_dmn - 1];
+    }
+    QString text;
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      text += QString("%1%2=%3").arg(idx_dmn ? ", " : "").arg(ncvar->m_ncdim[idx_dmn].m_name.c_str()).arg(index[idx_dmn]);
+    }
+    str.sprintf(get_format(NC_DOUBLE), values[idx_hit]);
+    list.append(text + " : " + str);
+  }
+  m_list->addItems(list);
+  m_list->blockSignals(false);
+
+  if(read_failed)
+  {
+    m_label->setText(tr("Read failed: %1 matches in the first %2 of %3 elements").arg(nbr_hits).arg(nbr_scanned).arg(nbr_total));
+  }
+  else if(nbr_hits > m_hits.size())
+  {
+    m_label->setText(tr("%1 matches (first %2 listed), %3 ms").arg(nbr_hits).arg(m_hits.size()).arg(timer.elapsed()));
+  }
+  else
+  {
+    m_label->setText(tr("%1 matches, %2 ms").arg(nbr_hits).arg(timer.elapsed()));
+  }
+  QApplication::restoreOverrideCursor();
+  if(read_failed)
+  {
+    QMessageBox::warning(this, tr("Find"), tr("Cannot read %1: the search stopped at element %2 of %3.")
+      .arg(QString::fromStdString(ncvar->m_name)).arg(nbr_scanned).arg(nbr_total));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FindPanel::go_to_hit
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FindPanel::go_to_hit(int idx_hit)
+{
+  ncvar_t *ncvar = m_item_data->m_ncvar;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  if(idx_hit < 0 || (size_t)idx_hit >= m_hits.size())
+    return;
+
+  std::vector<size_t> index(nbr_dmn);
+  size_t idx_flat = m_hits[idx_hit];
+  for(size_t idx_dmn = nbr_dmn; idx_dmn > 0; idx_dmn--)
+  {
+    index[idx_dmn - 1] = idx_flat % ncvar->m_ncdim[idx_dmn - 1].m_size;
+    idx_flat /= ncvar->m_ncdim[idx_dmn - 1].m_size;
+  }
+  m_window->go_to(index);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//minmax_typed
+//minimum and maximum of [begin, end) of a buffer, skipping the fill value and NaN
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+void minmax_typed(const T *buf, size_t begin, size_t end, double fill, double &lo, double &hi)
+{
+  for(size_t idx = begin; idx < end; idx++)
+  {
+    double val = (double)buf[idx];
+    if(val != val || val == fill)
+    {
+      continue;
+    }
+    lo = std::min(lo, val);
+    hi = std::max(hi, val);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//minmax_values
+//type dispatch of minmax_typed; 'lo' and 'hi' are updated, so start with +inf and -inf
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void minmax_values(const void *buf, const nc_type typ, size_t begin, size_t end, double fill, double &lo, double &hi)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    minmax_typed(static_cast<const float*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_DOUBLE:
+    minmax_typed(static_cast<const double*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_INT:
+    minmax_typed(static_cast<const int*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_SHORT:
+    minmax_typed(static_cast<const short*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_BYTE:
+    minmax_typed(static_cast<const signed char*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_UBYTE:
+    minmax_typed(static_cast<const unsigned char*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_USHORT:
+    minmax_typed(static_cast<const unsigned short*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_UINT:
+    minmax_typed(static_cast<const unsigned int*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_INT64:
+    minmax_typed(static_cast<const long long*>(buf), begin, end, fill, lo, hi);
+    break;
+  case NC_UINT64:
+    minmax_typed(static_cast<const unsigned long long*>(buf), begin, end, fill, lo, hi);
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//bin_typed
+//add the values of [begin, end) of a buffer to 'nbr_bins' bins of width 1/scale starting at 'lo'
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+void bin_typed(const T *buf, size_t begin, size_t end, double fill, double lo, double scale,
+  size_t nbr_bins, size_t *bins)
+{
+  for(size_t idx = begin; idx < end; idx++)
+  {
+    double val = (double)buf[idx];
+    if(val != val || val == fill)
+    {
+      continue;
+    }
+    size_t idx_bin = (size_t)((val - lo) * scale);
+    bins[idx_bin < nbr_bins ? idx_bin : nbr_bins - 1]++;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//bin_values
+//type dispatch of bin_typed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void bin_values(const void *buf, const nc_type typ, size_t begin, size_t end, double fill, double lo, double scale,
+  size_t nbr_bins, size_t *bins)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    bin_typed(static_cast<const float*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_DOUBLE:
+    bin_typed(static_cast<const double*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_INT:
+    bin_typed(static_cast<const int*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_SHORT:
+    bin_typed(static_cast<const short*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_BYTE:
+    bin_typed(static_cast<const signed char*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_UBYTE:
+    bin_typed(static_cast<const unsigned char*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_USHORT:
+    bin_typed(static_cast<const unsigned short*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_UINT:
+    bin_typed(static_cast<const unsigned int*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_INT64:
+    bin_typed(static_cast<const long long*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  case NC_UINT64:
+    bin_typed(static_cast<const unsigned long long*>(buf), begin, end, fill, lo, scale, nbr_bins, bins);
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//range_parallel
+//minimum and maximum of a buffer of 'nbr' elements on all cores (lo > hi if there are no valid values)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void range_parallel(const void *buf, const nc_type typ, size_t nbr, double fill, double &lo, double &hi)
+{
+  int nbr_thr = nbr_threads();
+  std::vector<double> thr_lo(nbr_thr, HUGE_VAL);
+  std::vector<double> thr_hi(nbr_thr, -HUGE_VAL);
+  parallel_for(nbr, 1 << 16, [&](size_t begin, size_t end, int idx_thr)
+  {
+    minmax_values(buf, typ, begin, end, fill, thr_lo[idx_thr], thr_hi[idx_thr]);
+  });
+  lo = *std::min_element(thr_lo.begin(), thr_lo.end());
+  hi = *std::max_element(thr_hi.begin(), thr_hi.end());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//decimate_parallel
+//split a buffer of 'nbr' elements in 'nbr_col' consecutive columns and keep the minimum and maximum of
+//each (NaN for columns without valid values); min/max decimation keeps every peak of the series
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void decimate_parallel(const void *buf, const nc_type typ, size_t nbr, double fill, size_t nbr_col,
+  std::vector<float> &col_min, std::vector<float> &col_max)
+{
+  col_min.assign(nbr_col, NAN);
+  col_max.assign(nbr_col, NAN);
+  size_t grain = std::max((size_t)1, ((size_t)1 << 16) / (nbr / nbr_col + 1));
+  parallel_for(nbr_col, grain, [&](size_t begin, size_t end, int)
+  {
+    for(size_t idx_col = begin; idx_col < end; idx_col++)
+    {
+      double lo = HUGE_VAL;
+      double hi = -HUGE_VAL;
+      minmax_values(buf, typ, idx_col * nbr / nbr_col, (idx_col + 1) * nbr / nbr_col, fill, lo, hi);
+      if(lo <= hi)
+      {
+        col_min[idx_col] = (float)lo;
+        col_max[idx_col] = (float)hi;
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//histogram_parallel
+//bin a buffer of 'nbr' elements on all cores, each thread into its own bins, added at the end
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void histogram_parallel(const void *buf, const nc_type typ, size_t nbr, double fill, double lo, double hi,
+  std::vector<size_t> &bins)
+{
+  int nbr_thr = nbr_threads();
+  size_t nbr_bins = bins.size();
+  double scale = hi > lo ? nbr_bins / (hi - lo) : 0;
+  std::vector<std::vector<size_t> > thr_bins(nbr_thr, std::vector<size_t>(nbr_bins, 0));
+  parallel_for(nbr, 1 << 16, [&](size_t begin, size_t end, int idx_thr)
+  {
+    bin_values(buf, typ, begin, end, fill, lo, scale, nbr_bins, thr_bins[idx_thr].data());
+  });
+  std::fill(bins.begin(), bins.end(), 0);
+  for(int idx_thr = 0; idx_thr < nbr_thr; idx_thr++)
+  {
+    for(size_t idx_bin = 0; idx_bin < nbr_bins; idx_bin++)
+    {
+      bins[idx_bin] += thr_bins[idx_thr][idx_bin];
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PlotWidget::PlotWidget
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+PlotWidget::PlotWidget(QWidget *parent, ItemData *item_data) :
+QWidget(parent),
+m_item_data(item_data),
+m_ncvar(item_data->m_ncvar),
+m_width(0),
+m_nbr(0),
+m_lo(0),
+m_hi(0)
+{
+  get_fill_value(item_data, &m_fill);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PlotWidget::sizeHint
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+QSize PlotWidget::sizeHint() const
+{
+  return QSize(600, 300);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PlotWidget::decimate
+//reduce the displayed slice to at most one minimum and maximum per pixel column
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlotWidget::decimate(int width)
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  std::vector<char> buf;
+  m_layer = parent->m_layer;
+  m_width = width;
+  const void *data = parent->read_slice(buf, m_nbr);
+  perf_timer_t timer(perf_t::Decode, m_ncvar->m_name);
+  if(data == NULL || m_nbr == 0)
+  {
+    m_nbr = 0;
+    return;
+  }
+  decimate_parallel(data, m_ncvar->m_nc_type, m_nbr, m_fill, std::min(m_nbr, (size_t)width), m_min, m_max);
+  m_lo = HUGE_VAL;
+  m_hi = -HUGE_VAL;
+  for(size_t idx_col = 0; idx_col < m_min.size(); idx_col++)
+  {
+    if(m_min[idx_col] == m_min[idx_col])
+    {
+      m_lo = std::min(m_lo, (double)m_min[idx_col]);
+      m_hi = std::max(m_hi, (double)m_max[idx_col]);
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PlotWidget::paintEvent
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PlotWidget::paintEvent(QPaintEvent *)
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  QPainter painter(this);
+  QRect area = rect().adjusted(80, 10, -10, -24);
+  QString str;
+  char label[NC_MAX_NAME + 1];
+
+  painter.fillRect(rect(), Qt::white);
+  if(area.width() <= 0 || area.height() <= 0)
+    return;
+
+  if(parent->m_layer != m_layer || area.width() != m_width)
+  {
+    decimate(area.width());
+  }
+
+  perf_timer_t timer(perf_t::Paint, m_ncvar->m_name);
+  painter.setPen(Qt::gray);
+  painter.drawRect(area);
+  if(m_nbr == 0 || m_lo > m_hi)
+  {
+    painter.drawText(area, Qt::AlignCenter, tr("No data"));
+    return;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //y range and first and last x (coordinate values if there is a coordinate variable)
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  painter.setPen(Qt::black);
+  str.sprintf(get_format(NC_DOUBLE), m_hi);
+  painter.drawText(QRect(0, area.top(), area.left() - 4, 20), Qt::AlignRight | Qt::AlignTop, str);
+  str.sprintf(get_format(NC_DOUBLE), m_lo);
+  painter.drawText(QRect(0, area.bottom() - 20, area.left() - 4, 20), Qt::AlignRight | Qt::AlignBottom, str);
+  ncvar_t *ncvar_crd = m_item_data->m_ncvar_crd.empty() ? NULL : m_item_data->m_ncvar_crd.back();
+  for(int idx_end = 0; idx_end < 2; idx_end++)
+  {
+    size_t idx = idx_end ? m_nbr - 1 : 0;
+    if(ncvar_crd != NULL && ncvar_crd->m_buf != NULL)
+    {
+      format_value(label, sizeof(label), ncvar_crd->m_buf, ncvar_crd->m_nc_type, idx);
+    }
+    else
+    {
+      snprintf(label, sizeof(label), "%u", (unsigned)(idx + 1));
+    }
+    painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), 20),
+      (idx_end ? Qt::AlignRight : Qt::AlignLeft) | Qt::AlignTop, label);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //one vertical line per column from its minimum to its maximum, extended to the range of the
+  //previous column so that the line is connected; fewer elements than pixels are joined by lines
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  size_t nbr_col = m_min.size();
+  double span = m_hi > m_lo ? m_hi - m_lo : 1;
+  double scale = area.height() / span;
+  double step = nbr_col > 1 ? (double)(area.width() - 1) / (nbr_col - 1) : 0;
+  std::vector<QLineF> lines;
+  lines.reserve(nbr_col);
+  painter.setPen(Qt::blue);
+  painter.setClipRect(area);
+  for(size_t idx_col = 0; idx_col < nbr_col; idx_col++)
+  {
+    if(m_min[idx_col] != m_min[idx_col])
+    {
+      continue;
+    }
+    double x = area.left() + idx_col * step;
+    double lo = m_min[idx_col];
+    double hi = m_max[idx_col];
+    if(idx_col > 0 && m_min[idx_col - 1] == m_min[idx_col - 1])
+    {
+      if(nbr_col < (size_t)area.width())
+      {
+        lines.push_back(QLineF(x - step, area.bottom() - (m_min[idx_col - 1] - m_lo) * scale, x, area.bottom() - (lo - m_lo) * scale));
+        continue;
+      }
+      lo = std::min(lo, (double)m_max[idx_col - 1]);
+      hi = std::max(hi, (double)m_min[idx_col - 1]);
+    }
+    lines.push_back(QLineF(x, area.bottom() - (lo - m_lo) * scale, x, area.bottom() - (hi - m_lo) * scale));
+  }
+  painter.drawLines(lines.data(), (int)lines.size());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//HistogramWidget::HistogramWidget
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+HistogramWidget::HistogramWidget(QWidget *parent, ItemData *item_data) :
+QWidget(parent),
+m_item_data(item_data),
+m_ncvar(item_data->m_ncvar),
+m_binned(false),
+m_bins(100, 0),
+m_lo(0),
+m_hi(0)
+{
+  get_fill_value(item_data, &m_fill);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//HistogramWidget::sizeHint
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+QSize HistogramWidget::sizeHint() const
+{
+  return QSize(600, 300);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//HistogramWidget::bin
+//range and histogram of the displayed slice
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void HistogramWidget::bin()
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  std::vector<char> buf;
+  size_t nbr;
+  m_layer = parent->m_layer;
+  m_binned = true;
+  const void *data = parent->read_slice(buf, nbr);
+  perf_timer_t timer(perf_t::Decode, m_ncvar->m_name);
+  m_lo = HUGE_VAL;
+  m_hi = -HUGE_VAL;
+  std::fill(m_bins.begin(), m_bins.end(), 0);
+  if(data == NULL)
+    return;
+  range_parallel(data, m_ncvar->m_nc_type, nbr, m_fill, m_lo, m_hi);
+  if(m_lo <= m_hi)
+  {
+    histogram_parallel(data, m_ncvar->m_nc_type, nbr, m_fill, m_lo, m_hi, m_bins);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//HistogramWidget::paintEvent
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void HistogramWidget::paintEvent(QPaintEvent *)
+{
+  ChildWindow* parent = qobject_cast<ChildWindow*>(this->parentWidget());
+  QPainter painter(this);
+  QRect area = rect().adjusted(80, 10, -10, -24);
+  QString str;
+
+  painter.fillRect(rect(), Qt::white);
+  if(area.width() <= 0 || area.height() <= 0)
+    return;
+
+  if(!m_binned || parent->m_layer != m_layer)
+  {
+    bin();
+  }
+
+  perf_timer_t timer(perf_t::Paint, m_ncvar->m_name);
+  painter.setPen(Qt::gray);
+  painter.drawRect(area);
+  if(m_lo > m_hi)
+  {
+    painter.drawText(area, Qt::AlignCenter, tr("No data"));
+    return;
+  }
+
+  size_t max_count = *std::max_element(m_bins.begin(), m_bins.end());
+  painter.setPen(Qt::black);
+  painter.drawText(QRect(0, area.top(), area.left() - 4, 20), Qt::AlignRight | Qt::AlignTop, QString::number(max_count));
+  painter.drawText(QRect(0, area.bottom() - 20, area.left() - 4, 20), Qt::AlignRight | Qt::AlignBottom, "0");
+  str.sprintf(get_format(NC_DOUBLE), m_lo);
+  painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), 20), Qt::AlignLeft | Qt::AlignTop, str);
+  str.sprintf(get_format(NC_DOUBLE), m_hi);
+  painter.drawText(QRect(area.left(), area.bottom() + 2, area.width(), 20), Qt::AlignRight | Qt::AlignTop, str);
+
+  double width = (double)area.width() / m_bins.size();
+  for(size_t idx_bin = 0; idx_bin < m_bins.size(); idx_bin++)
+  {
+    double height = max_count ? (double)area.height() * m_bins[idx_bin] / max_count : 0;
+    painter.fillRect(QRectF(area.left() + idx_bin * width, area.bottom() - height, width, height), QColor(70, 110, 180));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//to_double_typed
+//convert 'nbr' elements to double; the fill value becomes NaN
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+void to_double_typed(const T *buf, size_t nbr, double fill, double *out)
+{
+  for(size_t idx = 0; idx < nbr; idx++)
+  {
+    double val = (double)buf[idx];
+    out[idx] = val == fill ? NAN : val;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//to_double
+//type dispatch of to_double_typed
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void to_double(const void *buf, const nc_type typ, size_t nbr, double fill, double *out)
+{
+  switch(typ)
+  {
+  case NC_FLOAT:
+    to_double_typed(static_cast<const float*>(buf), nbr, fill, out);
+    break;
+  case NC_DOUBLE:
+    to_double_typed(static_cast<const double*>(buf), nbr, fill, out);
+    break;
+  case NC_INT:
+    to_double_typed(static_cast<const int*>(buf), nbr, fill, out);
+    break;
+  case NC_SHORT:
+    to_double_typed(static_cast<const short*>(buf), nbr, fill, out);
+    break;
+  case NC_BYTE:
+    to_double_typed(static_cast<const signed char*>(buf), nbr, fill, out);
+    break;
+  case NC_UBYTE:
+    to_double_typed(static_cast<const unsigned char*>(buf), nbr, fill, out);
+    break;
+  case NC_USHORT:
+    to_double_typed(static_cast<const unsigned short*>(buf), nbr, fill, out);
+    break;
+  case NC_UINT:
+    to_double_typed(static_cast<const unsigned int*>(buf), nbr, fill, out);
+    break;
+  case NC_INT64:
+    to_double_typed(static_cast<const long long*>(buf), nbr, fill, out);
+    break;
+  case NC_UINT64:
+    to_double_typed(static_cast<const unsigned long long*>(buf), nbr, fill, out);
+    break;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::compile
+//parse an expression into code; variables are looked up from a group (and its parents) and must all
+//have the same dimensions; returns false with m_error set on errors
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::compile(const std::string &text, ItemData *item_data_grp)
+{
+  m_text = text;
+  m_item_data_grp = item_data_grp;
+  m_pos = 0;
+  m_sp = 0;
+  m_depth = 0;
+  m_code.clear();
+  m_vars.clear();
+  m_fill.clear();
+  m_const.clear();
+  m_ncdim.clear();
+
+  if(!parse_sum())
+  {
+    return false;
+  }
+  accept(' ');
+  if(m_pos < m_text.size())
+  {
+    return fail("unexpected character");
+  }
+  if(m_vars.empty())
+  {
+    return fail("the expression has no variables");
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::fail
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::fail(const char *msg)
+{
+  char str[NC_MAX_NAME + 1];
+  snprintf(str, sizeof(str), "%s at position %u", msg, (unsigned)(m_pos + 1));
+  m_error = str;
+  return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::accept
+//skip blanks, then consume the character 'c' if it is next (a blank only skips blanks)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::accept(char c)
+{
+  while(m_pos < m_text.size() && isspace((unsigned char)m_text[m_pos]))
+  {
+    m_pos++;
+  }
+  if(c != ' ' && m_pos < m_text.size() && m_text[m_pos] == c)
+  {
+    m_pos++;
+    return true;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::emit
+//append an instruction that changes the stack depth by 'push'
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void expr_t::emit(int op, size_t arg, int push)
+{
+  m_code.push_back(instr_t(op, arg));
+  m_sp += push;
+  m_depth = std::max(m_depth, m_sp);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::parse_sum
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::parse_sum()
+{
+  if(!parse_product())
+  {
+    return false;
+  }
+  for(;;)
+  {
+    int op;
+    if(accept('+'))
+    {
+      op = Add;
+    }
+    else if(accept('-'))
+    {
+      op = Sub;
+    }
+    else
+    {
+      return true;
+    }
+    if(!parse_product())
+    {
+      return false;
+    }
+    emit(op, 0, -1);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::parse_product
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::parse_product()
+{
+  if(!parse_unary())
+  {
+    return false;
+  }
+  for(;;)
+  {
+    int op;
+    if(accept('*'))
+    {
+      op = Mul;
+    }
+    else if(accept('/'))
+    {
+      op = Div;
     }
-    //coordinate variable does not exist
     else
     {
-      for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
-      {
-        str.sprintf("%d", idx_row + 1);
-        this->setVerticalHeaderItem(idx_row, new QTableWidgetItem(str));
-      }
+      return true;
+    }
+    if(!parse_unary())
+    {
+      return false;
     }
+    emit(op, 0, -1);
   }
+}
 
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
-  //grid
-  /////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::parse_unary
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  switch(m_ncvar->m_nc_type)
+bool expr_t::parse_unary()
+{
+  if(accept('-'))
   {
-  case NC_FLOAT:
-    buf_float = static_cast<float*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    if(!parse_unary())
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_FLOAT), buf_float[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      return false;
     }
-    break;
-  case NC_DOUBLE:
-    buf_double = static_cast<double*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    emit(Neg, 0, 0);
+    return true;
+  }
+  accept('+');
+  return parse_power();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::parse_power
+//right associative, binds tighter than unary minus on its left (-a^2 is -(a^2))
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::parse_power()
+{
+  if(!parse_primary())
+  {
+    return false;
+  }
+  if(accept('^'))
+  {
+    if(!parse_unary())
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_DOUBLE), buf_double[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      return false;
     }
-    break;
-  case NC_INT:
-    buf_int = static_cast<int*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    emit(Pow, 0, -1);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::parse_primary
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool expr_t::parse_primary()
+{
+  static const char *fnc_nm[] = {"sqrt", "abs", "exp", "log", "log10", "sin", "cos", "tan", "min", "max", "pow", "atan2"};
+  static const int fnc_op[] = {Sqrt, Abs, Exp, Log, Log10, Sin, Cos, Tan, Min, Max, Pow, Atan2};
+  static const int fnc_nbr_arg[] = {1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2};
+
+  if(accept('('))
+  {
+    if(!parse_sum())
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_INT), buf_int[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      return false;
     }
-    break;
-  case NC_SHORT:
-    buf_short = static_cast<short*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    if(!accept(')'))
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_SHORT), buf_short[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      return fail("expected )");
     }
-    break;
-  case NC_CHAR:
-    buf_char = static_cast<char*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    return true;
+  }
+
+  if(m_pos >= m_text.size())
+  {
+    return fail("unexpected end of expression");
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //number
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  const char *begin = m_text.c_str() + m_pos;
+  if(isdigit((unsigned char)*begin) || *begin == '.')
+  {
+    char *end;
+    double val = strtod(begin, &end);
+    if(end == begin)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_CHAR), buf_char[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      return fail("invalid number");
     }
-    break;
-  case NC_BYTE:
-    buf_byte = static_cast<signed char*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    m_pos += end - begin;
+    m_const.push_back(val);
+    emit(PushConst, m_const.size() - 1, 1);
+    return true;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //name of a function or a variable
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  if(!isalpha((unsigned char)*begin) && *begin != '_')
+  {
+    return fail("expected a number, a variable or a function");
+  }
+  size_t pos = m_pos;
+  while(m_pos < m_text.size() && (isalnum((unsigned char)m_text[m_pos]) || m_text[m_pos] == '_' || m_text[m_pos] == '.'))
+  {
+    m_pos++;
+  }
+  std::string name = m_text.substr(pos, m_pos - pos);
+
+  if(accept('('))
+  {
+    size_t idx_fnc = 0;
+    size_t nbr_fnc = sizeof(fnc_nm) / sizeof(fnc_nm[0]);
+    while(idx_fnc < nbr_fnc && name != fnc_nm[idx_fnc])
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_BYTE), buf_byte[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      idx_fnc++;
     }
-    break;
-  case NC_UBYTE:
-    buf_ubyte = static_cast<unsigned char*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    if(idx_fnc == nbr_fnc)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
-      {
-        str.sprintf(get_format(NC_UBYTE), buf_ubyte[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
-      }
+      m_pos = pos;
+      return fail("unknown function");
     }
-    break;
-  case NC_USHORT:
-    buf_ushort = static_cast<unsigned short*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    for(int idx_arg = 0; idx_arg < fnc_nbr_arg[idx_fnc]; idx_arg++)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      if(idx_arg > 0 && !accept(','))
       {
-        str.sprintf(get_format(NC_USHORT), buf_ushort[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
+        return fail("expected ,");
+      }
+      if(!parse_sum())
+      {
+        return false;
       }
     }
-    break;
-  case NC_UINT:
-    buf_uint = static_cast<unsigned int*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    if(!accept(')'))
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      return fail("expected )");
+    }
+    emit(fnc_op[idx_fnc], 0, 1 - fnc_nbr_arg[idx_fnc]);
+    return true;
+  }
+
+  ItemData *item_data = find_variable(m_item_data_grp, name);
+  if(item_data == NULL)
+  {
+    m_pos = pos;
+    return fail("unknown variable");
+  }
+  if(!is_numeric(item_data->m_ncvar->m_nc_type))
+  {
+    m_pos = pos;
+    return fail("variable is not numeric");
+  }
+
+  //same dimensions as the variables before
+  const std::vector<ncdim_t> &ncdim = item_data->m_ncvar->m_ncdim;
+  if(m_vars.empty())
+  {
+    m_ncdim = ncdim;
+  }
+  else
+  {
+    bool same = ncdim.size() == m_ncdim.size();
+    for(size_t idx_dmn = 0; same && idx_dmn < ncdim.size(); idx_dmn++)
+    {
+      same = ncdim[idx_dmn].m_size == m_ncdim[idx_dmn].m_size;
+    }
+    if(!same)
+    {
+      m_pos = pos;
+      return fail("variable dimensions differ");
+    }
+  }
+
+  size_t idx_var = std::find(m_vars.begin(), m_vars.end(), item_data) - m_vars.begin();
+  if(idx_var == m_vars.size())
+  {
+    double fill;
+    get_fill_value(item_data, &fill);
+    m_vars.push_back(item_data);
+    m_fill.push_back(fill);
+  }
+  emit(PushVar, idx_var, 1);
+  return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::evaluate
+//evaluate the expression for a hyperslab of its dimensions: the hyperslab of each variable is read and
+//converted to double, then the code runs on all cores over blocks of elements, each thread with its
+//own stack of blocks; missing values (fill values of the variables) are NaN and stay NaN
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int expr_t::evaluate(const std::vector<size_t> &start, const std::vector<size_t> &count, double *out) const
+{
+  const size_t blk_sz = 1024;
+  size_t nbr = 1;
+  for(size_t idx_dmn = 0; idx_dmn < count.size(); idx_dmn++)
+  {
+    nbr *= count[idx_dmn];
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //operands
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  std::vector<std::vector<double> > operand(m_vars.size());
+  std::vector<char> buf;
+  for(size_t idx_var = 0; idx_var < m_vars.size(); idx_var++)
+  {
+    ncfile_t file;
+    nc_type typ = m_vars[idx_var]->m_ncvar->m_nc_type;
+    operand[idx_var].resize(nbr);
+    if(typ == NC_DOUBLE)
+    {
+      if(read_hyperslab(m_vars[idx_var], file, start, count, operand[idx_var].data()) != NC_NOERR)
       {
-        str.sprintf(get_format(NC_UINT), buf_uint[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
+        return NC2_ERR;
       }
+      to_double(operand[idx_var].data(), typ, nbr, m_fill[idx_var], operand[idx_var].data());
     }
-    break;
-  case NC_INT64:
-    buf_int64 = static_cast<long long*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+    else
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      buf.resize(nbr * nc_type_size(typ));
+      if(read_hyperslab(m_vars[idx_var], file, start, count, buf.data()) != NC_NOERR)
       {
-        str.sprintf(get_format(NC_INT64), buf_int64[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
+        return NC2_ERR;
       }
+      to_double(buf.data(), typ, nbr, m_fill[idx_var], operand[idx_var].data());
     }
-    break;
-  case NC_UINT64:
-    buf_uint64 = static_cast<unsigned long long*> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //run the code over blocks
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  perf_timer_t timer(perf_t::Decode, m_text);
+  size_t nbr_blk = (nbr + blk_sz - 1) / blk_sz;
+  parallel_for(nbr_blk, 64, [&](size_t blk_begin, size_t blk_end, int)
+  {
+    std::vector<double> stack(m_depth * blk_sz);
+    for(size_t idx_blk = blk_begin; idx_blk < blk_end; idx_blk++)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      size_t begin = idx_blk * blk_sz;
+      size_t len = std::min(blk_sz, nbr - begin);
+      size_t sp = 0;
+      for(size_t idx_ins = 0; idx_ins < m_code.size(); idx_ins++)
       {
-        str.sprintf(get_format(NC_UINT64), buf_uint64[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
+        const instr_t &ins = m_code[idx_ins];
+        double *top = stack.data() + sp * blk_sz; // block pushed next
+        double *b = top - blk_sz; // operand of unary operations, second operand of binary operations
+        double *a = b - blk_sz; // first operand (and result) of binary operations
+        switch(ins.m_op)
+        {
+        case PushVar:
+          memcpy(top, &operand[ins.m_arg][begin], len * sizeof(double));
+          sp++;
+          break;
+        case PushConst:
+          std::fill(top, top + len, m_const[ins.m_arg]);
+          sp++;
+          break;
+        case Add:
+          for(size_t idx = 0; idx < len; idx++) a[idx] += b[idx];
+          sp--;
+          break;
+        case Sub:
+          for(size_t idx = 0; idx < len; idx++) a[idx] -= b[idx];
+          sp--;
+          break;
+        case Mul:
+          for(size_t idx = 0; idx < len; idx++) a[idx] *= b[idx];
+          sp--;
+          break;
+        case Div:
+          for(size_t idx = 0; idx < len; idx++) a[idx] /= b[idx];
+          sp--;
+          break;
+        case Pow:
+          for(size_t idx = 0; idx < len; idx++) a[idx] = pow(a[idx], b[idx]);
+          sp--;
+          break;
+        case Min:
+          for(size_t idx = 0; idx < len; idx++) a[idx] = b[idx] < a[idx] || b[idx] != b[idx] ? b[idx] : a[idx];
+          sp--;
+          break;
+        case Max:
+          for(size_t idx = 0; idx < len; idx++) a[idx] = b[idx] > a[idx] || b[idx] != b[idx] ? b[idx] : a[idx];
+          sp--;
+          break;
+        case Atan2:
+          for(size_t idx = 0; idx < len; idx++) a[idx] = atan2(a[idx], b[idx]);
+          sp--;
+          break;
+        case Neg:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = -b[idx];
+          break;
+        case Sqrt:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = sqrt(b[idx]);
+          break;
+        case Abs:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = fabs(b[idx]);
+          break;
+        case Exp:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = exp(b[idx]);
+          break;
+        case Log:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = log(b[idx]);
+          break;
+        case Log10:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = log10(b[idx]);
+          break;
+        case Sin:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = sin(b[idx]);
+          break;
+        case Cos:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = cos(b[idx]);
+          break;
+        case Tan:
+          for(size_t idx = 0; idx < len; idx++) b[idx] = tan(b[idx]);
+          break;
+        }
       }
+      memcpy(out + begin, &stack[0], len * sizeof(double));
     }
-    break;
-  case NC_STRING:
-    buf_string = static_cast<char**> (m_ncvar->m_buf);
-    for(int idx_row = 0; idx_row < m_nbr_rows; idx_row++)
+  });
+  return NC_NOERR;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reduce operations
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum ReduceOp
+{
+  ReduceMean,
+  ReduceMin,
+  ReduceMax,
+  ReduceSum
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reduce_block
+//accumulate a block of 'nbr_lyr' layers, laid out [outer][layer][inner], into the outputs
+//[begin, end) of an [outer][inner] accumulator; for each output run along 'inner' the layers are
+//added in order, so both the block and the accumulator are read sequentially; NaN is skipped
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void reduce_block(const double *buf, size_t nbr_lyr, size_t nbr_inner, int op, size_t begin, size_t end,
+  double *acc, size_t *cnt)
+{
+  size_t idx_out = begin;
+  while(idx_out < end)
+  {
+    size_t idx_outer = idx_out / nbr_inner;
+    size_t inner_begin = idx_out % nbr_inner;
+    size_t inner_end = std::min(nbr_inner, inner_begin + (end - idx_out));
+    double *acc_run = acc + idx_outer * nbr_inner;
+    size_t *cnt_run = cnt + idx_outer * nbr_inner;
+    for(size_t idx_lyr = 0; idx_lyr < nbr_lyr; idx_lyr++)
     {
-      for(int idx_col = 0; idx_col < m_nbr_cols; idx_col++)
+      const double *src = buf + (idx_outer * nbr_lyr + idx_lyr) * nbr_inner;
+      for(size_t idx = inner_begin; idx < inner_end; idx++)
       {
-        str.sprintf(get_format(NC_STRING), buf_string[idx_buf]);
-        this->setItem(idx_row, idx_col, new QTableWidgetItem(str));
-        idx_buf++;
+        double val = src[idx];
+        if(val != val)
+        {
+          continue;
+        }
+        switch(op)
+        {
+        case ReduceMin:
+          acc_run[idx] = std::min(acc_run[idx], val);
+          break;
+        case ReduceMax:
+          acc_run[idx] = std::max(acc_run[idx], val);
+          break;
+        default:
+          acc_run[idx] += val;
+        }
+        cnt_run[idx]++;
       }
     }
-    break;
-  }//switch
-
+    idx_out += inner_end - inner_begin;
+  }
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::FileTreeWidget 
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//reduce_variable
+//reduce a variable over one dimension into 'out' (all other dimensions, in order); the variable is
+//streamed in blocks of whole layers of the reduced dimension, converted to double (fill values are
+//skipped) and accumulated on all cores; outputs without valid values are NaN
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-FileTreeWidget::FileTreeWidget(QWidget *parent) : QTreeWidget(parent)
+bool reduce_variable(ItemData *item_data, size_t dim, int op, double *out, QWidget *parent)
 {
-  setContextMenuPolicy(Qt::CustomContextMenu);
+  const size_t max_elem = 1 << 22;
+  ncvar_t *ncvar = item_data->m_ncvar;
+  nc_type typ = ncvar->m_nc_type;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  size_t nbr_outer = 1;
+  size_t nbr_inner = 1;
+  size_t nbr_lyr = ncvar->m_ncdim[dim].m_size;
+  double fill;
+  ncfile_t file;
+
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    if(idx_dmn < dim)
+    {
+      nbr_outer *= ncvar->m_ncdim[idx_dmn].m_size;
+    }
+    else if(idx_dmn > dim)
+    {
+      nbr_inner *= ncvar->m_ncdim[idx_dmn].m_size;
+    }
+  }
+  size_t nbr_out = nbr_outer * nbr_inner;
+  get_fill_value(item_data, &fill);
+
+  double init = op == ReduceMin ? HUGE_VAL : (op == ReduceMax ? -HUGE_VAL : 0);
+  std::fill(out, out + nbr_out, init);
+  std::vector<size_t> cnt(nbr_out, 0);
+
+  //layers per block
+  size_t blk_lyr = std::max((size_t)1, std::min(nbr_lyr, max_elem / std::max(nbr_out, (size_t)1)));
+  std::vector<char> buf(nbr_out * blk_lyr * nc_type_size(typ));
+  std::vector<double> buf_dbl(typ == NC_DOUBLE ? 0 : nbr_out * blk_lyr);
+  std::vector<size_t> start(nbr_dmn, 0);
+  std::vector<size_t> count(nbr_dmn);
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  {
+    count[idx_dmn] = ncvar->m_ncdim[idx_dmn].m_size;
+  }
 
-  //right click menu
-  connect(this, SIGNAL(customContextMenuRequested(const QPoint &)), SLOT(show_context_menu(const QPoint &)));
+  QProgressDialog progress(QObject::tr("Reducing %1...").arg(QString::fromStdString(ncvar->m_name)),
+    QObject::tr("Cancel"), 0, (int)nbr_lyr, parent);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(500);
 
-  //double click
-  connect(this, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)), this, SLOT(add_grid()));
-}
+  for(size_t idx_lyr = 0; idx_lyr < nbr_lyr; idx_lyr += blk_lyr)
+  {
+    size_t nbr_blk = std::min(blk_lyr, nbr_lyr - idx_lyr);
+    start[dim] = idx_lyr;
+    count[dim] = nbr_blk;
+    if(read_hyperslab(item_data, file, start, count, buf.data()) != NC_NOERR)
+    {
+      QMessageBox::warning(parent, QObject::tr("Reduce"), QObject::tr("Cannot read %1").arg(QString::fromStdString(ncvar->m_name)));
+      return false;
+    }
+    double *data = reinterpret_cast<double*>(buf.data());
+    if(typ != NC_DOUBLE)
+    {
+      data = buf_dbl.data();
+    }
+    to_double(buf.data(), typ, nbr_out * nbr_blk, fill, data);
 
-///////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::~FileTreeWidget
-///////////////////////////////////////////////////////////////////////////////////////
+    perf_timer_t timer(perf_t::Decode, ncvar->m_name);
+    parallel_for(nbr_out, 1 << 12, [&](size_t begin, size_t end, int)
+    {
+      reduce_block(data, nbr_blk, nbr_inner, op, begin, end, out, cnt.data());
+    });
+    timer.stop();
+
+    progress.setValue((int)(idx_lyr + nbr_blk));
+    if(progress.wasCanceled())
+    {
+      return false;
+    }
+  }
 
-FileTreeWidget::~FileTreeWidget()
-{
-  QTreeWidgetItemIterator it(this);
-  while(*it)
+  for(size_t idx = 0; idx < nbr_out; idx++)
   {
-    ItemData *item_data = get_item_data(*it);
-    delete item_data;
-    ++it;
+    if(cnt[idx] == 0)
+    {
+      out[idx] = NAN;
+    }
+    else if(op == ReduceMean)
+    {
+      out[idx] /= cnt[idx];
+    }
   }
-
+  return true;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::show_context_menu
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//expr_t::difference
+//the expression a - b of two variables with the same dimensions, that may be in different files
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void FileTreeWidget::show_context_menu(const QPoint &p)
+void expr_t::difference(ItemData *item_data_a, ItemData *item_data_b)
 {
-  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (itemAt(p));
-  ItemData *item_data = get_item_data(item);
-  if(item_data->m_kind != ItemData::Variable)
-    return;
-  QMenu menu;
-  QAction *action_grid = new QAction("Grid...", this);;
-  connect(action_grid, SIGNAL(triggered()), this, SLOT(add_grid()));
-  menu.addAction(action_grid);
-  QAction *action_image = new QAction("Map...", this);;
-  connect(action_image, SIGNAL(triggered()), this, SLOT(add_image()));
-  action_image->setEnabled(false);
-  menu.addAction(action_image);
-  menu.addSeparator();
-  menu.exec(QCursor::pos());
+  double fill;
+  m_text = item_data_a->m_item_nm + " - " + item_data_b->m_item_nm;
+  m_ncdim = item_data_a->m_ncvar->m_ncdim;
+  m_vars.clear();
+  m_fill.clear();
+  m_const.clear();
+  m_code.clear();
+  m_vars.push_back(item_data_a);
+  m_vars.push_back(item_data_b);
+  get_fill_value(item_data_a, &fill);
+  m_fill.push_back(fill);
+  get_fill_value(item_data_b, &fill);
+  m_fill.push_back(fill);
+  m_code.push_back(instr_t(PushVar, 0));
+  m_code.push_back(instr_t(PushVar, 1));
+  m_code.push_back(instr_t(Sub, 0));
+  m_depth = 2;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::add_grid
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//diff_stats
+//maximum absolute value, sum of squares and number of the values of [begin, end) that are not NaN;
+//the loop has no branches, so that the compiler can vectorize it
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void FileTreeWidget::add_grid()
+void diff_stats(const double *buf, size_t begin, size_t end, double &max_abs, double &sum_sq, size_t &nbr)
 {
-  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
-  this->load_item(item);
-  ItemData *item_data = get_item_data(item);
-  assert(item_data->m_kind == ItemData::Variable);
-  m_main_window->add_table(item_data);
+  double max_loc = 0;
+  double sum_loc = 0;
+  size_t nbr_loc = 0;
+  for(size_t idx = begin; idx < end; idx++)
+  {
+    double val = buf[idx];
+    bool valid = val == val;
+    val = valid ? val : 0;
+    max_loc = std::max(max_loc, fabs(val));
+    sum_loc += val * val;
+    nbr_loc += valid;
+  }
+  max_abs = std::max(max_abs, max_loc);
+  sum_sq += sum_loc;
+  nbr += nbr_loc;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::add_image
-///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//DiffPanel::DiffPanel
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void FileTreeWidget::add_image()
+DiffPanel::DiffPanel(ChildWindow *window, TableWidget *table, ItemData *item_data) :
+QDockWidget(tr("Difference"), window),
+m_window(window),
+m_table(table),
+m_item_data(item_data)
 {
-  QTreeWidgetItem *item = static_cast <QTreeWidgetItem*> (currentItem());
-  this->load_item(item);
-  ItemData *item_data = get_item_data(item);
-  assert(item_data->m_kind == ItemData::Variable);
-  m_main_window->add_image(item_data);
+  QWidget *widget = new QWidget(this);
+  QVBoxLayout *layout = new QVBoxLayout(widget);
+  m_label = new QLabel(widget);
+  m_label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+  m_button_largest = new QPushButton(tr("Largest difference layer"), widget);
+  m_button_largest->setEnabled(item_data->m_ncvar->m_ncdim.size() > 2);
+  layout->addWidget(new QLabel(QString::fromStdString(item_data->m_expr->m_text), widget));
+  layout->addWidget(m_label);
+  layout->addWidget(m_button_largest);
+  layout->addStretch();
+  setWidget(widget);
+
+  connect(m_button_largest, SIGNAL(clicked()), this, SLOT(go_to_largest()));
+  connect(window, SIGNAL(layer_changed()), this, SLOT(refresh()));
+  refresh();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::load_item
+//DiffPanel::refresh
+//maximum absolute difference and RMSE of the displayed slice (the slice of the grid, read once)
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void FileTreeWidget::load_item(QTreeWidgetItem  *item)
+void DiffPanel::refresh()
 {
-  char var_nm[NC_MAX_NAME + 1]; // variable name 
-  char dmn_nm_var[NC_MAX_NAME + 1]; //dimension name
-  int nc_id;
-  int grp_id;
-  int var_id;
-  nc_type var_type;
-  int nbr_dmn;
-  int var_dimid[NC_MAX_VAR_DIMS];
-  size_t dmn_sz[NC_MAX_VAR_DIMS];
-  size_t buf_sz; // variable size
-  int fl_fmt;
-
-  ItemData *item_data = get_item_data(item);
-  assert(item_data->m_kind == ItemData::Variable);
-
-  //if not loaded, read buffer from file 
-  if(item_data->m_ncvar->m_buf != NULL)
+  size_t nbr;
+  const double *data = static_cast<const double*>(m_table->slice(nbr));
+  if(data == NULL)
   {
+    m_label->setText(tr("Cannot read the slice"));
     return;
   }
 
-  if(nc_open(item_data->m_file_name.c_str(), NC_NOWRITE, &nc_id) != NC_NOERR)
+  int nbr_thr = nbr_threads();
+  std::vector<double> thr_max(nbr_thr, 0);
+  std::vector<double> thr_sum(nbr_thr, 0);
+  std::vector<size_t> thr_nbr(nbr_thr, 0);
+  parallel_for(nbr, 1 << 16, [&](size_t begin, size_t end, int idx_thr)
   {
-
+    diff_stats(data, begin, end, thr_max[idx_thr], thr_sum[idx_thr], thr_nbr[idx_thr]);
+  });
+  double max_abs = 0;
+  double sum_sq = 0;
+  size_t nbr_valid = 0;
+  for(int idx_thr = 0; idx_thr < nbr_thr; idx_thr++)
+  {
+    max_abs = std::max(max_abs, thr_max[idx_thr]);
+    sum_sq += thr_sum[idx_thr];
+    nbr_valid += thr_nbr[idx_thr];
   }
 
-  //need a file format inquiry, since nc_inq_grp_full_ncid does not handle netCDF3 cases
-  if(nc_inq_format(nc_id, &fl_fmt) != NC_NOERR)
-  {
+  QString str_max;
+  QString str_rmse;
+  str_max.sprintf(get_format(NC_DOUBLE), max_abs);
+  str_rmse.sprintf(get_format(NC_DOUBLE), nbr_valid ? sqrt(sum_sq / nbr_valid) : 0.0);
+  m_label->setText(tr("Slice\nmax |diff| : %1\nRMSE : %2\nvalid : %3 of %4")
+    .arg(str_max).arg(str_rmse).arg(nbr_valid).arg(nbr));
+}
 
-  }
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//DiffPanel::go_to_largest
+//scan all layers for the largest absolute difference: the difference is evaluated in blocks of whole
+//layers, and the layers of a block are scanned in parallel, one layer per task
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  if(fl_fmt == NC_FORMAT_NETCDF4 || fl_fmt == NC_FORMAT_NETCDF4_CLASSIC)
+void DiffPanel::go_to_largest()
+{
+  ncvar_t *ncvar = m_item_data->m_ncvar;
+  size_t nbr_dmn = ncvar->m_ncdim.size();
+  size_t nbr_slice = ncvar->m_ncdim[nbr_dmn - 1].m_size * ncvar->m_ncdim[nbr_dmn - 2].m_size;
+  size_t nbr_lyr = 1;
+  std::vector<size_t> start(nbr_dmn, 0);
+  std::vector<size_t> count(nbr_dmn);
+  std::vector<size_t> blk_start;
+  std::vector<size_t> blk_count;
+  ncfile_t file;
+  for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
   {
-    // obtain group ID for netCDF4 files
-    if(nc_inq_grp_full_ncid(nc_id, item_data->m_grp_nm_fll.c_str(), &grp_id) != NC_NOERR)
+    count[idx_dmn] = ncvar->m_ncdim[idx_dmn].m_size;
+    if(idx_dmn < nbr_dmn - 2)
     {
+      nbr_lyr *= count[idx_dmn];
+    }
+  }
+  if(nbr_slice == 0 || nbr_lyr == 0)
+    return;
 
+  //blocks of whole layers, of about 4M elements
+  size_t blk_lyr = std::max((size_t)1, ((size_t)1 << 22) / nbr_slice);
+  slab_iterator_t iter(start, count, blk_lyr * nbr_slice);
+  std::vector<double> buf(std::min(blk_lyr, nbr_lyr) * nbr_slice);
+  std::vector<double> lyr_max(nbr_lyr, 0);
+  size_t idx_lyr = 0;
+
+  QProgressDialog progress(tr("Scanning layers..."), tr("Cancel"), 0, (int)nbr_lyr, this);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(500);
+  while(iter.next(blk_start, blk_count))
+  {
+    size_t nbr = 1;
+    for(size_t idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+    {
+      nbr *= blk_count[idx_dmn];
+    }
+    if(read_hyperslab(m_item_data, file, blk_start, blk_count, buf.data()) != NC_NOERR)
+    {
+      m_label->setText(tr("Cannot read %1").arg(QString::fromStdString(ncvar->m_name)));
+      return;
+    }
+    size_t nbr_blk_lyr = nbr / nbr_slice;
+    parallel_for(nbr_blk_lyr, 1, [&](size_t begin, size_t end, int)
+    {
+      for(size_t idx = begin; idx < end; idx++)
+      {
+        double sum_sq = 0;
+        size_t nbr_valid = 0;
+        diff_stats(buf.data(), idx * nbr_slice, (idx + 1) * nbr_slice, lyr_max[idx_lyr + idx], sum_sq, nbr_valid);
+      }
+    });
+    idx_lyr += nbr_blk_lyr;
+    progress.setValue((int)idx_lyr);
+    if(progress.wasCanceled())
+    {
+      return;
     }
   }
-  else
+
+  //layer indices of the largest
+  size_t idx_max = std::max_element(lyr_max.begin(), lyr_max.end()) - lyr_max.begin();
+  std::vector<size_t> index(nbr_dmn, 0);
+  for(size_t idx_dmn = nbr_dmn - 2; idx_dmn > 0; idx_dmn--)
   {
-    //make the group ID the file ID for netCDF3 cases
-    grp_id = nc_id;
+    index[idx_dmn - 1] = idx_max % count[idx_dmn - 1];
+    idx_max /= count[idx_dmn - 1];
   }
+  m_window->go_to(index);
+}
 
-  //all hunky dory from here 
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t::frame_pipeline_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  // get variable ID
-  if(nc_inq_varid(grp_id, item_data->m_item_nm.c_str(), &var_id) != NC_NOERR)
+frame_pipeline_t::frame_pipeline_t(ItemData *item_data, const std::vector<size_t> &start, const std::vector<size_t> &count,
+  size_t dim, size_t nbr_ahead, bool format) :
+  m_item_data(item_data),
+  m_start(start),
+  m_count(count),
+  m_dim(dim),
+  m_size(item_data->m_ncvar->m_ncdim[dim].m_size),
+  m_nbr_ahead(std::min(nbr_ahead, item_data->m_ncvar->m_ncdim[dim].m_size)),
+  m_format(format),
+  m_stop(false),
+  m_target(start[dim])
+{
+  int nbr_thr = std::max(1, std::min(nbr_threads() - 1, (int)m_nbr_ahead));
+  for(int idx_thr = 0; idx_thr < nbr_thr; idx_thr++)
   {
-
+    m_threads.push_back(std::thread(&frame_pipeline_t::run, this));
   }
+}
 
-  if(nc_inq_var(grp_id, var_id, var_nm, &var_type, &nbr_dmn, var_dimid, (int *)NULL) != NC_NOERR)
-  {
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t::~frame_pipeline_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
+frame_pipeline_t::~frame_pipeline_t()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
   }
-
-  //get dimensions 
-  for(int idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
+  m_cond.notify_all();
+  for(size_t idx_thr = 0; idx_thr < m_threads.size(); idx_thr++)
   {
-    int has_crd_var = 0;
-
-    //dimensions belong to groups
-    if(nc_inq_dim(grp_id, var_dimid[idx_dmn], dmn_nm_var, &dmn_sz[idx_dmn]) != NC_NOERR)
-    {
-
-    }
-
-    /////////////////////////////////////////////////////////////////////////////////////////////////////
-    //look up possible coordinate variables
-    //traverse all variables in group and match a variable name 
-    /////////////////////////////////////////////////////////////////////////////////////////////////////
+    m_threads[idx_thr].join();
+  }
+  for(std::map<size_t, frame_t*>::iterator it = m_frames.begin(); it != m_frames.end(); ++it)
+  {
+    delete it->second;
+  }
+}
 
-    for(size_t idx_var = 0; idx_var < item_data->m_item_data_prn->m_var_nms.size(); idx_var++)
-    {
-      std::string var_nm(item_data->m_item_data_prn->m_var_nms[idx_var]);
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t::ahead
+//index is one of the next m_nbr_ahead indices from the target (call with the lock held)
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-      if(var_nm == std::string(dmn_nm_var))
-      {
-        has_crd_var = 1;
-        break;
-      }
-    }
+bool frame_pipeline_t::ahead(size_t index) const
+{
+  return (index + m_size - m_target) % m_size < m_nbr_ahead;
+}
 
-    /////////////////////////////////////////////////////////////////////////////////////////////////////
-    //a coordinate variable was found
-    //since the lookup was only in the same group, get the variable information on this group 
-    /////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t::set_target
+//next index to be shown; ready frames that are not ahead of it are dropped
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    if(has_crd_var)
+void frame_pipeline_t::set_target(size_t index)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_target = index;
+    std::map<size_t, frame_t*>::iterator it = m_frames.begin();
+    while(it != m_frames.end())
     {
-      int crd_var_id;
-      char crd_var_nm[NC_MAX_NAME + 1];
-      int crd_nbr_dmn;
-      int crd_var_dimid[NC_MAX_VAR_DIMS];
-      size_t crd_dmn_sz[NC_MAX_VAR_DIMS];
-      nc_type crd_var_type = NC_NAT;
-
-      // get coordinate variable ID (using the dimension name, since there was a match to a variable)
-      if(nc_inq_varid(grp_id, dmn_nm_var, &crd_var_id) != NC_NOERR)
-      {
-
-      }
-
-      if(nc_inq_var(grp_id, crd_var_id, crd_var_nm, &crd_var_type, &crd_nbr_dmn, crd_var_dimid, (int *)NULL) != NC_NOERR)
+      if(ahead(it->first))
       {
-
+        ++it;
       }
-
-      assert(std::string(crd_var_nm) == std::string(dmn_nm_var));
-
-      if(crd_nbr_dmn == 1)
+      else
       {
-        //get size
-        if(nc_inq_dim(grp_id, crd_var_dimid[0], (char *)NULL, &crd_dmn_sz[0]) != NC_NOERR)
-        {
-
-        }
-
-        //store dimension 
-        std::vector<ncdim_t> ncdim; //dimensions for each variable 
-        ncdim_t dim(dmn_nm_var, crd_dmn_sz[0]);
-        ncdim.push_back(dim);
-
-        //store a ncvar_t
-        ncvar_t *ncvar = new ncvar_t(crd_var_nm, crd_var_type, ncdim);
-
-        //allocate, load 
-        ncvar->store(load_variable(grp_id, crd_var_id, crd_var_type, crd_dmn_sz[0]));
-
-        //and store in tree 
-        item_data->m_ncvar_crd.push_back(ncvar);
+        delete it->second;
+        m_frames.erase(it++);
       }
     }
-    else
-    {
-      item_data->m_ncvar_crd.push_back(NULL); //no coordinate variable for this dimension
-    }
-  }
-
-  //define buffer size
-  buf_sz = 1;
-  for(int idx_dmn = 0; idx_dmn < nbr_dmn; idx_dmn++)
-  {
-    buf_sz *= dmn_sz[idx_dmn];
   }
+  m_cond.notify_all();
+}
 
-  //allocate buffer and store in item data 
-  item_data->m_ncvar->store(load_variable(grp_id, var_id, var_type, buf_sz));
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//frame_pipeline_t::take
+//the frame of an index if it is ready (the caller deletes it), NULL otherwise
+/////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  if(nc_close(nc_id) != NC_NOERR)
+frame_t* frame_pipeline_t::take(size_t index)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::map<size_t, frame_t*>::iterator it = m_frames.find(index);
+  if(it == m_frames.end())
   {
-
+    return NULL;
   }
+  frame_t *frame = it->second;
+  m_frames.erase(it);
+  return frame;
 }
 
-
 /////////////////////////////////////////////////////////////////////////////////////////////////////
-//FileTreeWidget::load_variable
+//frame_pipeline_t::run
+//worker: prepare the first missing frame ahead of the target, in order; each worker keeps its own
+//open file, so consecutive frames of a variable that is not loaded are read without reopening it
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void* FileTreeWidget::load_variable(const int nc_id, const int var_id, const nc_type var_type, size_t buf_sz)
+void frame_pipeline_t::run()
 {
-  void *buf = NULL;
-  switch(var_type)
+  ncvar_t *ncvar = m_item_data->m_ncvar;
+  nc_type typ = ncvar->m_nc_type;
+  size_t elem_sz = nc_type_size(typ);
+  size_t nbr = 1;
+  std::vector<size_t> start(m_start);
+  char str[NC_MAX_NAME + 1];
+  ncfile_t file;
+
+  for(size_t idx_dmn = 0; idx_dmn < m_count.size(); idx_dmn++)
   {
-  case NC_FLOAT:
-    buf = malloc(buf_sz * sizeof(float));
-    if(nc_get_var_float(nc_id, var_id, static_cast<float *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_DOUBLE:
-    buf = malloc(buf_sz * sizeof(double));
-    if(nc_get_var_double(nc_id, var_id, static_cast<double *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_INT:
-    buf = malloc(buf_sz * sizeof(int));
-    if(nc_get_var_int(nc_id, var_id, static_cast<int *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_SHORT:
-    buf = malloc(buf_sz * sizeof(short));
-    if(nc_get_var_short(nc_id, var_id, static_cast<short *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_CHAR:
-    buf = malloc(buf_sz * sizeof(char));
-    if(nc_get_var_text(nc_id, var_id, static_cast<char *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_BYTE:
-    buf = malloc(buf_sz * sizeof(signed char));
-    if(nc_get_var_schar(nc_id, var_id, static_cast<signed char *>(buf)) != NC_NOERR)
-    {
-    }
-    break;
-  case NC_UBYTE:
-    buf = malloc(buf_sz * sizeof(unsigned char));
-    if(nc_get_var_uchar(nc_id, var_id, static_cast<unsigned char *>(buf)) != NC_NOERR)
+    nbr *= m_count[idx_dmn];
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for(;;)
+  {
+    //first index ahead of the target that is neither ready nor being prepared
+    size_t index = m_size;
+    while(!m_stop)
     {
+      for(size_t idx = 0; idx < m_nbr_ahead; idx++)
+      {
+        size_t idx_frm = (m_target + idx) % m_size;
+        if(m_frames.count(idx_frm) == 0 && m_busy.count(idx_frm) == 0)
+        {
+          index = idx_frm;
+          break;
+        }
+      }
+      if(index != m_size)
+      {
+        break;
+      }
+      m_cond.wait(lock);
     }
-    break;
-  case NC_USHORT:
-    buf = malloc(buf_sz * sizeof(unsigned short));
-    if(nc_get_var_ushort(nc_id, var_id, static_cast<unsigned short *>(buf)) != NC_NOERR)
+    if(m_stop)
     {
+      return;
     }
-    break;
-  case NC_UINT:
-    buf = malloc(buf_sz * sizeof(unsigned int));
-    if(nc_get_var_uint(nc_id, var_id, static_cast<unsigned int *>(buf)) != NC_NOERR)
+    m_busy.insert(index);
+    lock.unlock();
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    //read and format
+    ///////////////////////////////////////////////////////////////////////////////////////
+
+    frame_t *frame = new frame_t(index);
+    start[m_dim] = index;
+    frame->m_slice.resize(nbr * elem_sz);
+    frame->m_ok = read_hyperslab(m_item_data, file, start, m_count, frame->m_slice.data()) == NC_NOERR;
+    if(frame->m_ok && m_format)
     {
+      perf_timer_t timer(perf_t::Format, ncvar->m_name);
+      frame->m_text.resize(nbr);
+      for(size_t idx = 0; idx < nbr; idx++)
+      {
+        format_value(str, sizeof(str), frame->m_slice.data(), typ, idx);
+        frame->m_text[idx] = QString::fromUtf8(str);
+      }
     }
-    break;
-  case NC_INT64:
-    buf = malloc(buf_sz * sizeof(long long));
-    if(nc_get_var_longlong(nc_id, var_id, static_cast<long long *>(buf)) != NC_NOERR)
+    if(frame->m_ok && typ == NC_STRING)
     {
+      nc_free_string(nbr, reinterpret_cast<char**>(frame->m_slice.data()));
+      frame->m_slice.clear();
     }
-    break;
-  case NC_UINT64:
-    buf = malloc(buf_sz * sizeof(unsigned long long));
-    if(nc_get_var_ulonglong(nc_id, var_id, static_cast<unsigned long long *>(buf)) != NC_NOERR)
+
+    lock.lock();
+    m_busy.erase(index);
+    if(!m_stop && ahead(index))
     {
+      m_frames[index] = frame;
     }
-    break;
-  case NC_STRING:
-    buf = malloc(buf_sz * sizeof(char*));
-    if(nc_get_var_string(nc_id, var_id, static_cast<char* *>(buf)) != NC_NOERR)
+    else
     {
+      delete frame;
     }
-    break;
   }
-  return buf;
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//RenderWidget::sizeHint
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-
-QSize RenderWidget::sizeHint() const
-{
-  return QSize(400, 200);
-}
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-//RenderWidget::paintEvent
-/////////////////////////////////////////////////////////////////////////////////////////////////////
-
-void RenderWidget::paintEvent(QPaintEvent *)
-{
-  QPainter painter(this);
-
 }
@@ -8,12 +8,23 @@
 #include <QMdiArea>
 #include <string>
 #include <vector>
+#include <deque>
 #include "netcdf.h"
 
 class MainWindow;
 class ItemData;
 class TableWidget;
 class ncvar_t;
+class ncfile_t;
+class ChildWindow;
+class frame_t;
+class frame_pipeline_t;
+class PerfDock;
+class FindPanel;
+class name_index_t;
+class walk_t;
+class walk_node_t;
+class SqlTableModel;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 //FileTreeWidget
@@ -29,6 +40,11 @@ public:
   void show_context_menu(const QPoint &);
   void add_grid();
   void add_image();
+  void add_plot();
+  void add_histogram();
+  void add_derived();
+  void add_reduction();
+  void add_diff();
 
 public:
   void set_main_window(MainWindow *p)
@@ -38,7 +54,11 @@ public:
 
 private:
   MainWindow *m_main_window;
-  void load_item(QTreeWidgetItem *);
+  void load_item(QTreeWidgetItem *, bool data = true);
+  void load_data(ItemData *item_data, int grp_id = -1, int var_id = -1);
+  void load_coordinates(ItemData *item_data, int grp_id, int var_id);
+  void compress_data(QTreeWidgetItem *item, ItemData *item_data);
+  void add_virtual(QTreeWidgetItem *item_grp, ItemData *item_data, const std::string &tool_tip);
   void* load_variable(const int nc_id, const int var_id, const nc_type var_type, size_t buf_sz);
 };
 
@@ -51,15 +71,39 @@ class MainWindow : public QMainWindow
   Q_OBJECT
 public:
   MainWindow();
-  void add_table(ItemData *item_data);
+  ~MainWindow();
+  void add_table(ItemData *item_data, bool owned = false);
   void add_image(ItemData *item_data);
-  int read_file(QString file_name);
+  void add_plot(ItemData *item_data);
+  void add_histogram(ItemData *item_data);
+  void add_diff(ItemData *item_data);
+  int read_file(QString file_name, bool use_worker = false);
+  void read_files(const QStringList &file_names);
+  void start_benchmark(QElapsedTimer *clock);
+  bool compress_loaded() const
+  {
+    return m_action_compress->isChecked();
+  }
+  const QIcon &icon_dataset() const
+  {
+    return m_icon_dataset;
+  }
 
   private slots:
   void open_recent_file();
   void open_file();
   void open_dap();
   void about();
+  void search_names(const QString &);
+  void select_search_result(QListWidgetItem *);
+  void sync_layers();
+  void insert_walked();
+  void load_icons();
+  void set_readers(bool);
+  void start_readers();
+
+protected:
+  bool eventFilter(QObject *obj, QEvent *eve);
 
 private:
 
@@ -74,6 +118,10 @@ private:
   QMdiArea *m_mdi_area;
   FileTreeWidget *m_tree;
   QDockWidget *m_tree_dock;
+  PerfDock *m_perf_dock;
+  QLineEdit *m_edit_search;
+  QListWidget *m_list_search;
+  name_index_t *m_name_index;
 
   ///////////////////////////////////////////////////////////////////////////////////////
   //actions
@@ -85,6 +133,10 @@ private:
   QAction *m_action_about;
   QAction *m_action_tile;
   QAction *m_action_close_all;
+  QAction *m_action_link_layers;
+  QAction *m_action_compress;
+  QAction *m_action_readers;
+  bool m_syncing; // linked layers are being set
 
   ///////////////////////////////////////////////////////////////////////////////////////
   //icons
@@ -108,7 +160,48 @@ private:
   void closeEvent(QCloseEvent *eve);
 
 private:
-  int iterate(const std::string& file_name, const int grp_id, QTreeWidgetItem *tree_item);
+  void add_child(ChildWindow *window);
+  void insert_node(walk_t *walk, const walk_node_t &node);
+  void startup_report(int milestone);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //files being walked, startup benchmark
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  std::vector<walk_t*> m_walks;
+  QTimer *m_walk_timer;
+  enum
+  {
+    StartupWindow, // window constructed
+    StartupPaint, // first paint of the tree
+    StartupTree, // files of the command line in the tree
+    NbrStartup
+  };
+  QElapsedTimer *m_startup_clock; // process start (NULL if not benchmarking)
+  qint64 m_startup_ms[NbrStartup]; // milestone times (-1 if not reached)
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//PerfDock
+//debug dock that shows the per-stage timing histograms collected by perf_t
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class PerfDock : public QDockWidget
+{
+  Q_OBJECT
+public:
+  PerfDock(QWidget *parent);
+
+  private slots:
+  void refresh();
+  void reset();
+  void export_trace();
+  void set_recording(bool);
+
+private:
+  QTableWidget *m_table;
+  QLabel *m_label_cache; // decompressions done and avoided by the chunk caches
+  QTimer *m_timer;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -121,20 +214,159 @@ class ChildWindow : public QMainWindow
 {
   Q_OBJECT
 public:
-  ChildWindow(QWidget *parent, ItemData *item_data);
+  ChildWindow(QWidget *parent, ItemData *item_data, size_t nbr_dmn_view = 2);
+  ~ChildWindow();
   std::vector<int> m_layer;  // current selected layer of a dimension > 2 
+  bool m_item_data_owned; // item data is not in the tree (e.g. an extracted series) and is deleted with the window
+  enum ExportFormat
+  {
+    ExportCSV,
+    ExportBinary,
+    ExportNumpy
+  };
+
+  void slice_hyperslab(std::vector<size_t> &start, std::vector<size_t> &count) const;
+  const void* read_slice(std::vector<char> &buf, size_t &nbr) const;
+  void go_to(const std::vector<size_t> &index);
+  ItemData *item_data() const
+  {
+    return m_item_data;
+  }
+  bool linked_layer(const std::vector<std::string> &dims, const std::vector<int> &layers, std::vector<int> &layer) const;
+  void prefetch(const std::vector<int> &layer);
+  void set_layer(const std::vector<int> &layer);
+
+signals:
+  void layer_changed();
 
   private slots:
   void previous_layer(int);
   void next_layer(int);
   void combo_layer(int);
+  void go_to_value(int);
+  void export_data();
+  void save_subset();
+  void extract_series();
+  void play(bool);
+  void play_tick();
 
 private:
   QToolBar *m_tool_bar;
+  QToolBar *m_tool_bar_data;
   std::vector<QComboBox *> m_vec_combo;
+  std::vector<QLineEdit *> m_vec_edit;
+  FindPanel *m_find_panel;
+  std::vector<char> m_prefetch; // slice read ahead for a layer (variables that are not loaded)
+  std::vector<int> m_prefetch_layer; // layer of the prefetched slice
+  ncfile_t *m_file; // file of the slices read, kept open so that the library keeps its chunk cache across layers
+  bool choose_hyperslab(const QString &title, std::vector<size_t> &start, std::vector<size_t> &count);
+
+  ///////////////////////////////////////////////////////////////////////////////////////
+  //playback
+  ///////////////////////////////////////////////////////////////////////////////////////
+
+  QToolBar *m_tool_bar_play;
+  QAction *m_action_play;
+  QComboBox *m_combo_play;
+  QSpinBox *m_spin_fps;
+  QLabel *m_label_fps;
+  QTimer *m_play_timer;
+  QElapsedTimer m_play_clock; // time since playback started
+  frame_pipeline_t *m_pipeline; // frames prepared ahead (NULL if not playing)
+  size_t m_play_dim; // played dimension
+  size_t m_play_start; // layer where playback started
+  size_t m_play_shown; // layer shown
+  size_t m_play_frames; // frames shown
+  size_t m_play_dropped; // frames not shown in time
+  std::deque<qint64> m_play_times; // times frames were shown in the last second
 
 protected:
+  virtual bool selected_range(int &row, int &nbr_rows, int &col, int &nbr_cols) const;
+  virtual void show_cell(int row, int col);
+  virtual bool frame_text() const;
+  virtual void show_frame(frame_t *frame);
+  ItemData *m_item_data; // the tree item that generated this window
   ncvar_t *m_ncvar; // netCDF variable to display (convenience pointer to data in ItemData)
+  QAction *m_action_subset; // save a subset to a netCDF file
+  QAction *m_action_find; // show the find panel
+};
+
+#ifdef HAVE_SQLITE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//ChildWindowSql
+//rows of an SQLite table or view, paged as they are scrolled to
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ChildWindowSql : public ChildWindow
+{
+  Q_OBJECT
+public:
+  ChildWindowSql(QWidget *parent, ItemData *item_data);
+
+  private slots:
+  void statistics();
+
+protected:
+  bool selected_range(int &row, int &nbr_rows, int &col, int &nbr_cols) const;
+  void show_cell(int row, int col);
+
+private:
+  QTableView *m_view;
+  SqlTableModel *m_model;
+};
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//FindPanel
+//search a variable for values that match a predicate; selecting a hit moves the window to it
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class FindPanel : public QDockWidget
+{
+  Q_OBJECT
+public:
+  FindPanel(ChildWindow *window, ItemData *item_data);
+
+  private slots:
+  void find();
+  void go_to_hit(int);
+  void op_changed(int);
+
+private:
+  ChildWindow *m_window;
+  ItemData *m_item_data;
+  QComboBox *m_combo_op;
+  QLineEdit *m_edit_value;
+  QLineEdit *m_edit_value2;
+  QLabel *m_label;
+  QListWidget *m_list;
+  std::vector<size_t> m_hits; // flat index of hits in the variable
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//DiffPanel
+//summary of a difference variable: statistics of the displayed slice and the layer with the
+//largest difference
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class DiffPanel : public QDockWidget
+{
+  Q_OBJECT
+public:
+  DiffPanel(ChildWindow *window, TableWidget *table, ItemData *item_data);
+
+  private slots:
+  void refresh();
+  void go_to_largest();
+
+private:
+  ChildWindow *m_window;
+  TableWidget *m_table; // grid of the window, that holds the displayed slice
+  ItemData *m_item_data;
+  QLabel *m_label;
+  QPushButton *m_button_largest;
 };
 
 #endif